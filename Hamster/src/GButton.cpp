@@ -36,7 +36,7 @@ bool GButton::init(SDL_Renderer *aRenderer, const std::string &aPath, const UVec
     // Load the buttons texture from a file
     if (!mTexture.loadFromFile(aPath))
     {
-        // printf("Failed to load button texture!\n");
+        ULOG_ERROR(k_ELogRender, "Failed to load button texture!");
         success = false;
     }
     else
@@ -73,8 +73,9 @@ void GButton::handleEvent(SDL_Event &e)
     // If the user pressed the mouse
     if (e.type == SDL_MOUSEBUTTONDOWN)
     {
-        // Get mouse position
-        SDL_GetMouseState(&mosX, &mosY);
+        // Get the mouse position from the event, so injected clicks work without a real cursor
+        mosX = e.button.x;
+        mosY = e.button.y;
 
         // Check if mouse is in the button
         bool inside = true;
@@ -131,6 +131,9 @@ public:
     // Generate a new DustBall to the hamster
     void addDustBall();
 
+    // Number of live DustBalls
+    int dustBallCount() { return static_cast<int>(mDustBalls.size()); }
+
     // Free the resources
     void free();
 
@@ -6,51 +6,74 @@
 * File: Hamster Main.cpp
 */
 #include "ULib.h"
+#include "UAudio.h"
 #include "UWindow.h"
 #include "Windows.h"
 #include "UGame.h"
-#include "../../Steam/steam_api.h"
+#include "UBench.h"
+#include "UMicrobench.h"
+#include "STEAM_LocalBackend.h"
+#include "STEAM_Pump.h"
+#include "STEAM_Race.h"
 #define _CRT_SECURE_NO_WARNINGS
 
 // Our custom window and renderer
 UWindow gWindow;
 SDL_Renderer *gRenderer = nullptr;
 
-// initialize the SDL subsystems
+// Steam, or the local stand in, nullptr when running without Steam
+STEAM_Backend *gSteamBackend = nullptr;
+
+// initialize Steam and the SDL subsystems
 bool init() 
 {
     // Initialization flag
     bool success = true;
+    UStartupScope profileScope("init");
 
     // Checks if the game was launched through steam, and relaunches the game through steam
     // if it wasn't
-    if (SteamAPI_RestartAppIfNecessary(1583410))
+    UStartupProfiler::begin("SteamAPI_RestartAppIfNecessary");
+    if (gSteamBackend && gSteamBackend->RestartAppIfNecessary(1583410))
     {
-        // printf("(SteamAPI_RestartAppIfNecessary(1583410)) returned true.\n");
+        ULOG_INFO(k_ELogSteam, "(SteamAPI_RestartAppIfNecessary(1583410)) returned true.");
         success = false;
     }
+    UStartupProfiler::end();
 
-    // Initializes the Steam API, sets up the global state and populates the interface 
-    // pointers which are accessible via the global functions which match the name of the
-    // interface. Must return successfully to 
-    if (!SteamAPI_Init())
+    // Starts the Steam backend, for the Steam client this initializes the Steam API and sets
+    // up the global state. Must return successfully to play
+    UStartupProfiler::begin("STEAM_Backend::Init");
+    if (gSteamBackend && !gSteamBackend->Init())
     {
-        // printf("Fatal Error - Steam must be running to play this game (SteamAPI_Init() failed).\n");
+        ULOG_ERROR(k_ELogSteam, "Fatal Error - the %s Steam backend failed to start.", gSteamBackend->GetName());
         success = false;
     }
+    else if (gSteamBackend)
+    {
+        STEAM_Backend::Select(gSteamBackend);
+        STEAM_Pump::Start(gSteamBackend);
+    }
+    UStartupProfiler::end();
 
     // Initialize SDL subsystems
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) 
+    UStartupProfiler::begin("SDL_Init");
+    int sdlInitResult = SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
+    UStartupProfiler::end();
+    if (sdlInitResult < 0) 
     {
-        // printf("SDL could not initialize! SDL Error: %s\n", SDL_GetError());
+        ULOG_ERROR(k_ELogRender, "SDL could not initialize! SDL Error: %s", SDL_GetError());
         success = false;
     }
     else 
     {
         // Create window
-        if (!gWindow.init(ULib::TITLE, ULib::SCREEN_DIMENSIONS.x, ULib::SCREEN_DIMENSIONS.y, "assets/hamster_icon.png")) 
+        UStartupProfiler::begin("UWindow::init");
+        bool windowCreated = gWindow.init(ULib::TITLE, ULib::SCREEN_DIMENSIONS.x, ULib::SCREEN_DIMENSIONS.y, "assets/hamster_icon.png");
+        UStartupProfiler::end();
+        if (!windowCreated) 
         {
-            // printf("Window could not be created! SDL Error: %s\n", SDL_GetError());
+            ULOG_ERROR(k_ELogRender, "Window could not be created! SDL Error: %s", SDL_GetError());
             success = false;
         }
         else 
@@ -59,7 +82,7 @@ bool init()
             gRenderer = gWindow.getRenderer();
             if (gRenderer == nullptr) 
             {
-                // printf("Renderer could not be created! SDL Error: %s\n", SDL_GetError());
+                ULOG_ERROR(k_ELogRender, "Renderer could not be created! SDL Error: %s", SDL_GetError());
                 success = false;
             }
             else 
@@ -69,25 +92,31 @@ bool init()
 
                 // Initialize PNG loading
                 int imgFlags = IMG_INIT_PNG;
+                UStartupProfiler::begin("IMG_Init");
                 if (!(IMG_Init(imgFlags) & imgFlags)) 
                 {
-                    // printf("SDL_image could not initialzie! SDL_image Error: %s\n", IMG_GetError());
+                    ULOG_ERROR(k_ELogRender, "SDL_image could not initialzie! SDL_image Error: %s", IMG_GetError());
                     success = false;
                 }
+                UStartupProfiler::end();
 
-                // Initialize music
-                if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) 
+                // Initialize music, at the device's own rate with the buffer from "--audio-buffer"
+                UStartupProfiler::begin("Mix_OpenAudio");
+                if (!UAudio::open()) 
                 {
-                    // printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
+                    ULOG_ERROR(k_ELogAudio, "SDL_mixer could not initialize! SDL_mixer Error: %s", Mix_GetError());
                     success = false;
                 }
+                UStartupProfiler::end();
 
                 // Initialize fonts
+                UStartupProfiler::begin("TTF_Init");
                 if (TTF_Init() == -1) 
                 {
-                    // printf("SDL_ttf could not initialize! SDL_ttf Error: %s \n", TTF_GetError());
+                    ULOG_ERROR(k_ELogRender, "SDL_ttf could not initialize! SDL_ttf Error: %s", TTF_GetError());
                     success = false;
                 }
+                UStartupProfiler::end();
 
             }
         }
@@ -98,7 +127,7 @@ bool init()
 // Closes and frees all the resources used to run the game
 void close() 
 {
-    // printf("Cleaning up...");
+    ULOG_INFO(k_ELogGame, "Cleaning up...");
 
     // Destroy window
     gWindow.free();
@@ -107,38 +136,105 @@ void close()
     // Quit SDL subsystems
     TTF_Quit();
     IMG_Quit();
+    UAudio::close();
     Mix_Quit();
     SDL_Quit();
 
     // Free resources used by the steam API
-    SteamAPI_Shutdown();
+    if (SteamBackend())
+    {
+        STEAM_Pump::Stop();
+        SteamBackend()->Shutdown();
+        STEAM_Backend::Select(nullptr);
+    }
+    delete gSteamBackend;
+    gSteamBackend = nullptr;
 
-    // printf(" done.\n");
+    ULOG_INFO(k_ELogGame, "Clean up done.");
 }
 
 // Main Method
 int main(int argc, char *args[]) 
 {
-    // Hide the console window at startup
-    ::ShowWindow(::GetConsoleWindow(), SW_HIDE);
+    // "Hamster --decode-flight <file>" prints a flight recorder dump instead of running the game
+    if (argc == 3 && strcmp(args[1], "--decode-flight") == 0)
+    {
+        return UFlightRecorder::decode(args[2], stdout) ? 0 : 1;
+    }
+
+    // "Hamster --bench <script>" runs the game headless from a script of input events
+    // "Hamster --microbench" times the engine hot paths one at a time
+    bool benchmark = UBench::parseArgs(argc, args);
+    bool microbenchmark = !benchmark && UMicrobench::parseArgs(argc, args);
+    bool headless = benchmark || microbenchmark;
+    int exitCode = 0;
+
+    // Hide the console window at startup, benchmark runs report to it
+    if (!headless)
+    {
+        ::ShowWindow(::GetConsoleWindow(), SW_HIDE);
+    }
+
+    // Start the logger before anything else so init failures are recorded
+    ULog::init("hamster.log");
+    UFlightRecorder::init();
+
+    if (headless)
+    {
+        UBench::configureSDL(gWindow);
+    }
+
+    // "--local-steam <file>" swaps the Steam client for the local stand in, in any mode.
+    // Otherwise headless runs go without Steam.
+    STEAM_LocalConfig_t localSteamConfig;
+    if (STEAM_LocalBackend::ParseArgs(argc, args, localSteamConfig))
+    {
+        gSteamBackend = new STEAM_LocalBackend(localSteamConfig);
+    }
+    else if (!headless)
+    {
+        gSteamBackend = STEAM_Backend::CreateSteamworks();
+    }
+
+    // "--race-host <port>" or "--race-join <ip>:<port>" races another player over the network
+    STEAM_RaceConfig_t raceConfig;
+    bool race = STEAM_Race::ParseArgs(argc, args, raceConfig);
+
+    // "--audio-buffer <frames>" sets the audio buffer, smaller is quicker but runs dry easier
+    UAudio::parseArgs(argc, args);
 
     // Start up SDL and create window
     if (!init()) 
     {
-        // printf("Failed to initialize!\n");
+        ULOG_ERROR(k_ELogGame, "Failed to initialize!");
+        exitCode = 1;
     }
     else 
     {
         // Our game wrapper class
         UGame game;
-        if (!game.init(gRenderer, &gWindow)) 
+        if (!game.init(gRenderer, &gWindow, headless, race ? &raceConfig : nullptr)) 
         {
-            // printf("Failed to initialize UGame!\n");
+            ULOG_ERROR(k_ELogGame, "Failed to initialize UGame!");
+            exitCode = 1;
         }
         else 
         {
+            // Startup is done, write out where the time went
+            UStartupProfiler::finish("hamster_startup.txt", "hamster_trace.json");
+
+            // Benchmark runs drive the game themselves and skip the interactive loop
+            if (benchmark)
+            {
+                exitCode = UBench::run(game, gRenderer);
+            }
+            else if (microbenchmark)
+            {
+                exitCode = UMicrobench::run(game, gRenderer);
+            }
+
             // Game running flag
-            bool quit = false;
+            bool quit = headless;
             bool windowScaleUpdate = false;
 
             // Event handler
@@ -149,6 +245,8 @@ int main(int argc, char *args[])
             const int frameDelay = 1000 / FPS;
             Uint32 fStart;
             int fTime;
+            Uint64 fStartTicks;
+            const Uint64 perfFrequency = SDL_GetPerformanceFrequency();
             Uint32 pTime = SDL_GetTicks();
             Uint32 cTime = pTime;
 
@@ -158,10 +256,12 @@ int main(int argc, char *args[])
             while (!quit) 
             {
                 fStart = SDL_GetTicks();
+                fStartTicks = SDL_GetPerformanceCounter();
 
                 // Handle events
                 while (SDL_PollEvent(&e) != 0)
                 {
+                    UFlightRecorder::recordInput(e);
                     quit = game.handleEvent(e);
                 }
 
@@ -180,6 +280,7 @@ int main(int argc, char *args[])
 
                 // This measures how long this iteration of the loop took
                 fTime = SDL_GetTicks() - fStart;
+                UFlightRecorder::recordFrame(static_cast<Uint32>((SDL_GetPerformanceCounter() - fStartTicks) * 1000000 / perfFrequency), static_cast<Uint32>(dt * 1000000.f));
 
                 // This keeps us from displaying more frames than 60
                 if (frameDelay > fTime) 
@@ -193,5 +294,7 @@ int main(int argc, char *args[])
     }
 
     close();
-    return 0;
+    UFlightRecorder::free();
+    ULog::free();
+    return exitCode;
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Async.cpp
+*/
+#include "STEAM_Async.h"
+#include <algorithm>
+
+namespace
+{
+    // Every live scope, walked for timeouts
+    std::vector<STEAM_AsyncScope *> g_rgScopes;
+}
+
+// Constructor
+STEAM_AsyncScope::STEAM_AsyncScope()
+{
+    g_rgScopes.push_back(this);
+}
+
+// Destructor, cancels the calls in flight
+STEAM_AsyncScope::~STEAM_AsyncScope()
+{
+    CancelAll();
+    g_rgScopes.erase(std::remove(g_rgScopes.begin(), g_rgScopes.end(), this), g_rgScopes.end());
+}
+
+// Cancel every call in flight, their handlers never run
+void STEAM_AsyncScope::CancelAll()
+{
+    for (std::unique_ptr<Call> &pCall : m_rgCalls)
+    {
+        STEAM_Backend::UnregisterCallResult(pCall->m_hAPICall);
+    }
+    m_rgCalls.clear();
+}
+
+// Start waiting on pCall, the scope owns it
+void STEAM_AsyncScope::Add(Call *pCall, Uint32 unTimeoutMS)
+{
+    pCall->m_pScope = this;
+    pCall->m_unDeadlineTicks = SDL_GetTicks() + unTimeoutMS;
+    m_rgCalls.push_back(std::unique_ptr<Call>(pCall));
+    STEAM_Backend::RegisterCallResult(pCall, pCall->m_hAPICall);
+}
+
+// Stop tracking pCall and free it
+void STEAM_AsyncScope::Remove(Call *pCall)
+{
+    for (auto it = m_rgCalls.begin(); it != m_rgCalls.end(); ++it)
+    {
+        if (it->get() == pCall)
+        {
+            m_rgCalls.erase(it);
+            return;
+        }
+    }
+}
+
+// Fail the calls that ran out of time. Handlers can start or cancel calls and create or
+// destroy scopes, so the search starts over after each one.
+void STEAM_AsyncScope::RunTimeouts()
+{
+    const Uint32 unNow = SDL_GetTicks();
+    bool bExpired = true;
+    while (bExpired)
+    {
+        bExpired = false;
+        for (STEAM_AsyncScope *pScope : g_rgScopes)
+        {
+            for (std::unique_ptr<Call> &pCall : pScope->m_rgCalls)
+            {
+                if (static_cast<Sint32>(unNow - pCall->m_unDeadlineTicks) >= 0)
+                {
+                    ULOG_WARN(k_ELogSteam, "Steam call %llu timed out", pCall->m_hAPICall);
+                    STEAM_Backend::UnregisterCallResult(pCall->m_hAPICall);
+                    pCall->Expire();
+                    bExpired = true;
+                    break;
+                }
+            }
+            if (bExpired)
+                break;
+        }
+    }
+}
\ No newline at end of file
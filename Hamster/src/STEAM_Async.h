@@ -0,0 +1,107 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Async.h
+*/
+#pragma once
+#include "STEAM_Backend.h"
+#include <functional>
+#include <memory>
+
+// Calls that haven't finished after this long get an IO failure
+#define STEAM_ASYNC_TIMEOUT_MS 30000
+
+// Owns any number of Steam calls in flight, each with its own handler, so a class can make
+// as many calls of a kind at once as it likes instead of keeping a STEAM_CallResult member
+// per call. Calls that take longer than their timeout finish with an IO failure and a zeroed
+// result, and calls still in flight when the scope is destroyed are cancelled.
+//
+//     m_asyncCalls.Await<LeaderboardFindResult_t>(SteamBackend()->FindLeaderboard(pchName),
+//         [this](LeaderboardFindResult_t *pResult, bool bIOFailure) { ... });
+class STEAM_AsyncScope
+{
+public:
+    // Constructor
+    STEAM_AsyncScope();
+
+    // Destructor, cancels the calls in flight
+    ~STEAM_AsyncScope();
+
+    // Run fnDone on the game thread once hAPICall finishes or unTimeoutMS passes. Returns
+    // false without calling fnDone if hAPICall isn't a valid call.
+    template<class P>
+    bool Await(SteamAPICall_t hAPICall, std::function<void(P *, bool)> fnDone, Uint32 unTimeoutMS = STEAM_ASYNC_TIMEOUT_MS);
+
+    // Cancel every call in flight, their handlers never run
+    void CancelAll();
+
+    // Calls in flight
+    int GetPendingCount() const { return static_cast<int>(m_rgCalls.size()); }
+
+    // Fail the calls that ran out of time, called once a frame by STEAM_Pump::Dispatch()
+    static void RunTimeouts();
+
+private:
+    STEAM_AsyncScope(const STEAM_AsyncScope &) = delete;
+    STEAM_AsyncScope &operator=(const STEAM_AsyncScope &) = delete;
+
+    // A call in flight
+    class Call : public STEAM_CallbackBase
+    {
+    public:
+        STEAM_AsyncScope *m_pScope;
+        SteamAPICall_t m_hAPICall;
+        Uint32 m_unDeadlineTicks;
+
+        // Finish with an IO failure and a zeroed result
+        virtual void Expire() = 0;
+    };
+
+    // A call with the handler for its result type
+    template<class P>
+    class TypedCall : public Call
+    {
+    public:
+        std::function<void(P *, bool)> m_fnDone;
+
+        void Run(void *pvParam, bool bIOFailure) override
+        {
+            // The call is gone before the handler runs, so the handler can make more calls
+            // or destroy the scope
+            std::function<void(P *, bool)> fnDone = std::move(m_fnDone);
+            m_pScope->Remove(this);
+            fnDone(static_cast<P *>(pvParam), bIOFailure);
+        }
+
+        void Expire() override
+        {
+            P result;
+            memset(&result, 0, sizeof(result));
+            Run(&result, true);
+        }
+    };
+
+    // Start waiting on pCall, the scope owns it
+    void Add(Call *pCall, Uint32 unTimeoutMS);
+
+    // Stop tracking pCall and free it
+    void Remove(Call *pCall);
+
+    std::vector<std::unique_ptr<Call>> m_rgCalls;
+};
+
+// Run fnDone on the game thread once hAPICall finishes or unTimeoutMS passes
+template<class P>
+bool STEAM_AsyncScope::Await(SteamAPICall_t hAPICall, std::function<void(P *, bool)> fnDone, Uint32 unTimeoutMS)
+{
+    if (hAPICall == k_uAPICallInvalid)
+        return false;
+
+    TypedCall<P> *pCall = new TypedCall<P>();
+    pCall->m_hAPICall = hAPICall;
+    pCall->m_fnDone = std::move(fnDone);
+    Add(pCall, unTimeoutMS);
+    return true;
+}
\ No newline at end of file
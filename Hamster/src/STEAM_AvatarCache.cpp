@@ -0,0 +1,342 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_AvatarCache.cpp
+*/
+#include "STEAM_AvatarCache.h"
+#include <algorithm>
+
+// Avatars are stored this many pixels square, Steam's small avatars are 32
+#define AVATAR_SIZE 32
+
+// Slots across and down the atlas
+#define AVATAR_ATLAS_COLUMNS 8
+#define AVATAR_ATLAS_ROWS 8
+
+// Players remembered, including the ones without a slot
+#define AVATAR_CACHE_MAX_ENTRIES 256
+
+// Converted avatars copied into the atlas per frame
+#define AVATAR_UPLOADS_PER_FRAME 16
+
+// Constructor
+STEAM_AvatarCache::STEAM_AvatarCache() :
+    m_CallbackAvatarImageLoaded(this, &STEAM_AvatarCache::OnAvatarImageLoaded)
+{
+    m_pRenderer = nullptr;
+    m_pAtlas = nullptr;
+    m_nDirtyTop = 0;
+    m_nDirtyBottom = 0;
+    m_unFrame = 0;
+    m_unGeneration = 0;
+    m_bStop = false;
+}
+
+// Destructor, stops the worker
+STEAM_AvatarCache::~STEAM_AvatarCache()
+{
+    free();
+}
+
+// Create the atlas and start the worker
+bool STEAM_AvatarCache::init(SDL_Renderer *pRenderer)
+{
+    m_pRenderer = pRenderer;
+    m_pAtlas = SDL_CreateTexture(pRenderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, AVATAR_SIZE * AVATAR_ATLAS_COLUMNS, AVATAR_SIZE * AVATAR_ATLAS_ROWS);
+    if (!m_pAtlas)
+    {
+        ULOG_ERROR(k_ELogRender, "Failed to create the avatar atlas, SDL Error: %s", SDL_GetError());
+        return false;
+    }
+    SDL_SetTextureBlendMode(m_pAtlas, SDL_BLENDMODE_BLEND);
+
+    m_rgubAtlasPixels.assign(AVATAR_SIZE * AVATAR_ATLAS_COLUMNS * AVATAR_SIZE * AVATAR_ATLAS_ROWS * 4, 0);
+    m_rgulSlotOwners.assign(AVATAR_ATLAS_COLUMNS * AVATAR_ATLAS_ROWS, 0);
+
+    m_bStop = false;
+    m_thread = std::thread(&STEAM_AvatarCache::RunWorker, this);
+    return true;
+}
+
+// Start fetching the avatar of steamID unless it's cached or on the way
+void STEAM_AvatarCache::Request(CSteamID steamID)
+{
+    if (!m_pAtlas || !SteamBackend())
+        return;
+
+    uint64 ulSteamID = steamID.ConvertToUint64();
+    auto it = m_mapAvatars.find(ulSteamID);
+    if (it != m_mapAvatars.end())
+    {
+        it->second.m_unLastUsed = m_unFrame;
+        return;
+    }
+
+    Avatar_t &avatar = m_mapAvatars[ulSteamID];
+    avatar.m_iImage = SteamBackend()->GetSmallFriendAvatar(steamID);
+    avatar.m_iSlot = -1;
+    avatar.m_unLastUsed = m_unFrame;
+    if (avatar.m_iImage == 0)
+    {
+        avatar.m_eState = k_EAvatarNone;
+    }
+    else if (avatar.m_iImage == -1)
+    {
+        avatar.m_eState = k_EAvatarLoading;
+    }
+    else
+    {
+        Convert(ulSteamID, avatar, avatar.m_iImage);
+    }
+
+    Trim();
+}
+
+// Upload the avatars the worker finished. They're copied into the CPU side atlas and the
+// rows that changed go up in one SDL_UpdateTexture().
+void STEAM_AvatarCache::Update()
+{
+    ++m_unFrame;
+    if (!m_pAtlas)
+        return;
+
+    std::vector<Job_t> rgDone;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (!m_rgDone.empty() && rgDone.size() < AVATAR_UPLOADS_PER_FRAME)
+        {
+            rgDone.push_back(std::move(m_rgDone.front()));
+            m_rgDone.pop_front();
+        }
+    }
+
+    const int nPitch = AVATAR_SIZE * AVATAR_ATLAS_COLUMNS * 4;
+    for (Job_t &job : rgDone)
+    {
+        // Dropped or given a newer image while the worker had it
+        auto it = m_mapAvatars.find(job.m_ulSteamID);
+        if (it == m_mapAvatars.end() || it->second.m_eState != k_EAvatarConverting || it->second.m_iImage != job.m_iImage)
+            continue;
+
+        Avatar_t &avatar = it->second;
+        if (!job.m_bSuccess)
+        {
+            ULOG_WARN(k_ELogSteam, "Failed to load the avatar of %llu", job.m_ulSteamID);
+            avatar.m_eState = k_EAvatarNone;
+            continue;
+        }
+
+        if (avatar.m_iSlot < 0)
+        {
+            avatar.m_iSlot = AllocateSlot();
+            if (avatar.m_iSlot < 0)
+            {
+                // Every slot is on screen, try again next frame
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_rgDone.push_back(std::move(job));
+                continue;
+            }
+            m_rgulSlotOwners[avatar.m_iSlot] = job.m_ulSteamID;
+        }
+
+        int nLeft = (avatar.m_iSlot % AVATAR_ATLAS_COLUMNS) * AVATAR_SIZE;
+        int nTop = (avatar.m_iSlot / AVATAR_ATLAS_COLUMNS) * AVATAR_SIZE;
+        for (int y = 0; y < AVATAR_SIZE; ++y)
+        {
+            memcpy(&m_rgubAtlasPixels[(nTop + y) * nPitch + nLeft * 4], &job.m_rgubPixels[y * AVATAR_SIZE * 4], AVATAR_SIZE * 4);
+        }
+
+        if (m_nDirtyTop == m_nDirtyBottom)
+        {
+            m_nDirtyTop = nTop;
+            m_nDirtyBottom = nTop + AVATAR_SIZE;
+        }
+        else
+        {
+            m_nDirtyTop = MIN(m_nDirtyTop, nTop);
+            m_nDirtyBottom = MAX(m_nDirtyBottom, nTop + AVATAR_SIZE);
+        }
+        avatar.m_eState = k_EAvatarReady;
+    }
+
+    if (m_nDirtyTop != m_nDirtyBottom)
+    {
+        SDL_Rect rect = { 0, m_nDirtyTop, AVATAR_SIZE * AVATAR_ATLAS_COLUMNS, m_nDirtyBottom - m_nDirtyTop };
+        SDL_UpdateTexture(m_pAtlas, &rect, &m_rgubAtlasPixels[m_nDirtyTop * nPitch], nPitch);
+        m_nDirtyTop = m_nDirtyBottom = 0;
+        ++m_unGeneration;
+    }
+}
+
+// Draw the avatar of steamID nSize pixels square, nothing is drawn until it's ready
+void STEAM_AvatarCache::Render(CSteamID steamID, int x, int y, int nSize)
+{
+    auto it = m_mapAvatars.find(steamID.ConvertToUint64());
+    if (it == m_mapAvatars.end())
+        return;
+
+    // A player who changed avatar keeps the old one until the new one is in
+    it->second.m_unLastUsed = m_unFrame;
+    if (it->second.m_iSlot < 0)
+        return;
+
+    SDL_Rect src = { (it->second.m_iSlot % AVATAR_ATLAS_COLUMNS) * AVATAR_SIZE, (it->second.m_iSlot / AVATAR_ATLAS_COLUMNS) * AVATAR_SIZE, AVATAR_SIZE, AVATAR_SIZE };
+    SDL_Rect dst = { x, y, nSize, nSize };
+    ++UTexture::sRenderCount;
+    SDL_RenderCopy(m_pRenderer, m_pAtlas, &src, &dst);
+}
+
+// Stop the worker and free the atlas
+void STEAM_AvatarCache::free()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStop = true;
+        }
+        m_cvWork.notify_one();
+        m_thread.join();
+    }
+    m_rgJobs.clear();
+    m_rgDone.clear();
+
+    if (m_pAtlas)
+    {
+        SDL_DestroyTexture(m_pAtlas);
+        m_pAtlas = nullptr;
+    }
+    m_mapAvatars.clear();
+    m_rgulSlotOwners.clear();
+    m_rgubAtlasPixels.clear();
+}
+
+// Queue the conversion of iImage
+void STEAM_AvatarCache::Convert(uint64 ulSteamID, Avatar_t &avatar, int iImage)
+{
+    avatar.m_eState = k_EAvatarConverting;
+    avatar.m_iImage = iImage;
+
+    Job_t job;
+    job.m_ulSteamID = ulSteamID;
+    job.m_iImage = iImage;
+    job.m_bSuccess = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_rgJobs.push_back(std::move(job));
+    }
+    m_cvWork.notify_one();
+}
+
+// A free atlas slot, or the one drawn longest ago. Slots drawn last frame are still on
+// screen, -1 if that's all of them.
+int STEAM_AvatarCache::AllocateSlot()
+{
+    int iOldest = -1;
+    Uint32 unOldest = 0;
+    for (size_t i = 0; i < m_rgulSlotOwners.size(); ++i)
+    {
+        if (!m_rgulSlotOwners[i])
+            return static_cast<int>(i);
+
+        Uint32 unLastUsed = m_mapAvatars[m_rgulSlotOwners[i]].m_unLastUsed;
+        if (unLastUsed + 1 < m_unFrame && (iOldest < 0 || unLastUsed < unOldest))
+        {
+            iOldest = static_cast<int>(i);
+            unOldest = unLastUsed;
+        }
+    }
+
+    if (iOldest >= 0)
+    {
+        m_mapAvatars.erase(m_rgulSlotOwners[iOldest]);
+        m_rgulSlotOwners[iOldest] = 0;
+    }
+    return iOldest;
+}
+
+// Drop the players drawn longest ago once there are more than AVATAR_CACHE_MAX_ENTRIES, their
+// slots are freed
+void STEAM_AvatarCache::Trim()
+{
+    if (m_mapAvatars.size() <= AVATAR_CACHE_MAX_ENTRIES)
+        return;
+
+    std::vector<std::pair<Uint32, uint64>> rgLastUsed;
+    for (const std::pair<const uint64, Avatar_t> &avatar : m_mapAvatars)
+    {
+        if (avatar.second.m_unLastUsed + 1 < m_unFrame)
+        {
+            rgLastUsed.push_back(std::make_pair(avatar.second.m_unLastUsed, avatar.first));
+        }
+    }
+
+    size_t cDrop = MIN(m_mapAvatars.size() - AVATAR_CACHE_MAX_ENTRIES, rgLastUsed.size());
+    std::partial_sort(rgLastUsed.begin(), rgLastUsed.begin() + cDrop, rgLastUsed.end());
+    for (size_t i = 0; i < cDrop; ++i)
+    {
+        auto it = m_mapAvatars.find(rgLastUsed[i].second);
+        if (it->second.m_iSlot >= 0)
+        {
+            m_rgulSlotOwners[it->second.m_iSlot] = 0;
+        }
+        m_mapAvatars.erase(it);
+    }
+}
+
+// Fetch and convert queued avatars until free() is called. Steam's image calls are thread
+// safe, the local backend's only read the image handle.
+void STEAM_AvatarCache::RunWorker()
+{
+    std::vector<uint8> rgubImage;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cvWork.wait(lock, [this] { return m_bStop || !m_rgJobs.empty(); });
+        if (m_bStop)
+            return;
+
+        Job_t job = std::move(m_rgJobs.front());
+        m_rgJobs.pop_front();
+        lock.unlock();
+
+        uint32 unWidth = 0, unHeight = 0;
+        STEAM_Backend *pBackend = SteamBackend();
+        if (pBackend && pBackend->GetImageSize(job.m_iImage, &unWidth, &unHeight) && unWidth && unHeight)
+        {
+            rgubImage.resize(unWidth * unHeight * 4);
+            job.m_bSuccess = pBackend->GetImageRGBA(job.m_iImage, rgubImage.data(), static_cast<int>(rgubImage.size()));
+        }
+
+        // Scale to the atlas slot, nearest neighbour is plenty for avatars this small
+        if (job.m_bSuccess)
+        {
+            job.m_rgubPixels.resize(AVATAR_SIZE * AVATAR_SIZE * 4);
+            for (int y = 0; y < AVATAR_SIZE; ++y)
+            {
+                uint32 unSourceY = y * unHeight / AVATAR_SIZE;
+                for (int x = 0; x < AVATAR_SIZE; ++x)
+                {
+                    uint32 unSourceX = x * unWidth / AVATAR_SIZE;
+                    memcpy(&job.m_rgubPixels[(y * AVATAR_SIZE + x) * 4], &rgubImage[(unSourceY * unWidth + unSourceX) * 4], 4);
+                }
+            }
+        }
+
+        lock.lock();
+        m_rgDone.push_back(std::move(job));
+    }
+}
+
+// Called when Steam finishes downloading an avatar, including a new one for a player
+// already in the atlas
+void STEAM_AvatarCache::OnAvatarImageLoaded(AvatarImageLoaded_t *pParam)
+{
+    auto it = m_mapAvatars.find(pParam->m_steamID.ConvertToUint64());
+    if (it == m_mapAvatars.end() || pParam->m_iImage <= 0 || pParam->m_iImage == it->second.m_iImage)
+        return;
+
+    Convert(it->first, it->second, pParam->m_iImage);
+}
\ No newline at end of file
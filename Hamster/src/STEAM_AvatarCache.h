@@ -0,0 +1,106 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_AvatarCache.h
+*/
+#pragma once
+#include "STEAM_Backend.h"
+#include "UTexture.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// Small avatars of the players on the leaderboards, packed into one atlas texture. Avatars
+// are fetched from Steam and converted on a worker thread, then copied into a CPU side copy
+// of the atlas and uploaded once a frame in a single SDL_UpdateTexture(), so scrolling never
+// waits on a decode. Avatars Steam is still downloading are picked up when it posts
+// AvatarImageLoaded_t. When the atlas is full the avatar drawn longest ago gives up its slot.
+class STEAM_AvatarCache
+{
+public:
+    // Constructor
+    STEAM_AvatarCache();
+
+    // Destructor, stops the worker
+    ~STEAM_AvatarCache();
+
+    // Create the atlas and start the worker
+    bool init(SDL_Renderer *pRenderer);
+
+    // Start fetching the avatar of steamID unless it's cached or on the way
+    void Request(CSteamID steamID);
+
+    // Upload the avatars the worker finished, called once a frame before rendering
+    void Update();
+
+    // Draw the avatar of steamID nSize pixels square, nothing is drawn until it's ready
+    void Render(CSteamID steamID, int x, int y, int nSize);
+
+    // Goes up every time Update() adds avatars to the atlas, anything showing them should redraw
+    Uint32 GetGeneration() const { return m_unGeneration; }
+
+    // Stop the worker and free the atlas
+    void free();
+
+private:
+    enum EAvatarState
+    {
+        k_EAvatarNone,         // The player has no avatar
+        k_EAvatarLoading,      // Steam is downloading it, waiting for AvatarImageLoaded_t
+        k_EAvatarConverting,   // Queued on the worker
+        k_EAvatarReady         // In the atlas at m_iSlot
+    };
+
+    struct Avatar_t
+    {
+        EAvatarState m_eState;
+        int m_iImage;          // Steam image handle
+        int m_iSlot;           // Atlas slot while ready
+        Uint32 m_unLastUsed;   // m_unFrame when it was last requested or drawn
+    };
+
+    // An avatar for the worker to convert, then for the game thread to upload
+    struct Job_t
+    {
+        uint64 m_ulSteamID;
+        int m_iImage;
+        bool m_bSuccess;
+        std::vector<uint8> m_rgubPixels;   // AVATAR_SIZE square, RGBA
+    };
+
+    // Queue the conversion of iImage
+    void Convert(uint64 ulSteamID, Avatar_t &avatar, int iImage);
+
+    // A free atlas slot, or the one drawn longest ago. -1 if every slot was drawn this frame.
+    int AllocateSlot();
+
+    // Drop the players drawn longest ago once there are more than AVATAR_CACHE_MAX_ENTRIES
+    void Trim();
+
+    // Fetch and convert queued avatars until free() is called
+    void RunWorker();
+
+    // Called when Steam finishes downloading an avatar
+    STEAM_BACKEND_CALLBACK(STEAM_AvatarCache, OnAvatarImageLoaded, AvatarImageLoaded_t, m_CallbackAvatarImageLoaded);
+
+    SDL_Renderer *m_pRenderer;
+    SDL_Texture *m_pAtlas;
+    std::vector<uint8> m_rgubAtlasPixels;      // CPU side copy of m_pAtlas
+    int m_nDirtyTop, m_nDirtyBottom;           // Rows of m_rgubAtlasPixels not uploaded yet
+    std::vector<uint64> m_rgulSlotOwners;      // SteamID in each atlas slot, 0 if it's free
+    std::unordered_map<uint64, Avatar_t> m_mapAvatars;
+    Uint32 m_unFrame;                          // Counts Update() calls
+    Uint32 m_unGeneration;                     // Updates that changed the atlas
+
+    // Shared with the worker
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cvWork;
+    bool m_bStop;
+    std::deque<Job_t> m_rgJobs;                // Waiting to be converted
+    std::deque<Job_t> m_rgDone;                // Waiting to be uploaded
+};
\ No newline at end of file
@@ -0,0 +1,356 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Backend.cpp
+*/
+#include "STEAM_Backend.h"
+#include "STEAM_Pump.h"
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // The active backend
+    STEAM_Backend *g_pBackend = nullptr;
+
+    // Everything waiting on a callback, keyed by k_iCallback. While a callback is being
+    // dispatched, unregistering only clears the pointer and the entry is erased afterwards.
+    std::vector<std::pair<int, STEAM_CallbackBase *>> g_rgCallbacks;
+    int g_cCallbackDispatches = 0;
+
+    // Everything waiting on a call result, and when the call was made
+    std::map<SteamAPICall_t, std::pair<STEAM_CallbackBase *, Uint64>> g_mapCallResults;
+
+    // Dispatch latency so far
+    STEAM_Latency_t g_latencyHandoff = {};
+    STEAM_Latency_t g_latencyCallResult = {};
+
+    // Add a sample of unTicks performance counter ticks
+    void addLatency(STEAM_Latency_t &latency, Uint64 unTicks)
+    {
+        double flUS = unTicks * 1000000.0 / SDL_GetPerformanceFrequency();
+        ++latency.m_cSamples;
+        latency.m_flTotalUS += flUS;
+        latency.m_flMaxUS = SDL_max(latency.m_flMaxUS, flUS);
+    }
+
+    // Talks to the Steam client through the flat API. Callbacks are pumped by hand with
+    // SteamAPI_ManualDispatch so they go through the same dispatch as the local backend.
+    class STEAM_SteamworksBackend : public STEAM_Backend
+    {
+    public:
+        STEAM_SteamworksBackend() : m_hSteamPipe(0) {}
+
+        // Relaunch through the Steam client if the game wasn't started by it
+        bool RestartAppIfNecessary(uint32 unOwnAppID) override
+        {
+            return SteamAPI_RestartAppIfNecessary(unOwnAppID);
+        }
+
+        // Start the Steam API
+        bool Init() override
+        {
+            if (!SteamAPI_Init())
+            {
+                ULOG_ERROR(k_ELogSteam, "Steam must be running to play this game (SteamAPI_Init() failed).");
+                return false;
+            }
+
+            SteamAPI_ManualDispatch_Init();
+            m_hSteamPipe = SteamAPI_GetHSteamPipe();
+            return true;
+        }
+
+        // Stop the Steam API
+        void Shutdown() override
+        {
+            SteamAPI_Shutdown();
+            m_hSteamPipe = 0;
+        }
+
+        // Copy out everything the client has posted, only the pump thread touches the pipe
+        void Poll(std::vector<STEAM_Message_t> &rgMessages) override
+        {
+            if (!m_hSteamPipe)
+                return;
+
+            SteamAPI_ManualDispatch_RunFrame(m_hSteamPipe);
+
+            CallbackMsg_t callback;
+            while (SteamAPI_ManualDispatch_GetNextCallback(m_hSteamPipe, &callback))
+            {
+                STEAM_Message_t message;
+                message.m_unPolledTicks = SDL_GetPerformanceCounter();
+                if (callback.m_iCallback == SteamAPICallCompleted_t::k_iCallback)
+                {
+                    // Call results have to be fetched separately into a buffer of their own
+                    SteamAPICallCompleted_t *pCallCompleted = reinterpret_cast<SteamAPICallCompleted_t *>(callback.m_pubParam);
+                    message.m_iCallback = pCallCompleted->m_iCallback;
+                    message.m_hAPICall = pCallCompleted->m_hAsyncCall;
+                    message.m_bIOFailure = false;
+                    message.m_rgubParam.resize(pCallCompleted->m_cubParam);
+                    if (!SteamAPI_ManualDispatch_GetAPICallResult(m_hSteamPipe, pCallCompleted->m_hAsyncCall, message.m_rgubParam.data(), pCallCompleted->m_cubParam, pCallCompleted->m_iCallback, &message.m_bIOFailure))
+                    {
+                        // Still deliver it, as a failure, so whoever is waiting can try again
+                        message.m_bIOFailure = true;
+                        std::fill(message.m_rgubParam.begin(), message.m_rgubParam.end(), 0);
+                    }
+                    rgMessages.push_back(std::move(message));
+                }
+                else
+                {
+                    message.m_iCallback = callback.m_iCallback;
+                    message.m_hAPICall = k_uAPICallInvalid;
+                    message.m_bIOFailure = false;
+                    message.m_rgubParam.assign(callback.m_pubParam, callback.m_pubParam + callback.m_cubParam);
+                    rgMessages.push_back(std::move(message));
+                }
+                SteamAPI_ManualDispatch_FreeLastCallback(m_hSteamPipe);
+            }
+        }
+
+        const char *GetName() override { return "Steamworks"; }
+
+        uint32 GetAppID() override { return SteamUtils()->GetAppID(); }
+        bool GetImageSize(int iImage, uint32 *pnWidth, uint32 *pnHeight) override { return SteamUtils()->GetImageSize(iImage, pnWidth, pnHeight); }
+        bool GetImageRGBA(int iImage, uint8 *pubDest, int nDestBufferSize) override { return SteamUtils()->GetImageRGBA(iImage, pubDest, nDestBufferSize); }
+
+        CSteamID GetSteamID() override { return SteamUser()->GetSteamID(); }
+
+        const char *GetPersonaName() override { return SteamFriends()->GetPersonaName(); }
+        const char *GetFriendPersonaName(CSteamID steamIDFriend) override { return SteamFriends()->GetFriendPersonaName(steamIDFriend); }
+        int GetSmallFriendAvatar(CSteamID steamIDFriend) override { return SteamFriends()->GetSmallFriendAvatar(steamIDFriend); }
+
+        bool RequestCurrentStats() override { return SteamUserStats()->RequestCurrentStats(); }
+        bool GetStat(const char *pchName, int32 *pData) override { return SteamUserStats()->GetStat(pchName, pData); }
+        bool SetStat(const char *pchName, int32 nData) override { return SteamUserStats()->SetStat(pchName, nData); }
+        bool GetAchievement(const char *pchName, bool *pbAchieved) override { return SteamUserStats()->GetAchievement(pchName, pbAchieved); }
+        bool SetAchievement(const char *pchName) override { return SteamUserStats()->SetAchievement(pchName); }
+        const char *GetAchievementDisplayAttribute(const char *pchName, const char *pchKey) override { return SteamUserStats()->GetAchievementDisplayAttribute(pchName, pchKey); }
+        bool StoreStats() override { return SteamUserStats()->StoreStats(); }
+        bool ResetAllStats(bool bAchievementsToo) override { return SteamUserStats()->ResetAllStats(bAchievementsToo); }
+
+        SteamAPICall_t FindLeaderboard(const char *pchLeaderboardName) override
+        {
+            return SteamUserStats()->FindLeaderboard(pchLeaderboardName);
+        }
+
+        const char *GetLeaderboardName(SteamLeaderboard_t hSteamLeaderboard) override
+        {
+            return SteamUserStats()->GetLeaderboardName(hSteamLeaderboard);
+        }
+
+        int GetLeaderboardEntryCount(SteamLeaderboard_t hSteamLeaderboard) override
+        {
+            return SteamUserStats()->GetLeaderboardEntryCount(hSteamLeaderboard);
+        }
+
+        SteamAPICall_t DownloadLeaderboardEntries(SteamLeaderboard_t hSteamLeaderboard, ELeaderboardDataRequest eLeaderboardDataRequest, int nRangeStart, int nRangeEnd) override
+        {
+            return SteamUserStats()->DownloadLeaderboardEntries(hSteamLeaderboard, eLeaderboardDataRequest, nRangeStart, nRangeEnd);
+        }
+
+        bool GetDownloadedLeaderboardEntry(SteamLeaderboardEntries_t hSteamLeaderboardEntries, int index, LeaderboardEntry_t *pLeaderboardEntry, int32 *pDetails, int cDetailsMax) override
+        {
+            return SteamUserStats()->GetDownloadedLeaderboardEntry(hSteamLeaderboardEntries, index, pLeaderboardEntry, pDetails, cDetailsMax);
+        }
+
+        SteamAPICall_t UploadLeaderboardScore(SteamLeaderboard_t hSteamLeaderboard, ELeaderboardUploadScoreMethod eLeaderboardUploadScoreMethod, int32 nScore, const int32 *pScoreDetails, int cScoreDetailsCount) override
+        {
+            return SteamUserStats()->UploadLeaderboardScore(hSteamLeaderboard, eLeaderboardUploadScoreMethod, nScore, pScoreDetails, cScoreDetailsCount);
+        }
+
+        bool IsCloudEnabledForAccount() override { return SteamRemoteStorage()->IsCloudEnabledForAccount(); }
+        bool IsCloudEnabledForApp() override { return SteamRemoteStorage()->IsCloudEnabledForApp(); }
+        bool FileExists(const char *pchFile) override { return SteamRemoteStorage()->FileExists(pchFile); }
+        int32 GetFileSize(const char *pchFile) override { return SteamRemoteStorage()->GetFileSize(pchFile); }
+
+        SteamAPICall_t FileWriteAsync(const char *pchFile, const void *pvData, uint32 cubData) override
+        {
+            return SteamRemoteStorage()->FileWriteAsync(pchFile, pvData, cubData);
+        }
+
+        SteamAPICall_t FileReadAsync(const char *pchFile, uint32 nOffset, uint32 cubToRead) override
+        {
+            return SteamRemoteStorage()->FileReadAsync(pchFile, nOffset, cubToRead);
+        }
+
+        bool FileReadAsyncComplete(SteamAPICall_t hReadCall, void *pvBuffer, uint32 cubToRead) override
+        {
+            return SteamRemoteStorage()->FileReadAsyncComplete(hReadCall, pvBuffer, cubToRead);
+        }
+
+        HSteamListenSocket CreateListenSocketIP(const SteamNetworkingIPAddr &localAddress) override
+        {
+            return SteamNetworkingSockets()->CreateListenSocketIP(localAddress, 0, nullptr);
+        }
+
+        HSteamNetConnection ConnectByIPAddress(const SteamNetworkingIPAddr &address) override
+        {
+            return SteamNetworkingSockets()->ConnectByIPAddress(address, 0, nullptr);
+        }
+
+        EResult AcceptConnection(HSteamNetConnection hConn) override { return SteamNetworkingSockets()->AcceptConnection(hConn); }
+        bool CloseListenSocket(HSteamListenSocket hSocket) override { return SteamNetworkingSockets()->CloseListenSocket(hSocket); }
+
+        bool CloseConnection(HSteamNetConnection hPeer, int nReason, const char *pszDebug, bool bEnableLinger) override
+        {
+            return SteamNetworkingSockets()->CloseConnection(hPeer, nReason, pszDebug, bEnableLinger);
+        }
+
+        EResult SendMessageToConnection(HSteamNetConnection hConn, const void *pData, uint32 cbData, int nSendFlags, int64 *pOutMessageNumber) override
+        {
+            return SteamNetworkingSockets()->SendMessageToConnection(hConn, pData, cbData, nSendFlags, pOutMessageNumber);
+        }
+
+        int ReceiveMessagesOnConnection(HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages) override
+        {
+            return SteamNetworkingSockets()->ReceiveMessagesOnConnection(hConn, ppOutMessages, nMaxMessages);
+        }
+
+        bool InputInit() override { return SteamInput()->Init(); }
+        bool InputShutdown() override { return SteamInput()->Shutdown(); }
+        void InputRunFrame() override { SteamInput()->RunFrame(); }
+        int GetConnectedControllers(InputHandle_t *handlesOut) override { return SteamInput()->GetConnectedControllers(handlesOut); }
+        InputActionSetHandle_t GetActionSetHandle(const char *pszActionSetName) override { return SteamInput()->GetActionSetHandle(pszActionSetName); }
+        InputDigitalActionHandle_t GetDigitalActionHandle(const char *pszActionName) override { return SteamInput()->GetDigitalActionHandle(pszActionName); }
+
+        void ActivateActionSet(InputHandle_t inputHandle, InputActionSetHandle_t actionSetHandle) override
+        {
+            SteamInput()->ActivateActionSet(inputHandle, actionSetHandle);
+        }
+
+        InputDigitalActionData_t GetDigitalActionData(InputHandle_t inputHandle, InputDigitalActionHandle_t digitalActionHandle) override
+        {
+            return SteamInput()->GetDigitalActionData(inputHandle, digitalActionHandle);
+        }
+
+    private:
+        HSteamPipe m_hSteamPipe;
+    };
+}
+
+// The active backend, nullptr when the game runs without Steam
+STEAM_Backend *SteamBackend()
+{
+    return g_pBackend;
+}
+
+// Make pBackend the one SteamBackend() returns, the caller keeps ownership
+void STEAM_Backend::Select(STEAM_Backend *pBackend)
+{
+    g_pBackend = pBackend;
+    if (pBackend)
+    {
+        ULOG_INFO(k_ELogSteam, "Using the %s Steam backend", pBackend->GetName());
+    }
+}
+
+// Create the backend that talks to the Steam client
+STEAM_Backend *STEAM_Backend::CreateSteamworks()
+{
+    return new STEAM_SteamworksBackend();
+}
+
+// Start delivering iCallback to pCallback
+void STEAM_Backend::RegisterCallback(STEAM_CallbackBase *pCallback, int iCallback)
+{
+    g_rgCallbacks.push_back(std::make_pair(iCallback, pCallback));
+}
+
+// Stop delivering callbacks to pCallback
+void STEAM_Backend::UnregisterCallback(STEAM_CallbackBase *pCallback)
+{
+    for (auto it = g_rgCallbacks.begin(); it != g_rgCallbacks.end(); ++it)
+    {
+        if (it->second == pCallback)
+        {
+            if (g_cCallbackDispatches > 0)
+            {
+                it->second = nullptr;
+            }
+            else
+            {
+                g_rgCallbacks.erase(it);
+            }
+            return;
+        }
+    }
+}
+
+// Deliver the result of hAPICall to pCallback
+void STEAM_Backend::RegisterCallResult(STEAM_CallbackBase *pCallback, SteamAPICall_t hAPICall)
+{
+    g_mapCallResults[hAPICall] = std::make_pair(pCallback, SDL_GetPerformanceCounter());
+
+    // Results that come back quickly shouldn't wait out the whole pump interval
+    STEAM_Pump::Wake();
+}
+
+// Drop whoever was waiting on hAPICall
+void STEAM_Backend::UnregisterCallResult(SteamAPICall_t hAPICall)
+{
+    g_mapCallResults.erase(hAPICall);
+}
+
+// Poll and deliver on this thread, for when STEAM_Pump isn't running
+void STEAM_Backend::RunCallbacks()
+{
+    std::vector<STEAM_Message_t> rgMessages;
+    Poll(rgMessages);
+    for (STEAM_Message_t &message : rgMessages)
+    {
+        Dispatch(message);
+    }
+}
+
+// Hand a polled message to whatever is waiting on it, on the game thread
+void STEAM_Backend::Dispatch(STEAM_Message_t &message)
+{
+    Uint64 unNow = SDL_GetPerformanceCounter();
+    addLatency(g_latencyHandoff, unNow - message.m_unPolledTicks);
+
+    if (message.m_hAPICall == k_uAPICallInvalid)
+    {
+        // Handlers may construct or destroy callbacks. Callbacks registered by a handler wait
+        // for the next message, and ones destroyed by a handler are skipped.
+        ++g_cCallbackDispatches;
+        size_t cCallbacks = g_rgCallbacks.size();
+        for (size_t i = 0; i < cCallbacks; ++i)
+        {
+            STEAM_CallbackBase *pCallback = g_rgCallbacks[i].second;
+            if (pCallback && g_rgCallbacks[i].first == message.m_iCallback)
+            {
+                pCallback->Run(message.m_rgubParam.data(), false);
+            }
+        }
+        if (--g_cCallbackDispatches == 0)
+        {
+            g_rgCallbacks.erase(std::remove_if(g_rgCallbacks.begin(), g_rgCallbacks.end(),
+                [](const std::pair<int, STEAM_CallbackBase *> &callback) { return callback.second == nullptr; }), g_rgCallbacks.end());
+        }
+        return;
+    }
+
+    auto it = g_mapCallResults.find(message.m_hAPICall);
+    if (it == g_mapCallResults.end())
+        return;
+
+    // Unregister before running so the handler can start another call
+    STEAM_CallbackBase *pCallback = it->second.first;
+    addLatency(g_latencyCallResult, unNow - it->second.second);
+    g_mapCallResults.erase(it);
+    pCallback->Run(message.m_rgubParam.data(), message.m_bIOFailure);
+}
+
+// Time from being polled to being dispatched, and from a call being made to its result
+// being dispatched
+void STEAM_Backend::GetLatency(STEAM_Latency_t *pHandoff, STEAM_Latency_t *pCallResult)
+{
+    *pHandoff = g_latencyHandoff;
+    *pCallResult = g_latencyCallResult;
+}
\ No newline at end of file
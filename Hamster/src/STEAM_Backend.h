@@ -0,0 +1,256 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Backend.h
+*/
+#pragma once
+#include "ULib.h"
+#include "../../Steam/steam_api.h"
+#include "../../Steam/isteamuserstats.h"
+#include "../../Steam/isteamfriends.h"
+#include "../../Steam/isteamuser.h"
+#include "../../Steam/isteamutils.h"
+#include "../../Steam/isteamremotestorage.h"
+#include "../../Steam/isteamnetworkingsockets.h"
+#include "../../Steam/isteaminput.h"
+#include "../../Steam/steam_api_common.h"
+#include <vector>
+
+// Receives a callback or call result from the active backend
+class STEAM_CallbackBase
+{
+public:
+    virtual ~STEAM_CallbackBase() {}
+    virtual void Run(void *pvParam, bool bIOFailure) = 0;
+};
+
+// A callback or call result copied out of the backend, so it can be handed from the thread
+// that polls the backend to the game thread
+struct STEAM_Message_t
+{
+    int m_iCallback;                 // k_iCallback of the param
+    SteamAPICall_t m_hAPICall;       // The finished call, k_uAPICallInvalid for a callback
+    bool m_bIOFailure;
+    Uint64 m_unPolledTicks;          // SDL_GetPerformanceCounter() when it was polled
+    std::vector<uint8> m_rgubParam;
+};
+
+// Dispatch latency in microseconds
+struct STEAM_Latency_t
+{
+    Uint32 m_cSamples;
+    double m_flTotalUS;
+    double m_flMaxUS;
+};
+
+// The part of ISteamUtils, ISteamFriends, ISteamUserStats, ISteamRemoteStorage,
+// ISteamNetworkingSockets and ISteamInput the game uses.
+// The game talks to Steam only through SteamBackend(), so the Steam client can be swapped
+// for STEAM_LocalBackend when testing offline. Callbacks and call results are delivered
+// to STEAM_Callback and STEAM_CallResult, which stand in for Valve's STEAM_CALLBACK and
+// CCallResult. Poll() may run on STEAM_Pump's thread and the ISteamInput calls on
+// STEAM_Input's thread, everything else runs on the game thread.
+class STEAM_Backend
+{
+public:
+    virtual ~STEAM_Backend() {}
+
+    // Start the backend, returns false if it can't be used
+    virtual bool Init() = 0;
+
+    // Stop the backend
+    virtual void Shutdown() = 0;
+
+    // Copy out the callbacks and call results that are ready. Called on STEAM_Pump's thread
+    // while it runs, so it must lock anything the other calls touch.
+    virtual void Poll(std::vector<STEAM_Message_t> &rgMessages) = 0;
+
+    // Poll and deliver on this thread, for when STEAM_Pump isn't running
+    void RunCallbacks();
+
+    // Work the backend does on the game thread, called once a frame by STEAM_Pump::Dispatch()
+    virtual void RunFrame() {}
+
+    // Name for the logs
+    virtual const char *GetName() = 0;
+
+    // True if the game has to quit because Steam is relaunching it
+    virtual bool RestartAppIfNecessary(uint32 unOwnAppID) { return false; }
+
+    // ISteamUtils. The image calls are made from STEAM_AvatarCache's worker thread.
+    virtual uint32 GetAppID() = 0;
+    virtual bool GetImageSize(int iImage, uint32 *pnWidth, uint32 *pnHeight) = 0;
+    virtual bool GetImageRGBA(int iImage, uint8 *pubDest, int nDestBufferSize) = 0;
+
+    // ISteamUser
+    virtual CSteamID GetSteamID() = 0;
+
+    // ISteamFriends
+    virtual const char *GetPersonaName() = 0;
+    virtual const char *GetFriendPersonaName(CSteamID steamIDFriend) = 0;
+    virtual int GetSmallFriendAvatar(CSteamID steamIDFriend) = 0;
+
+    // ISteamUserStats, stats and achievements
+    virtual bool RequestCurrentStats() = 0;
+    virtual bool GetStat(const char *pchName, int32 *pData) = 0;
+    virtual bool SetStat(const char *pchName, int32 nData) = 0;
+    virtual bool GetAchievement(const char *pchName, bool *pbAchieved) = 0;
+    virtual bool SetAchievement(const char *pchName) = 0;
+    virtual const char *GetAchievementDisplayAttribute(const char *pchName, const char *pchKey) = 0;
+    virtual bool StoreStats() = 0;
+    virtual bool ResetAllStats(bool bAchievementsToo) = 0;
+
+    // ISteamUserStats, leaderboards
+    virtual SteamAPICall_t FindLeaderboard(const char *pchLeaderboardName) = 0;
+    virtual const char *GetLeaderboardName(SteamLeaderboard_t hSteamLeaderboard) = 0;
+    virtual int GetLeaderboardEntryCount(SteamLeaderboard_t hSteamLeaderboard) = 0;
+    virtual SteamAPICall_t DownloadLeaderboardEntries(SteamLeaderboard_t hSteamLeaderboard, ELeaderboardDataRequest eLeaderboardDataRequest, int nRangeStart, int nRangeEnd) = 0;
+    virtual bool GetDownloadedLeaderboardEntry(SteamLeaderboardEntries_t hSteamLeaderboardEntries, int index, LeaderboardEntry_t *pLeaderboardEntry, int32 *pDetails, int cDetailsMax) = 0;
+    virtual SteamAPICall_t UploadLeaderboardScore(SteamLeaderboard_t hSteamLeaderboard, ELeaderboardUploadScoreMethod eLeaderboardUploadScoreMethod, int32 nScore, const int32 *pScoreDetails, int cScoreDetailsCount) = 0;
+
+    // ISteamRemoteStorage, Steam Cloud
+    virtual bool IsCloudEnabledForAccount() = 0;
+    virtual bool IsCloudEnabledForApp() = 0;
+    virtual bool FileExists(const char *pchFile) = 0;
+    virtual int32 GetFileSize(const char *pchFile) = 0;
+    virtual SteamAPICall_t FileWriteAsync(const char *pchFile, const void *pvData, uint32 cubData) = 0;
+    virtual SteamAPICall_t FileReadAsync(const char *pchFile, uint32 nOffset, uint32 cubToRead) = 0;
+    virtual bool FileReadAsyncComplete(SteamAPICall_t hReadCall, void *pvBuffer, uint32 cubToRead) = 0;
+
+    // ISteamNetworkingSockets, plain IP connections without config options. Connection
+    // changes are posted as SteamNetConnectionStatusChangedCallback_t.
+    virtual HSteamListenSocket CreateListenSocketIP(const SteamNetworkingIPAddr &localAddress) = 0;
+    virtual HSteamNetConnection ConnectByIPAddress(const SteamNetworkingIPAddr &address) = 0;
+    virtual EResult AcceptConnection(HSteamNetConnection hConn) = 0;
+    virtual bool CloseConnection(HSteamNetConnection hPeer, int nReason, const char *pszDebug, bool bEnableLinger) = 0;
+    virtual bool CloseListenSocket(HSteamListenSocket hSocket) = 0;
+    virtual EResult SendMessageToConnection(HSteamNetConnection hConn, const void *pData, uint32 cbData, int nSendFlags, int64 *pOutMessageNumber) = 0;
+    virtual int ReceiveMessagesOnConnection(HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages) = 0;
+
+    // ISteamInput, digital actions only. Init and Shutdown are prefixed to keep them apart
+    // from the backend's own.
+    virtual bool InputInit() = 0;
+    virtual bool InputShutdown() = 0;
+    virtual void InputRunFrame() = 0;
+    virtual int GetConnectedControllers(InputHandle_t *handlesOut) = 0;
+    virtual InputActionSetHandle_t GetActionSetHandle(const char *pszActionSetName) = 0;
+    virtual void ActivateActionSet(InputHandle_t inputHandle, InputActionSetHandle_t actionSetHandle) = 0;
+    virtual InputDigitalActionHandle_t GetDigitalActionHandle(const char *pszActionName) = 0;
+    virtual InputDigitalActionData_t GetDigitalActionData(InputHandle_t inputHandle, InputDigitalActionHandle_t digitalActionHandle) = 0;
+
+    // Make pBackend the one SteamBackend() returns, the caller keeps ownership
+    static void Select(STEAM_Backend *pBackend);
+
+    // Create the backend that talks to the Steam client
+    static STEAM_Backend *CreateSteamworks();
+
+    // Used by STEAM_Callback and STEAM_CallResult
+    static void RegisterCallback(STEAM_CallbackBase *pCallback, int iCallback);
+    static void UnregisterCallback(STEAM_CallbackBase *pCallback);
+    static void RegisterCallResult(STEAM_CallbackBase *pCallback, SteamAPICall_t hAPICall);
+    static void UnregisterCallResult(SteamAPICall_t hAPICall);
+
+    // Hand a polled message to whatever is waiting on it, on the game thread
+    static void Dispatch(STEAM_Message_t &message);
+
+    // Time from being polled to being dispatched, and from a call being made to its result
+    // being dispatched
+    static void GetLatency(STEAM_Latency_t *pHandoff, STEAM_Latency_t *pCallResult);
+};
+
+// The active backend, nullptr when the game runs without Steam
+STEAM_Backend *SteamBackend();
+
+// Calls pObj->*func whenever the backend posts a P callback, replaces STEAM_CALLBACK
+template<class T, class P>
+class STEAM_Callback : public STEAM_CallbackBase
+{
+public:
+    typedef void (T::*func_t)(P *);
+
+    STEAM_Callback(T *pObj, func_t func) : m_pObj(pObj), m_Func(func)
+    {
+        STEAM_Backend::RegisterCallback(this, P::k_iCallback);
+    }
+
+    ~STEAM_Callback()
+    {
+        STEAM_Backend::UnregisterCallback(this);
+    }
+
+    void Run(void *pvParam, bool) override
+    {
+        (m_pObj->*m_Func)(static_cast<P *>(pvParam));
+    }
+
+private:
+    STEAM_Callback(const STEAM_Callback &) = delete;
+    STEAM_Callback &operator=(const STEAM_Callback &) = delete;
+
+    T *m_pObj;
+    func_t m_Func;
+};
+
+// Calls pObj->*func once the API call it was Set() with finishes, replaces CCallResult
+template<class T, class P>
+class STEAM_CallResult : public STEAM_CallbackBase
+{
+public:
+    typedef void (T::*func_t)(P *, bool);
+
+    STEAM_CallResult() : m_hAPICall(k_uAPICallInvalid), m_pObj(nullptr), m_Func(nullptr) {}
+
+    ~STEAM_CallResult()
+    {
+        Cancel();
+    }
+
+    // Wait for hAPICall, replacing the call this was waiting on
+    void Set(SteamAPICall_t hAPICall, T *pObj, func_t func)
+    {
+        Cancel();
+        m_hAPICall = hAPICall;
+        m_pObj = pObj;
+        m_Func = func;
+        if (hAPICall != k_uAPICallInvalid)
+        {
+            STEAM_Backend::RegisterCallResult(this, hAPICall);
+        }
+    }
+
+    // True while waiting on a call
+    bool IsActive() const { return m_hAPICall != k_uAPICallInvalid; }
+
+    // Stop waiting, the result is dropped when it arrives
+    void Cancel()
+    {
+        if (m_hAPICall != k_uAPICallInvalid)
+        {
+            STEAM_Backend::UnregisterCallResult(m_hAPICall);
+            m_hAPICall = k_uAPICallInvalid;
+        }
+    }
+
+    void Run(void *pvParam, bool bIOFailure) override
+    {
+        // Clear the call first so the handler can Set() the next one
+        m_hAPICall = k_uAPICallInvalid;
+        (m_pObj->*m_Func)(static_cast<P *>(pvParam), bIOFailure);
+    }
+
+private:
+    STEAM_CallResult(const STEAM_CallResult &) = delete;
+    STEAM_CallResult &operator=(const STEAM_CallResult &) = delete;
+
+    SteamAPICall_t m_hAPICall;
+    T *m_pObj;
+    func_t m_Func;
+};
+
+// Declares a callback member and its handler, use like STEAM_CALLBACK and construct the
+// member with (this, &thisclass::func)
+#define STEAM_BACKEND_CALLBACK(thisclass, func, param, var) \
+    STEAM_Callback<thisclass, param> var;                   \
+    void func(param *pParam)
@@ -0,0 +1,190 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_CloudSave.cpp
+*/
+#include "STEAM_CloudSave.h"
+
+// Wait this long before trying a failed upload again
+#define CLOUD_SAVE_RETRY_MS 5000
+
+// Constructor
+STEAM_CloudSave::STEAM_CloudSave()
+    :
+    m_eState(k_ESyncOff),
+    m_bDownloadReady(false),
+    m_bWriting(false),
+    m_bPending(false),
+    m_unRetryTicks(0)
+{
+}
+
+// Start downloading the cloud copy of pchFile, returns without waiting
+void STEAM_CloudSave::init(const char *pchFile)
+{
+    m_sFile = pchFile;
+    m_eState = k_ESyncOff;
+
+    STEAM_Backend *pBackend = SteamBackend();
+    if (!pBackend || !pBackend->IsCloudEnabledForAccount() || !pBackend->IsCloudEnabledForApp())
+    {
+        ULOG_INFO(k_ELogSave, "Steam Cloud is off, %s stays local", pchFile);
+        return;
+    }
+
+    // Nothing to merge, the first upload creates it
+    if (!pBackend->FileExists(pchFile))
+    {
+        ULOG_INFO(k_ELogSave, "No cloud copy of %s yet", pchFile);
+        m_eState = k_ESyncReady;
+        return;
+    }
+
+    int32 cubFile = pBackend->GetFileSize(pchFile);
+    if (cubFile < 0 || cubFile > CLOUD_SAVE_MAX_BYTES)
+    {
+        ULOG_WARN(k_ELogSave, "Cloud copy of %s is %d bytes, leaving it alone", pchFile, cubFile);
+        return;
+    }
+
+    m_eState = k_ESyncDownloading;
+    if (!m_asyncCalls.Await<RemoteStorageFileReadAsyncComplete_t>(pBackend->FileReadAsync(pchFile, 0, static_cast<uint32>(cubFile)),
+        [this](RemoteStorageFileReadAsyncComplete_t *pResult, bool bIOFailure) { OnFileRead(pResult, bIOFailure); }, CLOUD_SAVE_TIMEOUT_MS))
+    {
+        ULOG_WARN(k_ELogSave, "Unable to start reading the cloud copy of %s", pchFile);
+        m_eState = k_ESyncOff;
+    }
+}
+
+// The downloaded cloud copy, true only the first time it's asked for after it arrives
+bool STEAM_CloudSave::TakeDownload(std::vector<uint8> &rgubData)
+{
+    if (!m_bDownloadReady)
+        return false;
+
+    rgubData.swap(m_rgubDownload);
+    m_rgubDownload.clear();
+    m_bDownloadReady = false;
+    return true;
+}
+
+// Upload the save if it differs from what the cloud copy will hold once the writes in flight
+// finish. Uploads wait for the download and for the game to merge it.
+void STEAM_CloudSave::Upload(const void *pvData, uint32 cubData)
+{
+    if (m_eState == k_ESyncOff)
+        return;
+
+    const std::vector<uint8> &rgubNewest = m_bPending ? m_rgubPending : m_bWriting ? m_rgubWriting : m_rgubCloud;
+    if (rgubNewest.size() != cubData || (cubData && memcmp(rgubNewest.data(), pvData, cubData) != 0))
+    {
+        const uint8 *pubData = static_cast<const uint8 *>(pvData);
+        m_rgubPending.assign(pubData, pubData + cubData);
+        m_bPending = true;
+    }
+
+    if (m_bPending && m_eState == k_ESyncReady && !m_bDownloadReady && !m_bWriting && static_cast<Sint32>(SDL_GetTicks() - m_unRetryTicks) >= 0)
+    {
+        Write();
+    }
+}
+
+// Send the waiting save without waiting for the write in flight
+void STEAM_CloudSave::Flush()
+{
+    if (!m_bPending || m_eState != k_ESyncReady || m_bDownloadReady)
+        return;
+
+    // Nobody will be around for the result
+    if (SteamBackend()->FileWriteAsync(m_sFile.c_str(), m_rgubPending.data(), static_cast<uint32>(m_rgubPending.size())) == k_uAPICallInvalid)
+    {
+        ULOG_WARN(k_ELogSave, "Unable to upload %s on the way out", m_sFile);
+    }
+    m_bPending = false;
+}
+
+// Drop the calls in flight
+void STEAM_CloudSave::free()
+{
+    m_asyncCalls.CancelAll();
+    m_eState = k_ESyncOff;
+    m_bWriting = false;
+    m_bPending = false;
+}
+
+// Called when the cloud copy has been read
+void STEAM_CloudSave::OnFileRead(RemoteStorageFileReadAsyncComplete_t *pResult, bool bIOFailure)
+{
+    if (bIOFailure || pResult->m_eResult != k_EResultOK)
+    {
+        ULOG_WARN(k_ELogSave, "Failed to read the cloud copy of %s, it stays local this session", m_sFile);
+        m_eState = k_ESyncOff;
+        return;
+    }
+
+    std::vector<uint8> rgubData(pResult->m_cubRead);
+    if (!SteamBackend()->FileReadAsyncComplete(pResult->m_hFileReadAsync, rgubData.data(), pResult->m_cubRead))
+    {
+        ULOG_WARN(k_ELogSave, "Failed to collect the cloud copy of %s, it stays local this session", m_sFile);
+        m_eState = k_ESyncOff;
+        return;
+    }
+
+    ULOG_INFO(k_ELogSave, "Downloaded the cloud copy of %s, %u bytes", m_sFile, pResult->m_cubRead);
+    m_rgubCloud = rgubData;
+    m_rgubDownload.swap(rgubData);
+    m_bDownloadReady = true;
+    m_eState = k_ESyncReady;
+
+    // A save that matches the cloud copy doesn't need to go anywhere
+    if (m_bPending && m_rgubPending == m_rgubCloud)
+    {
+        m_bPending = false;
+    }
+}
+
+// Called when an upload finishes
+void STEAM_CloudSave::OnFileWritten(RemoteStorageFileWriteAsyncComplete_t *pResult, bool bIOFailure)
+{
+    m_bWriting = false;
+    if (bIOFailure || pResult->m_eResult != k_EResultOK)
+    {
+        ULOG_WARN(k_ELogSave, "Failed to upload %s, trying again in %d ms", m_sFile, CLOUD_SAVE_RETRY_MS);
+        if (!m_bPending)
+        {
+            m_rgubPending.swap(m_rgubWriting);
+            m_bPending = true;
+        }
+        m_unRetryTicks = SDL_GetTicks() + CLOUD_SAVE_RETRY_MS;
+        return;
+    }
+
+    ULOG_DEBUG(k_ELogSave, "Uploaded %s, %u bytes", m_sFile, static_cast<uint32>(m_rgubWriting.size()));
+    m_rgubCloud.swap(m_rgubWriting);
+
+    // The save changed while it was uploading
+    if (m_bPending)
+    {
+        Write();
+    }
+}
+
+// Start uploading the waiting save
+void STEAM_CloudSave::Write()
+{
+    m_rgubWriting.swap(m_rgubPending);
+    m_bPending = false;
+
+    SteamAPICall_t hAPICall = SteamBackend()->FileWriteAsync(m_sFile.c_str(), m_rgubWriting.data(), static_cast<uint32>(m_rgubWriting.size()));
+    m_bWriting = m_asyncCalls.Await<RemoteStorageFileWriteAsyncComplete_t>(hAPICall,
+        [this](RemoteStorageFileWriteAsyncComplete_t *pResult, bool bIOFailure) { OnFileWritten(pResult, bIOFailure); }, CLOUD_SAVE_TIMEOUT_MS);
+    if (!m_bWriting)
+    {
+        ULOG_WARN(k_ELogSave, "Unable to start uploading %s, trying again in %d ms", m_sFile, CLOUD_SAVE_RETRY_MS);
+        m_rgubPending.swap(m_rgubWriting);
+        m_bPending = true;
+        m_unRetryTicks = SDL_GetTicks() + CLOUD_SAVE_RETRY_MS;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_CloudSave.h
+*/
+#pragma once
+#include "STEAM_Async.h"
+#include <string>
+
+// Reads and writes that take longer than this are given up on
+#define CLOUD_SAVE_TIMEOUT_MS 10000
+
+// Cloud copies bigger than this aren't downloaded
+#define CLOUD_SAVE_MAX_BYTES 4096
+
+// Keeps a copy of a save file in Steam Cloud without ever waiting on it. init() starts
+// downloading the cloud copy and returns straight away, the game picks it up with
+// TakeDownload() whenever it's ready to merge it. Upload() sends a save in the background when
+// it differs from the cloud copy, while a write is in flight only the newest save waits
+// behind it. Nothing is uploaded until the download finishes, so an old local save can't
+// overwrite a newer one from another machine. If Steam Cloud is off or the download fails the
+// save stays local for the session.
+class STEAM_CloudSave
+{
+public:
+    // Constructor
+    STEAM_CloudSave();
+
+    // Start downloading the cloud copy of pchFile, returns without waiting
+    void init(const char *pchFile);
+
+    // The downloaded cloud copy, true only the first time it's asked for after it arrives
+    bool TakeDownload(std::vector<uint8> &rgubData);
+
+    // Upload the save if it differs from the cloud copy
+    void Upload(const void *pvData, uint32 cubData);
+
+    // Send the waiting save without waiting for the write in flight, called when the game
+    // closes. Steam finishes the write on its own.
+    void Flush();
+
+    // Cloud IO in flight
+    bool IsBusy() const { return m_asyncCalls.GetPendingCount() > 0; }
+
+    // Drop the calls in flight
+    void free();
+
+private:
+    enum ESyncState
+    {
+        k_ESyncOff,            // Steam Cloud is off or the download failed, the save stays local
+        k_ESyncDownloading,    // Waiting on the cloud copy, uploads wait too
+        k_ESyncReady           // Uploads go out as the save changes
+    };
+
+    // Called when the cloud copy has been read
+    void OnFileRead(RemoteStorageFileReadAsyncComplete_t *pResult, bool bIOFailure);
+
+    // Called when an upload finishes
+    void OnFileWritten(RemoteStorageFileWriteAsyncComplete_t *pResult, bool bIOFailure);
+
+    // Start uploading the waiting save
+    void Write();
+
+    std::string m_sFile;
+    ESyncState m_eState;
+    STEAM_AsyncScope m_asyncCalls;
+
+    std::vector<uint8> m_rgubCloud;        // What the cloud copy holds as far as we know
+    std::vector<uint8> m_rgubDownload;     // Cloud copy waiting for TakeDownload()
+    bool m_bDownloadReady;
+    std::vector<uint8> m_rgubWriting;      // Save being uploaded
+    bool m_bWriting;
+    std::vector<uint8> m_rgubPending;      // Newest save waiting to be uploaded
+    bool m_bPending;
+    Uint32 m_unRetryTicks;                 // A failed upload isn't tried again before this
+};
\ No newline at end of file
@@ -0,0 +1,202 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Input.cpp
+*/
+#include "STEAM_Input.h"
+#include <chrono>
+
+namespace
+{
+    // The action set and its actions, as they're named in the game's Steam Input config
+    const char *const k_pchInputActionSet = "Hamster";
+    const char *const k_rgpchInputActionNames[k_EInputActionCount] = { "step", "turn", "climb", "menu" };
+}
+
+// Constructor
+STEAM_Input::STEAM_Input() :
+    m_bRunning(false),
+    m_bInitialized(false),
+    m_hActionSet(0),
+    m_unHead(0),
+    m_unTail(0),
+    m_cDropped(0),
+    m_cPresses(0),
+    m_cBatches(0),
+    m_cMaxBatch(0),
+    m_cRepeatedInFrame(0)
+{
+    memset(m_rghActions, 0, sizeof(m_rghActions));
+}
+
+// Destructor, stops the thread
+STEAM_Input::~STEAM_Input()
+{
+    free();
+}
+
+// Start Steam Input and the polling thread, false when Steam Input can't be started
+bool STEAM_Input::init()
+{
+    STEAM_Backend *pBackend = SteamBackend();
+    if (!pBackend || !pBackend->InputInit())
+    {
+        ULOG_WARN(k_ELogSteam, "Steam Input couldn't be started, controllers won't work");
+        return false;
+    }
+    m_bInitialized = true;
+
+    // The handles stay 0 until Steam has loaded the game's config, Run() asks again until then
+    m_hActionSet = pBackend->GetActionSetHandle(k_pchInputActionSet);
+    for (int i = 0; i < k_EInputActionCount; ++i)
+    {
+        m_rghActions[i] = pBackend->GetDigitalActionHandle(k_rgpchInputActionNames[i]);
+    }
+
+    m_bRunning = true;
+    m_thread = std::thread(&STEAM_Input::Run, this);
+    return true;
+}
+
+// Move the presses made since the last call into rgPresses, oldest first
+void STEAM_Input::TakePresses(std::vector<STEAM_InputPress_t> &rgPresses)
+{
+    Uint32 unTail = m_unTail.load(std::memory_order_relaxed);
+    const Uint32 unHead = m_unHead.load(std::memory_order_acquire);
+    if (unTail == unHead)
+        return;
+
+    Uint32 cBatch = unHead - unTail;
+    m_cPresses += cBatch;
+    m_cMaxBatch = SDL_max(m_cMaxBatch, cBatch);
+    ++m_cBatches;
+
+    bool rgbPressed[k_EInputActionCount] = {};
+    for (; unTail != unHead; ++unTail)
+    {
+        const STEAM_InputPress_t &press = m_rgRing[unTail & (STEAM_INPUT_CAPACITY - 1)];
+        if (rgbPressed[press.m_eAction])
+        {
+            ++m_cRepeatedInFrame;
+        }
+        rgbPressed[press.m_eAction] = true;
+        rgPresses.push_back(press);
+    }
+    m_unTail.store(unTail, std::memory_order_release);
+}
+
+// Stop polling, shut Steam Input down and log how the presses arrived
+void STEAM_Input::free()
+{
+    if (m_thread.joinable())
+    {
+        m_bRunning = false;
+        m_thread.join();
+    }
+
+    if (m_bInitialized)
+    {
+        if (SteamBackend())
+        {
+            SteamBackend()->InputShutdown();
+        }
+        m_bInitialized = false;
+
+        ULOG_INFO(k_ELogSteam, "Steam Input: %u presses in %u frames, at most %u in one frame, %u more than once in a frame, %u dropped",
+            m_cPresses, m_cBatches, m_cMaxBatch, m_cRepeatedInFrame, m_cDropped.load());
+    }
+}
+
+// Poll the controllers until free()
+void STEAM_Input::Run()
+{
+    STEAM_Backend *pBackend = SteamBackend();
+    InputHandle_t rghControllers[STEAM_INPUT_MAX_COUNT] = {};
+    bool rgbDown[STEAM_INPUT_MAX_COUNT][k_EInputActionCount] = {};
+    int cControllers = 0;
+    Uint32 unNextScanTicks = SDL_GetTicks();
+
+    while (m_bRunning.load())
+    {
+        pBackend->InputRunFrame();
+
+        // Controllers come and go, and the handles are 0 until Steam has loaded the config
+        if (static_cast<Sint32>(SDL_GetTicks() - unNextScanTicks) >= 0)
+        {
+            if (!m_hActionSet)
+            {
+                m_hActionSet = pBackend->GetActionSetHandle(k_pchInputActionSet);
+            }
+            for (int i = 0; i < k_EInputActionCount; ++i)
+            {
+                if (!m_rghActions[i])
+                {
+                    m_rghActions[i] = pBackend->GetDigitalActionHandle(k_rgpchInputActionNames[i]);
+                }
+            }
+
+            // A button already held when its controller shows up doesn't count as a press
+            InputHandle_t rghFound[STEAM_INPUT_MAX_COUNT];
+            int cFound = pBackend->GetConnectedControllers(rghFound);
+            for (int i = 0; i < cFound; ++i)
+            {
+                if (i >= cControllers || rghFound[i] != rghControllers[i])
+                {
+                    ULOG_INFO(k_ELogSteam, "Steam Input controller %d connected", i);
+                    rghControllers[i] = rghFound[i];
+                    for (int iAction = 0; iAction < k_EInputActionCount; ++iAction)
+                    {
+                        rgbDown[i][iAction] = true;
+                    }
+                }
+                if (m_hActionSet)
+                {
+                    pBackend->ActivateActionSet(rghControllers[i], m_hActionSet);
+                }
+            }
+            cControllers = cFound;
+            unNextScanTicks = SDL_GetTicks() + STEAM_INPUT_RESCAN_MS;
+        }
+
+        // Every button that went down since the last poll is a press
+        Uint64 ulNow = SDL_GetPerformanceCounter();
+        for (int i = 0; i < cControllers; ++i)
+        {
+            for (int iAction = 0; iAction < k_EInputActionCount; ++iAction)
+            {
+                if (!m_rghActions[iAction])
+                    continue;
+
+                InputDigitalActionData_t data = pBackend->GetDigitalActionData(rghControllers[i], m_rghActions[iAction]);
+                bool bDown = data.bActive && data.bState;
+                if (bDown && !rgbDown[i][iAction])
+                {
+                    STEAM_InputPress_t press;
+                    press.m_eAction = static_cast<EInputAction>(iAction);
+                    press.m_hController = rghControllers[i];
+                    press.m_ulTimestamp = ulNow;
+                    Push(press);
+                }
+                rgbDown[i][iAction] = bDown;
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(STEAM_INPUT_POLL_US));
+    }
+}
+
+// Hand a press to the game thread, dropped when the game thread has fallen far behind
+void STEAM_Input::Push(const STEAM_InputPress_t &press)
+{
+    Uint32 unHead = m_unHead.load(std::memory_order_relaxed);
+    if (unHead - m_unTail.load(std::memory_order_acquire) >= STEAM_INPUT_CAPACITY)
+    {
+        ++m_cDropped;
+        return;
+    }
+
+    m_rgRing[unHead & (STEAM_INPUT_CAPACITY - 1)] = press;
+    m_unHead.store(unHead + 1, std::memory_order_release);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Input.h
+*/
+#pragma once
+#include "STEAM_Backend.h"
+#include <atomic>
+#include <thread>
+
+// How often the controllers are read, a press has to be held this long to be seen
+#define STEAM_INPUT_POLL_US 1000
+
+// How often the list of connected controllers is refreshed
+#define STEAM_INPUT_RESCAN_MS 1000
+
+// Presses that can wait for the game thread, must be a power of two
+#define STEAM_INPUT_CAPACITY 256
+
+// The actions in the "Hamster" action set, named in k_rgpchInputActionNames
+enum EInputAction
+{
+    k_EInputActionStep,        // Take a step, or turn the wheel
+    k_EInputActionTurn,        // Walk the other way
+    k_EInputActionClimb,       // Climb onto or off the wheel
+    k_EInputActionMenu,        // Open or close the settings menu
+    k_EInputActionCount
+};
+
+// A controller button going down
+struct STEAM_InputPress_t
+{
+    EInputAction m_eAction;
+    InputHandle_t m_hController;
+    Uint64 m_ulTimestamp;          // SDL_GetPerformanceCounter() when it was seen
+};
+
+// Reads the Steam Input digital actions on a thread of its own every STEAM_INPUT_POLL_US,
+// instead of once a frame, and turns each button going down into a timestamped press. The
+// game thread takes the presses in a batch each frame, so a mash of several presses inside
+// one frame counts every one of them, and each press knows when in the frame it happened.
+class STEAM_Input
+{
+public:
+    // Constructor
+    STEAM_Input();
+
+    // Destructor, stops the thread
+    ~STEAM_Input();
+
+    // Start Steam Input and the polling thread, false when Steam Input can't be started
+    bool init();
+
+    // Move the presses made since the last call into rgPresses, oldest first
+    void TakePresses(std::vector<STEAM_InputPress_t> &rgPresses);
+
+    // Stop polling, shut Steam Input down and log how the presses arrived
+    void free();
+
+private:
+    STEAM_Input(const STEAM_Input &) = delete;
+    STEAM_Input &operator=(const STEAM_Input &) = delete;
+
+    // Poll the controllers until free()
+    void Run();
+
+    // Hand a press to the game thread, dropped when the game thread has fallen far behind
+    void Push(const STEAM_InputPress_t &press);
+
+    std::thread m_thread;
+    std::atomic<bool> m_bRunning;
+    bool m_bInitialized;
+
+    InputActionSetHandle_t m_hActionSet;
+    InputDigitalActionHandle_t m_rghActions[k_EInputActionCount];
+
+    // Single producer, single consumer ring. The input thread owns m_unHead and the game
+    // thread owns m_unTail.
+    STEAM_InputPress_t m_rgRing[STEAM_INPUT_CAPACITY];
+    std::atomic<Uint32> m_unHead;
+    std::atomic<Uint32> m_unTail;
+
+    // Statistics for the log
+    std::atomic<Uint32> m_cDropped;
+    Uint32 m_cPresses;             // Presses taken by the game thread
+    Uint32 m_cBatches;             // TakePresses() calls that had presses
+    Uint32 m_cMaxBatch;            // Most presses taken at once
+    Uint32 m_cRepeatedInFrame;     // Presses of an action already pressed in the same batch,
+                                   // the ones polling once a frame would have lost
+};
\ No newline at end of file
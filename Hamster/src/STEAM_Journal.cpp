@@ -0,0 +1,350 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Journal.cpp
+*/
+#include "STEAM_Journal.h"
+#include <cstdio>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <share.h>
+#else
+#include <unistd.h>
+#endif
+
+// Appends are written and synced at most this often
+#define JOURNAL_FLUSH_MS 1000
+
+namespace
+{
+    // Kinds of journal entries, the names are what's written to the file
+    enum EJournalEntry
+    {
+        k_EJournalStat,         // "stat <name> <delta>", a stat went up by delta
+        k_EJournalTarget,       // "target <name> <value>", value was sent with StoreStats()
+        k_EJournalAchievement,  // "ach <name> 0", an achievement was unlocked
+        k_EJournalScore,        // "score <leaderboard> <score>", a score to upload
+        k_EJournalStore         // Marks a StoreStats() call on the way, never written
+    };
+
+    const char *const k_rgpchEntryNames[] = { "stat", "target", "ach", "score" };
+
+    struct JournalEntry_t
+    {
+        EJournalEntry m_eType;
+        std::string m_sName;
+        int32 m_nValue;
+    };
+
+    std::string g_sPath;                    // Journal file, empty while closed
+    std::vector<JournalEntry_t> g_rgEntries; // Every live entry in the order they were added
+    std::string g_sPending;                 // Lines added since the last flush
+    bool g_bCompact = false;                // Settled entries were dropped, rewrite the file
+    Uint32 g_unLastFlushTicks = 0;
+
+    // Raw file output so the journal can be synced to disk
+    int openRaw(const char *aPath, bool aAppend)
+    {
+        int flags = aAppend ? O_APPEND : O_TRUNC;
+#ifdef _WIN32
+        int fd = -1;
+        _sopen_s(&fd, aPath, _O_WRONLY | _O_CREAT | _O_BINARY | flags, _SH_DENYNO, _S_IREAD | _S_IWRITE);
+        return fd;
+#else
+        return open(aPath, O_WRONLY | O_CREAT | flags, 0644);
+#endif
+    }
+
+    // Write and sync aData, then close the file
+    bool writeAndSync(int aFd, const std::string &aData)
+    {
+#ifdef _WIN32
+        bool success = _write(aFd, aData.data(), static_cast<unsigned int>(aData.size())) == static_cast<int>(aData.size());
+        success = _commit(aFd) == 0 && success;
+        _close(aFd);
+#else
+        bool success = write(aFd, aData.data(), aData.size()) == static_cast<ssize_t>(aData.size());
+        success = fsync(aFd) == 0 && success;
+        close(aFd);
+#endif
+        return success;
+    }
+
+    // Add an entry and queue its line for the next flush
+    void add(EJournalEntry aType, const std::string &aName, int32 aValue)
+    {
+        JournalEntry_t entry;
+        entry.m_eType = aType;
+        entry.m_sName = aName;
+        entry.m_nValue = aValue;
+        g_rgEntries.push_back(entry);
+
+        if (aType != k_EJournalStore)
+        {
+            g_sPending += std::string(k_rgpchEntryNames[aType]) + " " + aName + " " + std::to_string(aValue) + "\n";
+        }
+    }
+
+    // Read the entries in aPath, false if it couldn't be opened
+    bool load(const std::string &aPath)
+    {
+        SDL_RWops *file = SDL_RWFromFile(aPath.c_str(), "rb");
+        if (!file)
+            return false;
+
+        std::string contents(static_cast<size_t>(MAX(SDL_RWsize(file), 0)), '\0');
+        if (!contents.empty())
+        {
+            contents.resize(SDL_RWread(file, &contents[0], 1, contents.size()));
+        }
+        SDL_RWclose(file);
+
+        // A line without its newline was cut off by a crash, skip it
+        std::istringstream lines(contents.substr(0, contents.rfind('\n') + 1));
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            std::istringstream fields(line);
+            std::string type;
+            JournalEntry_t entry;
+            if (!(fields >> type >> entry.m_sName >> entry.m_nValue))
+                continue;
+
+            for (int i = 0; i < k_EJournalStore; ++i)
+            {
+                if (type == k_rgpchEntryNames[i])
+                {
+                    entry.m_eType = static_cast<EJournalEntry>(i);
+                    g_rgEntries.push_back(entry);
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+// Load the journal at pchPath, entries added from now on are appended to it
+bool STEAM_Journal::Open(const char *pchPath)
+{
+    Close();
+    g_rgEntries.clear();
+    g_sPending.clear();
+    g_sPath = pchPath;
+
+    // A crash while compacting can leave only the new file
+    std::string tmpPath = g_sPath + ".tmp";
+    if (load(g_sPath))
+    {
+        std::remove(tmpPath.c_str());
+    }
+    else if (load(tmpPath))
+    {
+        g_bCompact = true;
+    }
+
+    ULOG_INFO(k_ELogSteam, "Steam journal %s has %u entries to replay", pchPath, static_cast<unsigned>(g_rgEntries.size()));
+    g_unLastFlushTicks = SDL_GetTicks();
+    return true;
+}
+
+// Write everything out and close the journal
+void STEAM_Journal::Close()
+{
+    if (g_sPath.empty())
+        return;
+
+    Flush(true);
+    g_sPath.clear();
+}
+
+// Record a stat that went up by nDelta
+void STEAM_Journal::AddStat(const char *pchName, int32 nDelta)
+{
+    if (nDelta)
+    {
+        add(k_EJournalStat, pchName, nDelta);
+    }
+}
+
+// Record an unlocked achievement
+void STEAM_Journal::AddAchievement(const char *pchName)
+{
+    add(k_EJournalAchievement, pchName, 0);
+}
+
+// Record a score to upload
+void STEAM_Journal::AddScore(const char *pchLeaderboard, int32 nScore)
+{
+    add(k_EJournalScore, pchLeaderboard, nScore);
+}
+
+// Fold the journal into a stat value just received from Steam. The last value sent with
+// StoreStats() may or may not have reached Steam, counters only grow so the larger of the two
+// is right, then the deltas since are added on top.
+int32 STEAM_Journal::ApplyStat(const char *pchName, int32 nSteamValue)
+{
+    int32 nValue = nSteamValue;
+    for (const JournalEntry_t &entry : g_rgEntries)
+    {
+        if (entry.m_sName != pchName)
+            continue;
+
+        if (entry.m_eType == k_EJournalTarget)
+        {
+            nValue = MAX(nSteamValue, entry.m_nValue);
+        }
+        else if (entry.m_eType == k_EJournalStat)
+        {
+            nValue += entry.m_nValue;
+        }
+    }
+    return nValue;
+}
+
+// True if there are stat deltas or achievements Steam hasn't confirmed
+bool STEAM_Journal::HasStatsPending()
+{
+    for (const JournalEntry_t &entry : g_rgEntries)
+    {
+        if (entry.m_eType == k_EJournalStat || entry.m_eType == k_EJournalTarget || entry.m_eType == k_EJournalAchievement)
+            return true;
+    }
+    return false;
+}
+
+// Achievements Steam hasn't confirmed
+void STEAM_Journal::GetAchievements(std::vector<std::string> &rgAchievements)
+{
+    for (const JournalEntry_t &entry : g_rgEntries)
+    {
+        if (entry.m_eType == k_EJournalAchievement)
+        {
+            rgAchievements.push_back(entry.m_sName);
+        }
+    }
+}
+
+// Best score waiting to be uploaded to pchLeaderboard, false if there isn't one
+bool STEAM_Journal::GetBestScore(const char *pchLeaderboard, int32 *pnScore)
+{
+    bool bFound = false;
+    for (const JournalEntry_t &entry : g_rgEntries)
+    {
+        if (entry.m_eType == k_EJournalScore && entry.m_sName == pchLeaderboard && (!bFound || entry.m_nValue > *pnScore))
+        {
+            *pnScore = entry.m_nValue;
+            bFound = true;
+        }
+    }
+    return bFound;
+}
+
+// Record the absolute stat values about to be sent with StoreStats()
+void STEAM_Journal::BeginStore(const char *const *rgpchNames, const int32 *rgnValues, int cStats)
+{
+    for (int i = 0; i < cStats; ++i)
+    {
+        add(k_EJournalTarget, rgpchNames[i], rgnValues[i]);
+    }
+    add(k_EJournalStore, "", 0);
+}
+
+// The oldest StoreStats() finished. If it succeeded Steam has every stat and achievement
+// recorded before it, so those entries are dropped.
+void STEAM_Journal::EndStore(bool bSuccess)
+{
+    for (size_t i = 0; i < g_rgEntries.size(); ++i)
+    {
+        if (g_rgEntries[i].m_eType != k_EJournalStore)
+            continue;
+
+        if (!bSuccess)
+        {
+            g_rgEntries.erase(g_rgEntries.begin() + i);
+            return;
+        }
+
+        // Scores are settled by their own uploads
+        std::vector<JournalEntry_t> rgEntries;
+        for (size_t j = 0; j < g_rgEntries.size(); ++j)
+        {
+            if (j > i || g_rgEntries[j].m_eType == k_EJournalScore)
+            {
+                rgEntries.push_back(g_rgEntries[j]);
+            }
+        }
+        g_rgEntries.swap(rgEntries);
+        g_bCompact = true;
+        return;
+    }
+}
+
+// Steam accepted nScore on pchLeaderboard, drop the scores it beats
+void STEAM_Journal::RemoveScores(const char *pchLeaderboard, int32 nScore)
+{
+    for (size_t i = 0; i < g_rgEntries.size();)
+    {
+        const JournalEntry_t &entry = g_rgEntries[i];
+        if (entry.m_eType == k_EJournalScore && entry.m_sName == pchLeaderboard && entry.m_nValue <= nScore)
+        {
+            g_rgEntries.erase(g_rgEntries.begin() + i);
+            g_bCompact = true;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+// Write out pending entries, when bForce is false this only happens once every JOURNAL_FLUSH_MS
+void STEAM_Journal::Flush(bool bForce)
+{
+    if (g_sPath.empty() || (g_sPending.empty() && !g_bCompact))
+        return;
+
+    if (!bForce && SDL_GetTicks() - g_unLastFlushTicks < JOURNAL_FLUSH_MS)
+        return;
+
+    g_unLastFlushTicks = SDL_GetTicks();
+    if (g_bCompact)
+    {
+        // Write the live entries to a new file and swap it in
+        std::string contents;
+        for (const JournalEntry_t &entry : g_rgEntries)
+        {
+            if (entry.m_eType != k_EJournalStore)
+            {
+                contents += std::string(k_rgpchEntryNames[entry.m_eType]) + " " + entry.m_sName + " " + std::to_string(entry.m_nValue) + "\n";
+            }
+        }
+
+        std::string tmpPath = g_sPath + ".tmp";
+        int fd = openRaw(tmpPath.c_str(), false);
+        if (fd < 0 || !writeAndSync(fd, contents))
+        {
+            ULOG_ERROR(k_ELogSteam, "Failed to compact the Steam journal %s", tmpPath.c_str());
+            return;
+        }
+        std::remove(g_sPath.c_str());
+        std::rename(tmpPath.c_str(), g_sPath.c_str());
+
+        g_bCompact = false;
+        g_sPending.clear();
+        return;
+    }
+
+    int fd = openRaw(g_sPath.c_str(), true);
+    if (fd < 0 || !writeAndSync(fd, g_sPending))
+    {
+        ULOG_ERROR(k_ELogSteam, "Failed to write the Steam journal %s", g_sPath.c_str());
+        return;
+    }
+    g_sPending.clear();
+}
\ No newline at end of file
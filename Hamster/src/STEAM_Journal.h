@@ -0,0 +1,57 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Journal.h
+*/
+#pragma once
+#include "ULib.h"
+#include "../../Steam/steam_api_common.h"
+
+// Append only journal of everything the game still owes Steam: stat deltas, achievement
+// unlocks and leaderboard scores. Entries survive Steam being offline and the game exiting,
+// and are replayed the next time stats arrive or a leaderboard handle is found. Replaying is
+// idempotent, stats are rebuilt from the last values sent to Steam (counters only grow) plus
+// the deltas since, achievements are unlocked again and scores are resent to keep-best
+// leaderboards. Appends are written and synced to disk at most once every JOURNAL_FLUSH_MS,
+// and the file is rewritten without the settled entries once Steam confirms them.
+class STEAM_Journal
+{
+public:
+    // Load the journal at pchPath, entries added from now on are appended to it
+    static bool Open(const char *pchPath);
+
+    // Write everything out and close the journal
+    static void Close();
+
+    // Record work Steam hasn't confirmed yet
+    static void AddStat(const char *pchName, int32 nDelta);
+    static void AddAchievement(const char *pchName);
+    static void AddScore(const char *pchLeaderboard, int32 nScore);
+
+    // Fold the journal into a stat value just received from Steam
+    static int32 ApplyStat(const char *pchName, int32 nSteamValue);
+
+    // True if there are stat deltas or achievements Steam hasn't confirmed
+    static bool HasStatsPending();
+
+    // Achievements Steam hasn't confirmed
+    static void GetAchievements(std::vector<std::string> &rgAchievements);
+
+    // Best score waiting to be uploaded to pchLeaderboard, false if there isn't one
+    static bool GetBestScore(const char *pchLeaderboard, int32 *pnScore);
+
+    // Record the absolute stat values about to be sent with StoreStats()
+    static void BeginStore(const char *const *rgpchNames, const int32 *rgnValues, int cStats);
+
+    // The oldest StoreStats() finished, bSuccess is true if Steam has the values now
+    static void EndStore(bool bSuccess);
+
+    // Steam accepted nScore on pchLeaderboard, drop the scores it beats
+    static void RemoveScores(const char *pchLeaderboard, int32 nScore);
+
+    // Write out pending entries, when bForce is false this only happens once every
+    // JOURNAL_FLUSH_MS
+    static void Flush(bool bForce);
+};
\ No newline at end of file
@@ -6,34 +6,74 @@
 * File: Hamster STEAM_Leaderbaords.cpp
 */
 #include "STEAM_Leaderboards.h"
+#include "STEAM_Async.h"
+#include "STEAM_AvatarCache.h"
+#include "STEAM_Journal.h"
+#include "STEAM_PersonaCache.h"
+#include "STEAM_ScoreDetails.h"
 #include "cassert"
+#include <map>
 
 // Leaderboard names
 #define LEADERBOARD_FASTEST_RUN "FastestRun"
 #define LEADERBOARD_LONGEST_DISTANCE "TotalLoops"
 
+// Leaderboard names, indexed by ELeaderboard
+static const char *k_rgpchLeaderboardNames[k_ELeaderboardCount] =
+{
+    LEADERBOARD_FASTEST_RUN,
+    LEADERBOARD_LONGEST_DISTANCE
+};
+
+// Cached leaderboard entries are downloaded again once they're this old
+#define LEADERBOARD_CACHE_TTL_MS 60000
+
+// Downloads that take longer than this fail and are retried the next time the page is needed
+#define LEADERBOARD_DOWNLOAD_TIMEOUT_MS 10000
+
+// Rows scrolled by a notch of the mouse wheel, and by page up / page down
+#define LEADERBOARD_WHEEL_ROWS 3
+#define LEADERBOARD_PAGE_ROWS 10
+
+// Rows are this far apart
+#define LEADERBOARD_ROW_HEIGHT 40
+
+// Avatars are drawn this many pixels square, left of the names
+#define LEADERBOARD_AVATAR_SIZE 24
+
+// Pace graphs are drawn right of the scores this many pixels wide and tall, a second of the
+// run with LEADERBOARD_PACE_MAX_KEYS keystrokes or more reaches the top
+#define LEADERBOARD_PACE_WIDTH 34
+#define LEADERBOARD_PACE_HEIGHT 20
+#define LEADERBOARD_PACE_MAX_KEYS 15
+
+// A failed upload is retried after this long, doubling each time it fails again up to the max
+#define LEADERBOARD_UPLOAD_RETRY_MS 1000
+#define LEADERBOARD_UPLOAD_RETRY_MAX_MS 60000
+
 // Metadata about leaderboard entries
 struct LeaderboardEntry
 {
     ELeaderboardEntryOption m_eOption;
-    std::string m_name;
+    uint64 m_ulSteamID;
     int32 m_nScore;
     int32 m_nGlobalRank;
+    std::vector<int32> m_rgnSplits;    // Keystrokes in each second of the run, empty if the score has none
 
     // Default Constructor
     LeaderboardEntry()
     {
         m_eOption = ELeaderboardEntryOption::k_EInvalid;
-        m_name = "";
+        m_ulSteamID = 0;
         m_nScore = 0;
         m_nGlobalRank = 0;
     }
 
     // Construct a valid leaderboard entry
-    LeaderboardEntry(std::string a_name, int32 a_nScore, int32 a_nGlobalRank)
+    LeaderboardEntry(CSteamID a_steamID, int32 a_nScore, int32 a_nGlobalRank)
     {
         m_eOption = ELeaderboardEntryOption::k_EValid;
-        m_name = a_name;
+        m_ulSteamID = a_steamID.ConvertToUint64();
         m_nScore = a_nScore;
         m_nGlobalRank = a_nGlobalRank;
     } 
@@ -42,32 +82,202 @@ struct LeaderboardEntry
     LeaderboardEntry(ELeaderboardEntryOption a_eOption)
     {
         m_eOption = a_eOption;
-        m_name = "";
+        m_ulSteamID = 0;
         m_nScore = 0;
         m_nGlobalRank = 0;
     }
+
+    // Entries are equal if they draw the same row
+    bool operator==(const LeaderboardEntry &a_other) const
+    {
+        return m_eOption == a_other.m_eOption && m_nScore == a_other.m_nScore && m_nGlobalRank == a_other.m_nGlobalRank && m_ulSteamID == a_other.m_ulSteamID && m_rgnSplits == a_other.m_rgnSplits;
+    }
 };
 
 // Menu that shows a leaderboard
 class STEAM_LeaderboardMenu
 {
-    static const int k_nMaxLeaderboardEntries = 11;		// maximum number of leaderboard entries we can display
-    std::vector<LeaderboardEntry> m_leaderboardEntries;	// leaderboard entries we received from DownloadLeaderboardEntries
-    LeaderboardEntry* m_usersEntry;                     // The current user's leaderboard entry
-    int m_nLeaderboardEntries;							// number of leaderboard entries we received
+    static const int k_nMaxLeaderboardEntries = 10;		// rows on screen, also the number of entries in a page
+    static const int k_nUserPage = -1;					// page that holds the user's entry
+    static const int k_nPagesKept = 2;					// pages kept either side of the visible ones
+
+    // The last download of one page of a leaderboard, or of the user's entry. The menu shows
+    // it straight away and refreshes it in the background once it's older than
+    // LEADERBOARD_CACHE_TTL_MS.
+    class LeaderboardCache
+    {
+    public:
+        SteamLeaderboard_t m_hSteamLeaderboard;		// leaderboard the entries are from
+        int m_nPage;								// page n holds ranks n * k_nMaxLeaderboardEntries + 1 on, or k_nUserPage
+        std::vector<LeaderboardEntry> m_entries;	// the page's entries, or the user's entry if they have one
+        bool m_bHasData;							// m_entries holds a download
+        bool m_bIOFailure;							// the last refresh failed
+        bool m_bInvalidated;						// the user's score changed since the last download
+        bool m_bRefreshing;							// a download is on the way
+        Uint32 m_unFetchedTicks;					// when the last download arrived
+
+        // Constructor
+        LeaderboardCache()
+        {
+            m_hSteamLeaderboard = 0;
+            m_nPage = 0;
+            m_bHasData = false;
+            m_bIOFailure = false;
+            m_bInvalidated = false;
+            m_bRefreshing = false;
+            m_unFetchedTicks = 0;
+            m_pMenu = nullptr;
+        }
+
+        // Set which leaderboard and page this caches
+        void init(STEAM_LeaderboardMenu *a_pMenu, SteamLeaderboard_t a_hLeaderboard, int a_nPage)
+        {
+            m_pMenu = a_pMenu;
+            m_hSteamLeaderboard = a_hLeaderboard;
+            m_nPage = a_nPage;
+        }
+
+        // True if the entries should be downloaded again
+        bool IsStale() const
+        {
+            return !m_bHasData || m_bIOFailure || m_bInvalidated || SDL_GetTicks() - m_unFetchedTicks >= LEADERBOARD_CACHE_TTL_MS;
+        }
+
+        // Download the entries again, unless a download is already on the way. The download
+        // is awaited by the menu, so the page can be dropped while it's on the way.
+        void Refresh()
+        {
+            if (m_bRefreshing || !SteamBackend())
+                return;
+
+            // load a page of the global leaderboard, or the entries either side of the current user
+            SteamAPICall_t hSteamAPICall;
+            if (m_nPage != k_nUserPage)
+            {
+                int nFirstRank = m_nPage * k_nMaxLeaderboardEntries + 1;
+                hSteamAPICall = SteamBackend()->DownloadLeaderboardEntries(m_hSteamLeaderboard, k_ELeaderboardDataRequestGlobal, nFirstRank, nFirstRank + k_nMaxLeaderboardEntries - 1);
+            }
+            else
+            {
+                hSteamAPICall = SteamBackend()->DownloadLeaderboardEntries(m_hSteamLeaderboard, k_ELeaderboardDataRequestGlobalAroundUser, -1, 1);
+            }
+            UFlightRecorder::recordSteamCall(k_EFlightDownloadEntries, hSteamAPICall);
+
+            // Wait for the result, it goes to whichever cache holds this page when it arrives
+            STEAM_LeaderboardMenu *pMenu = m_pMenu;
+            std::pair<SteamLeaderboard_t, int> key(m_hSteamLeaderboard, m_nPage);
+            m_bRefreshing = pMenu->m_asyncCalls.Await<LeaderboardScoresDownloaded_t>(hSteamAPICall,
+                [pMenu, key](LeaderboardScoresDownloaded_t *pLeaderboardScoresDownloaded, bool bIOFailure)
+                {
+                    auto it = pMenu->m_mapCache.find(key);
+                    if (it != pMenu->m_mapCache.end())
+                    {
+                        it->second.OnLeaderboardDownloadedEntries(pLeaderboardScoresDownloaded, bIOFailure);
+                    }
+                }, LEADERBOARD_DOWNLOAD_TIMEOUT_MS);
+        }
+
+        // True while a download is on the way
+        bool IsRefreshing() const { return m_bRefreshing; }
+
+    private:
+        // Called when SteamBackend()->DownloadLeaderboardEntries() returns asynchronously, or
+        // times out
+        void OnLeaderboardDownloadedEntries(LeaderboardScoresDownloaded_t* pLeaderboardScoresDownloaded, bool bIOFailure)
+        {
+            m_bRefreshing = false;
+            LeaderboardEntry_t tmpLdBdEntry;
+            int32 rgnDetails[k_cLeaderboardDetailsMax];
+            int32 rgnSplits[SCORE_DETAILS_MAX_SPLITS];
+            UFlightRecorder::recordSteamCallback(k_EFlightDownloadEntries, !bIOFailure, pLeaderboardScoresDownloaded->m_hSteamLeaderboard);
+
+            // Keep showing the old entries if there are any
+            m_bIOFailure = bIOFailure;
+            if (bIOFailure)
+            {
+                ULOG_WARN(k_ELogSteam, "DownloadLeaderboardEntries failed%s", m_bHasData ? ", showing the cached entries" : "");
+                m_pMenu->OnCacheUpdated(*this);
+                return;
+            }
+
+            const CSteamID steamIDUser = SteamBackend()->GetSteamID();
+
+            // leaderboard entries handle will be invalid once we return from this function. Copy all data now.
+            std::vector<LeaderboardEntry> entries;
+            int nLeaderboardEntries = MIN(pLeaderboardScoresDownloaded->m_cEntryCount, k_nMaxLeaderboardEntries);
+            for (int index = 0; index < nLeaderboardEntries; index++)
+            {
+                // Store the downloaded leaderboard entry in tmpLBEntry, its details hold the run's splits
+                SteamBackend()->GetDownloadedLeaderboardEntry(pLeaderboardScoresDownloaded->m_hSteamLeaderboardEntries,
+                    index, &tmpLdBdEntry, rgnDetails, k_cLeaderboardDetailsMax);
+                int cSplits = STEAM_ScoreDetails::UnpackSplits(rgnDetails, MIN(tmpLdBdEntry.m_cDetails, k_cLeaderboardDetailsMax), rgnSplits, SDL_arraysize(rgnSplits));
+
+                // Only the SteamID, looking the name up here would fetch every downloaded persona
+                ULOG_DEBUG(k_ELogSteam, "(%d) %llu - %d", tmpLdBdEntry.m_nGlobalRank, static_cast<unsigned long long>(tmpLdBdEntry.m_steamIDUser.ConvertToUint64()), tmpLdBdEntry.m_nScore);
+
+                // Parse the data from tmpLdBdEntry into the appropriate LeaderboardEntry(s)
+                if (m_nPage != k_nUserPage)
+                {
+                    entries.push_back(LeaderboardEntry(tmpLdBdEntry.m_steamIDUser, tmpLdBdEntry.m_nScore, tmpLdBdEntry.m_nGlobalRank));
+                    entries.back().m_rgnSplits.assign(rgnSplits, rgnSplits + cSplits);
+                }
+
+                // Used to get the users leaderboard entry, matched by SteamID since two
+                // players can share a name
+                else if (tmpLdBdEntry.m_steamIDUser == steamIDUser)
+                {
+                    entries.push_back(LeaderboardEntry(tmpLdBdEntry.m_steamIDUser, tmpLdBdEntry.m_nScore, tmpLdBdEntry.m_nGlobalRank));
+                    entries.back().m_rgnSplits.assign(rgnSplits, rgnSplits + cSplits);
+                    break;
+                }
+            }
+
+            m_entries.swap(entries);
+            m_bHasData = true;
+            m_bInvalidated = false;
+            m_unFetchedTicks = SDL_GetTicks();
+
+            // show our new data
+            m_pMenu->OnCacheUpdated(*this);
+        }
+
+        STEAM_LeaderboardMenu *m_pMenu;
+    };
+
+    // Last download of each leaderboard page, only the pages near the visible rows are kept
+    std::map<std::pair<SteamLeaderboard_t, int>, LeaderboardCache> m_mapCache;
+
+    // Page downloads in flight, any number at once, cancelled with the menu
+    STEAM_AsyncScope m_asyncCalls;
 
     SteamLeaderboard_t m_hSteamLeaderboard;			// handle to the leaderboard we are displaying
-    ELeaderboardDataRequest m_eLeaderboardData;		// type of data we are displaying
-    bool m_bLoading;								// waiting to receive leaderboard results
-    bool m_bIOFailure;								// last attempt to retrieve the leaderboard failed
+    int m_nFirstRank;								// rank shown in the first row
+    int m_nEntryCount;								// entries on the leaderboard we are displaying
+    int m_nTestRound;								// alternates the made up entries so every test rebuild redraws
 
     TTF_Font* m_fntLeaderboard;                                           // Leaderboard font
+    STEAM_PersonaCache m_personaCache;                                    // Names and name textures of the players on the board
+    Uint32 m_unPersonaGeneration;                                         // m_personaCache generation the rows were built with
+    STEAM_AvatarCache m_avatarCache;                                      // Avatars of the players on the board
     std::vector<UTexture> m_texLeaderboardEntriesRank;                    // Top ten leaderboard entry rank texture
-    std::vector<UTexture> m_texLeaderboardEntriesName;                    // Top ten leaderboard entry name texture
+    std::vector<UTexture *> m_texLeaderboardEntriesName;                  // Top ten leaderboard entry name texture, owned by m_personaCache
     std::vector<UTexture> m_texLeaderboardEntriesScore;                   // Top ten leaderboard entry score texture
-    UTexture m_texUserEntryRank, m_texUserEntryName, m_texUserEntryScore; // Users leaderboard entry
-
-    CCallResult<STEAM_LeaderboardMenu, LeaderboardScoresDownloaded_t> m_callResultDownloadEntries;
+    UTexture m_texUserEntryRank, m_texUserEntryScore;                     // Users leaderboard entry
+    UTexture *m_pTexUserEntryName;                                        // Users leaderboard entry name, owned by m_personaCache unless it's m_texNoScore
+    UTexture m_texBlank, m_texNoScore;                                    // Names of rows without an entry
+
+    // What the row textures currently show, rows are only redrawn when their entry changes
+    LeaderboardEntry m_displayedEntries[k_nMaxLeaderboardEntries];
+    LeaderboardEntry m_displayedUserEntry;
+
+    // The board with its rows drawn on, rows are redrawn into it when they change. The last
+    // dirty flag is the user's row.
+    SDL_Renderer *m_pRenderer;
+    SDL_Texture *m_pTable;
+    bool m_bTableFastRun;                                // Which board's background m_pTable has
+    bool m_bTableDirty;                                  // Redraw the background and every row
+    bool m_rgbRowDirty[k_nMaxLeaderboardEntries + 1];
+    Uint32 m_unAvatarGeneration;                         // m_avatarCache generation the table was drawn with
 
     // Leaderboard menu texture assets
     UTexture m_texFastRunBoard, m_texLongDistanceBoard, m_texExitBtn;
@@ -76,24 +286,32 @@ public:
     // Constructor
     STEAM_LeaderboardMenu()
     {
-        m_eLeaderboardData = k_ELeaderboardDataRequestGlobal;
         m_hSteamLeaderboard = 0;
-        m_nLeaderboardEntries = 0;
-        m_bLoading = false;
-        m_bIOFailure = false;
-        m_usersEntry = nullptr;
+        m_nFirstRank = 1;
+        m_nEntryCount = 0;
+        m_nTestRound = 0;
         m_fntLeaderboard = nullptr;
+        m_unPersonaGeneration = 0;
+        m_pTexUserEntryName = &m_texBlank;
+        m_pRenderer = nullptr;
+        m_pTable = nullptr;
+        m_bTableFastRun = true;
+        m_bTableDirty = true;
+        m_unAvatarGeneration = 0;
+        SetRowsDirty();
     }
 
     // Destructor
     ~STEAM_LeaderboardMenu()
     {
-        if (m_usersEntry)
+        if (m_pTable)
         {
-            delete m_usersEntry;
-            m_usersEntry = nullptr;
+            SDL_DestroyTexture(m_pTable);
+            m_pTable = nullptr;
         }
 
+        // The cached names were rendered with the font
+        m_personaCache.free();
         if (m_fntLeaderboard)
         {
             TTF_CloseFont(m_fntLeaderboard);
@@ -105,17 +323,14 @@ public:
         {
             e.free();
         }
-        for (UTexture& e : m_texLeaderboardEntriesName)
-        {
-            e.free();
-        }
         for (UTexture& e : m_texLeaderboardEntriesScore)
         {
             e.free();
         }
         m_texUserEntryRank.free();
-        m_texUserEntryName.free();
         m_texUserEntryScore.free();
+        m_texBlank.free();
+        m_texNoScore.free();
         m_texFastRunBoard.free();
         m_texLongDistanceBoard.free();
         m_texExitBtn.free();
@@ -131,34 +346,36 @@ public:
             m_texFastRunBoard.initUTexture(a_pRenderer);
             if (!m_texFastRunBoard.loadFromFile("assets/fastest_run_leaderboard.png"))
             {
-                // printf("Failed to load fastest run leaderboard!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load fastest run leaderboard!");
                 success = false;
             }
 
             m_texLongDistanceBoard.initUTexture(a_pRenderer);
             if (!m_texLongDistanceBoard.loadFromFile("assets/longest_distance_leaderboard.png"))
             {
-                // printf("Failed to load longest distance leaderboard!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load longest distance leaderboard!");
                 success = false;
             }
 
             m_texExitBtn.initUTexture(a_pRenderer);
             if (!m_texExitBtn.loadFromFile("assets/x_button.png"))
             {
-                // printf("Failed to load exit button!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load exit button!");
                 success = false;
             }
 
             // Init leaderboard font
+            Uint64 loadStart = SDL_GetPerformanceCounter();
             m_fntLeaderboard = TTF_OpenFont("assets/font.ttf", 18);
+            UFlightRecorder::recordAsset(k_EFlightFont, "assets/font.ttf", m_fntLeaderboard != nullptr, loadStart);
             if (!m_fntLeaderboard)
             {
-                // printf("Failed to load leaderboard font, SDL_ttf Error: %s\n", TTF_GetError());
+                ULOG_ERROR(k_ELogRender, "Failed to load leaderboard font, SDL_ttf Error: %s", TTF_GetError());
                 success = false;
             }
 
             // Init the leaderboard textures
-            for (int i = 0; i < k_nMaxLeaderboardEntries + 1; ++i)
+            for (int i = 0; i < k_nMaxLeaderboardEntries; ++i)
             {
                 m_texLeaderboardEntriesRank.push_back(UTexture());
                 m_texLeaderboardEntriesRank.back().initUTexture(a_pRenderer);
@@ -166,19 +383,11 @@ public:
 
                 if (!m_texLeaderboardEntriesRank.back().loadFromRenderedText(" ", BLACK_TEXT))
                 {
-                    // printf("Failed to load leaderboard entry rank texture!\n");
+                    ULOG_ERROR(k_ELogRender, "Failed to load leaderboard entry rank texture!");
                     success = false;
                 }
 
-                m_texLeaderboardEntriesName.push_back(UTexture());
-                m_texLeaderboardEntriesName.back().initUTexture(a_pRenderer);
-                m_texLeaderboardEntriesName.back().initFont(m_fntLeaderboard);
-
-                if (!m_texLeaderboardEntriesName.back().loadFromRenderedText(" ", BLACK_TEXT))
-                {
-                    // printf("Failed to load leaderboard entry name texture!\n");
-                    success = false;
-                }
+                m_texLeaderboardEntriesName.push_back(&m_texBlank);
 
                 m_texLeaderboardEntriesScore.push_back(UTexture());
                 m_texLeaderboardEntriesScore.back().initUTexture(a_pRenderer);
@@ -186,7 +395,7 @@ public:
 
                 if (!m_texLeaderboardEntriesScore.back().loadFromRenderedText(" ", BLACK_TEXT))
                 {
-                    // printf("Failed to load leaderboard entry score texture!\n");
+                    ULOG_ERROR(k_ELogRender, "Failed to load leaderboard entry score texture!");
                     success = false;
                 }
             }
@@ -197,282 +406,664 @@ public:
 
             if (!m_texUserEntryRank.loadFromRenderedText(" ", BLACK_TEXT))
             {
-                // printf("Failed to load user entry rank texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load user entry rank texture!");
+                success = false;
+            }
+
+            m_texBlank.initUTexture(a_pRenderer);
+            m_texBlank.initFont(m_fntLeaderboard);
+
+            if (!m_texBlank.loadFromRenderedText(" ", BLACK_TEXT))
+            {
+                ULOG_ERROR(k_ELogRender, "Failed to load blank entry name texture!");
+                success = false;
+            }
+
+            m_texNoScore.initUTexture(a_pRenderer);
+            m_texNoScore.initFont(m_fntLeaderboard);
+
+            if (!m_texNoScore.loadFromRenderedText("No score", BLACK_TEXT))
+            {
+                ULOG_ERROR(k_ELogRender, "Failed to load no score entry name texture!");
                 success = false;
             }
 
-            m_texUserEntryName = UTexture();
-            m_texUserEntryName.initUTexture(a_pRenderer);
-            m_texUserEntryName.initFont(m_fntLeaderboard);
+            m_personaCache.init(a_pRenderer, m_fntLeaderboard);
 
-            if (!m_texUserEntryName.loadFromRenderedText(" ", BLACK_TEXT))
+            if (!m_avatarCache.init(a_pRenderer))
             {
-                // printf("Failed to load user entry name texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to create the leaderboard avatar cache!");
                 success = false;
             }
 
+            // Both boards are composited into the same texture, without render targets every
+            // cell is drawn each frame instead
+            m_pRenderer = a_pRenderer;
+            if (SDL_RenderTargetSupported(a_pRenderer))
+            {
+                int nWidth = MAX(m_texFastRunBoard.getWidth(), m_texLongDistanceBoard.getWidth());
+                int nHeight = MAX(m_texFastRunBoard.getHeight(), m_texLongDistanceBoard.getHeight());
+                m_pTable = SDL_CreateTexture(a_pRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, MAX(nWidth, 1), MAX(nHeight, 1));
+            }
+            if (m_pTable)
+            {
+                SDL_SetTextureBlendMode(m_pTable, SDL_BLENDMODE_BLEND);
+            }
+            else
+            {
+                ULOG_WARN(k_ELogRender, "Render targets aren't available, drawing the leaderboard a cell at a time");
+            }
+
             m_texUserEntryScore = UTexture();
             m_texUserEntryScore.initUTexture(a_pRenderer);
             m_texUserEntryScore.initFont(m_fntLeaderboard);
 
             if (!m_texUserEntryScore.loadFromRenderedText(" ", BLACK_TEXT))
             {
-                // printf("Failed to load user entry score texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load user entry score texture!");
                 success = false;
             }
         }
         return success;
     }
 
-    // Menu that shows a leaderboard
-    void ShowLeaderboard(SteamLeaderboard_t hLeaderboard, ELeaderboardDataRequest eLeaderboardData)
+    // Show a leaderboard. Cached entries are drawn straight away and refreshed in the
+    // background if they're stale, toggling between fresh boards doesn't download anything.
+    void ShowLeaderboard(SteamLeaderboard_t hLeaderboard)
     {
-        m_hSteamLeaderboard = hLeaderboard;
-        m_eLeaderboardData = eLeaderboardData;
-        m_bLoading = true;
-        m_bIOFailure = false;
-
-        if (hLeaderboard)
+        if (hLeaderboard != m_hSteamLeaderboard)
         {
-            // load the top ten leaderboard data. We only display k_nMaxLeaderboardEntries entries at a time
-            if (m_eLeaderboardData == k_ELeaderboardDataRequestGlobal)
-            {
-                SteamAPICall_t hSteamAPICall = SteamUserStats()->DownloadLeaderboardEntries(hLeaderboard, eLeaderboardData, 0, k_nMaxLeaderboardEntries);
-                // Register for the async callback
-                m_callResultDownloadEntries.Set(hSteamAPICall, this, &STEAM_LeaderboardMenu::OnLeaderboardDownloadedEntries);
-            }
-            // load the current users
-            else if (m_eLeaderboardData == k_ELeaderboardDataRequestGlobalAroundUser)
-            {
-                SteamAPICall_t hSteamAPICall = SteamUserStats()->DownloadLeaderboardEntries(hLeaderboard, eLeaderboardData, -1, 1);
-                // Register for the async callback
-                m_callResultDownloadEntries.Set(hSteamAPICall, this, &STEAM_LeaderboardMenu::OnLeaderboardDownloadedEntries);
-            }
+            m_hSteamLeaderboard = hLeaderboard;
+            m_nFirstRank = 1;
         }
+        m_nEntryCount = hLeaderboard && SteamBackend() ? SteamBackend()->GetLeaderboardEntryCount(hLeaderboard) : 0;
 
+        Prefetch(hLeaderboard);
+        RequestVisiblePages();
         Rebuild();
     }
 
-    // Render the leaderboard menu
-    void Render(bool a_bRenderFastRunLeaderboard) 
+    // Scroll the shown leaderboard by nRows, negative scrolls towards the top
+    void Scroll(int nRows)
     {
-        if (a_bRenderFastRunLeaderboard)
+        int nLastFirstRank = MAX(m_nEntryCount - k_nMaxLeaderboardEntries + 1, 1);
+        int nFirstRank = MIN(MAX(m_nFirstRank + nRows, 1), nLastFirstRank);
+        if (nFirstRank == m_nFirstRank)
+            return;
+
+        m_nFirstRank = nFirstRank;
+        RequestVisiblePages();
+        Rebuild();
+    }
+
+    // Download a leaderboard's entries if the cached ones are stale, without showing it. The
+    // top entries and the user's entry are downloaded at the same time and each is shown as
+    // soon as it arrives.
+    void Prefetch(SteamLeaderboard_t hLeaderboard)
+    {
+        if (!hLeaderboard || !SteamBackend())
+            return;
+
+        LeaderboardCache &topEntries = GetCache(hLeaderboard, 0);
+        if (topEntries.IsStale())
         {
-            m_texFastRunBoard.render(static_cast<int>((ULib::SCREEN_DIMENSIONS.x - m_texFastRunBoard.getWidth()) / 2.f), static_cast<int>((ULib::SCREEN_DIMENSIONS.y - m_texFastRunBoard.getHeight()) / 2.f));
+            topEntries.Refresh();
         }
-        else
+
+        LeaderboardCache &userEntry = GetCache(hLeaderboard, k_nUserPage);
+        if (userEntry.IsStale())
         {
-            m_texLongDistanceBoard.render(static_cast<int>((ULib::SCREEN_DIMENSIONS.x - m_texLongDistanceBoard.getWidth()) / 2.f), static_cast<int>((ULib::SCREEN_DIMENSIONS.y - m_texLongDistanceBoard.getHeight()) / 2.f));
+            userEntry.Refresh();
         }
+    }
 
-        
-        for (int i = 0; i < k_nMaxLeaderboardEntries && i < m_texLeaderboardEntriesName.size(); ++i)
+    // The user's score on a leaderboard changed, download it again next time it's shown
+    void Invalidate(SteamLeaderboard_t hLeaderboard)
+    {
+        for (std::pair<const std::pair<SteamLeaderboard_t, int>, LeaderboardCache> &cache : m_mapCache)
         {
-            m_texLeaderboardEntriesRank[i].render(446, 137 + (40 * i));
-            m_texLeaderboardEntriesName[i].render(515, 137 + (40 * i));
-            m_texLeaderboardEntriesScore[i].render(762, 137 + (40 * i));
+            if (cache.first.first == hLeaderboard)
+            {
+                cache.second.m_bInvalidated = true;
+            }
         }
+    }
 
-        m_texUserEntryRank.render(460, 620);
-        m_texUserEntryName.render(520, 620);
-        m_texUserEntryScore.render(770, 620);
+    // Fill the menu with a full page of made up entries, the scores alternate so each call
+    // changes every row
+    void LoadTestEntries()
+    {
+        const SteamLeaderboard_t hTestLeaderboard = 1;
+        m_hSteamLeaderboard = hTestLeaderboard;
+        m_nFirstRank = 1;
+        m_nEntryCount = k_nMaxLeaderboardEntries;
+        ++m_nTestRound;
+
+        LeaderboardCache &topEntries = GetCache(hTestLeaderboard, 0);
+        topEntries.m_entries.clear();
+        for (int i = 0; i < k_nMaxLeaderboardEntries; ++i)
+        {
+            CSteamID steamID(static_cast<uint32>(1000 + i), k_EUniversePublic, k_EAccountTypeIndividual);
+            m_personaCache.SetName(steamID, "Player " + std::to_string(i + 1));
+            topEntries.m_entries.push_back(LeaderboardEntry(steamID, 1000 - (i * 7) + (m_nTestRound & 1), i + 1));
+            for (int nSecond = 0; nSecond < 34; ++nSecond)
+            {
+                topEntries.m_entries.back().m_rgnSplits.push_back(6 + (nSecond * 7 + i * 3) % 9);
+            }
+        }
+        topEntries.m_bHasData = true;
+        topEntries.m_unFetchedTicks = SDL_GetTicks();
+
+        LeaderboardCache &userEntry = GetCache(hTestLeaderboard, k_nUserPage);
+        CSteamID steamIDUser(static_cast<uint32>(999), k_EUniversePublic, k_EAccountTypeIndividual);
+        m_personaCache.SetName(steamIDUser, "You");
+        userEntry.m_entries.assign(1, LeaderboardEntry(steamIDUser, 500 + (m_nTestRound & 1), 42));
+        userEntry.m_bHasData = true;
+        userEntry.m_unFetchedTicks = topEntries.m_unFetchedTicks;
     }
 
-    // Creates a leaderboard menu
-    void Rebuild()
+    // Render the leaderboard menu. The board and its rows are composited into m_pTable, where
+    // only the rows that changed are redrawn, so a frame is a single blit. Falls back to
+    // drawing every cell when the renderer can't render to a texture.
+    void Render(bool a_bRenderFastRunLeaderboard) 
     {
-        // If the Leaderboard is loading set the user xor leaderboard entry as loading
-        if (!m_hSteamLeaderboard || m_bLoading)
+        UTexture &texBoard = a_bRenderFastRunLeaderboard ? m_texFastRunBoard : m_texLongDistanceBoard;
+        int nBoardX = static_cast<int>((ULib::SCREEN_DIMENSIONS.x - texBoard.getWidth()) / 2.f);
+        int nBoardY = static_cast<int>((ULib::SCREEN_DIMENSIONS.y - texBoard.getHeight()) / 2.f);
+
+        // A player on the board changed their name
+        if (m_personaCache.GetGeneration() != m_unPersonaGeneration)
+        {
+            Rebuild();
+            SetRowsDirty();
+        }
+
+        // Keep the avatars on screen in the atlas, and upload the ones that finished converting
+        for (int i = 0; i <= k_nMaxLeaderboardEntries; ++i)
         {
-            // Make sure to only erase the leaderboard entries if not requesting just
-            // the current user
-            if (m_eLeaderboardData == k_ELeaderboardDataRequestGlobal)
+            const LeaderboardEntry &entry = i < k_nMaxLeaderboardEntries ? m_displayedEntries[i] : m_displayedUserEntry;
+            if (entry.m_eOption == ELeaderboardEntryOption::k_EValid)
             {
-                m_leaderboardEntries.clear();
-                m_leaderboardEntries.push_back(LeaderboardEntry(ELeaderboardEntryOption::k_ELoading));
-                
-                for (int i = 0; i < m_leaderboardEntries.size(); ++i)
-                {
-                    m_texLeaderboardEntriesName[i].loadFromRenderedText(" ", BLACK_TEXT);
-                    m_texLeaderboardEntriesRank[i].loadFromRenderedText(" ", BLACK_TEXT);
-                    m_texLeaderboardEntriesScore[i].loadFromRenderedText(" ", BLACK_TEXT);
-                }
+                m_avatarCache.Request(entry.m_ulSteamID);
             }
+        }
+        m_avatarCache.Update();
+        if (m_avatarCache.GetGeneration() != m_unAvatarGeneration)
+        {
+            m_unAvatarGeneration = m_avatarCache.GetGeneration();
+            SetRowsDirty();
+        }
 
-            // Make sure to only erase the user entry if requesting just the current user
-            else if (m_eLeaderboardData == k_ELeaderboardDataRequestGlobalAroundUser)
+        if (!m_pTable)
+        {
+            texBoard.render(nBoardX, nBoardY);
+            for (int i = 0; i <= k_nMaxLeaderboardEntries; ++i)
             {
-                if (m_usersEntry)
-                {
-                    delete m_usersEntry;
-                    m_usersEntry = nullptr;
-                }
-                m_usersEntry = new LeaderboardEntry(ELeaderboardEntryOption::k_ELoading);
-                m_texUserEntryName.loadFromRenderedText(" ", BLACK_TEXT);
-                m_texUserEntryRank.loadFromRenderedText(" ", BLACK_TEXT);
-                m_texUserEntryScore.loadFromRenderedText(" ", BLACK_TEXT);
+                DrawRow(i, 0, 0);
             }
+            return;
         }
 
-        // If an IO Failure occurs set the user and leaderboard entries as IO failure
-        else if (m_bIOFailure)
+        if (a_bRenderFastRunLeaderboard != m_bTableFastRun)
         {
-            m_leaderboardEntries.clear();
-            m_leaderboardEntries.push_back(LeaderboardEntry(ELeaderboardEntryOption::k_EIOFail));
+            m_bTableFastRun = a_bRenderFastRunLeaderboard;
+            m_bTableDirty = true;
+        }
+        RedrawTable(texBoard, nBoardX, nBoardY);
+
+        SDL_Rect dst = { nBoardX, nBoardY, texBoard.getWidth(), texBoard.getHeight() };
+        SDL_Rect src = { 0, 0, dst.w, dst.h };
+        ++UTexture::sRenderCount;
+        SDL_RenderCopy(m_pRenderer, m_pTable, &src, &dst);
+    }
 
-            for (int i = 0; i < m_leaderboardEntries.size(); ++i)
+    // The table has to be drawn again from scratch, e.g. the renderer lost its render targets
+    void InvalidateTable()
+    {
+        m_bTableDirty = true;
+    }
+
+    // Creates a leaderboard menu from the cached pages of the shown leaderboard. Rows that
+    // are still loading or failed to load are left blank, only rows that changed are redrawn.
+    void Rebuild()
+    {
+        for (int i = 0; i < k_nMaxLeaderboardEntries; ++i)
+        {
+            int nIndex = m_nFirstRank - 1 + i;
+            const LeaderboardCache *pPage = FindCache(m_hSteamLeaderboard, nIndex / k_nMaxLeaderboardEntries);
+            if (pPage && pPage->m_bHasData)
             {
-                m_texLeaderboardEntriesName[i].loadFromRenderedText(" ", BLACK_TEXT);
-                m_texLeaderboardEntriesRank[i].loadFromRenderedText(" ", BLACK_TEXT);
-                m_texLeaderboardEntriesScore[i].loadFromRenderedText(" ", BLACK_TEXT);
+                size_t unEntry = nIndex % k_nMaxLeaderboardEntries;
+                SetEntry(i, unEntry < pPage->m_entries.size() ? pPage->m_entries[unEntry] : LeaderboardEntry());
             }
-
-            if (m_usersEntry)
+            else
             {
-                delete m_usersEntry;
-                m_usersEntry = nullptr;
+                SetEntry(i, LeaderboardEntry(GetStatus(pPage)));
             }
-            m_usersEntry = new LeaderboardEntry(ELeaderboardEntryOption::k_EIOFail);
-            m_texUserEntryName.loadFromRenderedText(" ", BLACK_TEXT);
-            m_texUserEntryRank.loadFromRenderedText(" ", BLACK_TEXT);
-            m_texUserEntryScore.loadFromRenderedText(" ", BLACK_TEXT);
         }
 
-        // Populate the leaderboard entries
+        // If requesting global scores around the user returns successfully with 0 results
+        // the user does not have an entry on the leaderboard
+        const LeaderboardCache *pUserEntry = FindCache(m_hSteamLeaderboard, k_nUserPage);
+        if (pUserEntry && pUserEntry->m_bHasData)
+        {
+            SetUserEntry(pUserEntry->m_entries.empty() ? LeaderboardEntry(ELeaderboardEntryOption::k_ENoScore) : pUserEntry->m_entries.front());
+        }
         else
         {
-            if (m_nLeaderboardEntries == 0)
-            {
-                // If requesting global scores around the user returns successfully with 0 results
-                // the user does not have an entry on the leaderboard
-                std::string strText;         
-                if (m_eLeaderboardData == k_ELeaderboardDataRequestGlobalAroundUser)
-                {
-                    if (m_usersEntry)
-                    {
-                        delete m_usersEntry;
-                        m_usersEntry = nullptr;
-                    }
+            SetUserEntry(LeaderboardEntry(GetStatus(pUserEntry)));
+        }
 
-                    m_usersEntry = new LeaderboardEntry(ELeaderboardEntryOption::k_ENoScore);
-                    m_texUserEntryName.loadFromRenderedText("No score", BLACK_TEXT);
-                    m_texUserEntryRank.loadFromRenderedText(" ", BLACK_TEXT);
-                    m_texUserEntryScore.loadFromRenderedText(" ", BLACK_TEXT);
-                }
+        // Keep the cached names bounded, without dropping the ones on screen
+        uint64 rgulShown[k_nMaxLeaderboardEntries + 1];
+        for (int i = 0; i < k_nMaxLeaderboardEntries; ++i)
+        {
+            rgulShown[i] = m_displayedEntries[i].m_ulSteamID;
+        }
+        rgulShown[k_nMaxLeaderboardEntries] = m_displayedUserEntry.m_ulSteamID;
+        m_personaCache.Trim(rgulShown, k_nMaxLeaderboardEntries + 1);
+        m_unPersonaGeneration = m_personaCache.GetGeneration();
+    }
 
-                // If not requesting global score around the user
-                else if(m_eLeaderboardData == k_ELeaderboardDataRequestGlobal)
-                {
-                    m_leaderboardEntries.clear();
-                    m_leaderboardEntries.push_back(LeaderboardEntry(ELeaderboardEntryOption::k_ENoScore));
+private:
+    // The cache for a leaderboard page, created on first use
+    LeaderboardCache &GetCache(SteamLeaderboard_t hLeaderboard, int nPage)
+    {
+        LeaderboardCache &cache = m_mapCache[std::make_pair(hLeaderboard, nPage)];
+        cache.init(this, hLeaderboard, nPage);
+        return cache;
+    }
 
-                    for (int i = 0; i < m_leaderboardEntries.size(); ++i)
-                    {
-                        m_texLeaderboardEntriesName[i].loadFromRenderedText(" ", BLACK_TEXT);
-                        m_texLeaderboardEntriesRank[i].loadFromRenderedText(" ", BLACK_TEXT);
-                        m_texLeaderboardEntriesScore[i].loadFromRenderedText(" ", BLACK_TEXT);
-                    }
-                }
-            }
+    // The cache for a leaderboard page, nullptr if it isn't kept
+    const LeaderboardCache *FindCache(SteamLeaderboard_t hLeaderboard, int nPage) const
+    {
+        auto it = m_mapCache.find(std::make_pair(hLeaderboard, nPage));
+        return it != m_mapCache.end() ? &it->second : nullptr;
+    }
 
-            // Print the parsed top ten leaderboard data
-            else if (m_eLeaderboardData == k_ELeaderboardDataRequestGlobal)
-            {
-                // clear leaderboard entry textures
-                for (int i = 0; i < m_leaderboardEntries.size(); ++i)
-                {
-                    m_texLeaderboardEntriesName[i].loadFromRenderedText(" ", BLACK_TEXT);
-                    m_texLeaderboardEntriesRank[i].loadFromRenderedText(" ", BLACK_TEXT);
-                    m_texLeaderboardEntriesScore[i].loadFromRenderedText(" ", BLACK_TEXT);
-                }
+    // Download the visible pages and the ones either side of them if they're stale, so the
+    // next page is ready before it scrolls into view. Pages further away are dropped, which
+    // keeps memory bounded however far the user scrolls.
+    void RequestVisiblePages()
+    {
+        int nFirstPage = (m_nFirstRank - 1) / k_nMaxLeaderboardEntries;
+        int nLastPage = (m_nFirstRank + k_nMaxLeaderboardEntries - 2) / k_nMaxLeaderboardEntries;
+        int nPageCount = (m_nEntryCount + k_nMaxLeaderboardEntries - 1) / k_nMaxLeaderboardEntries;
 
-                for (int i = 0; i < m_leaderboardEntries.size(); ++i)
-                {
-                    if (m_leaderboardEntries[i].m_eOption == ELeaderboardEntryOption::k_EValid)
-                    {
-                        // printf("Creating valid leaderboard entry name: %s\n", m_leaderboardEntries[i].m_name.c_str());
-                        m_texLeaderboardEntriesName[i].loadFromRenderedText(m_leaderboardEntries[i].m_name, BLACK_TEXT);
-                        m_texLeaderboardEntriesRank[i].loadFromRenderedText(std::to_string(m_leaderboardEntries[i].m_nGlobalRank), BLACK_TEXT);
-                        m_texLeaderboardEntriesScore[i].loadFromRenderedText(std::to_string(m_leaderboardEntries[i].m_nScore), BLACK_TEXT);
-                    }
-                }
+        for (auto it = m_mapCache.begin(); it != m_mapCache.end();)
+        {
+            int nPage = it->first.second;
+            bool bKeep = nPage <= 0 || (it->first.first == m_hSteamLeaderboard && nPage >= nFirstPage - k_nPagesKept && nPage <= nLastPage + k_nPagesKept);
+            it = bKeep ? std::next(it) : m_mapCache.erase(it);
+        }
 
-                // Get the current users leaderboard data
-                ShowLeaderboard(m_hSteamLeaderboard, k_ELeaderboardDataRequestGlobalAroundUser);
-            }
+        if (!m_hSteamLeaderboard || !SteamBackend())
+            return;
 
-            // Print the parsed current user leaderboard data
-            else if (m_eLeaderboardData == k_ELeaderboardDataRequestGlobalAroundUser)
+        for (int nPage = MAX(nFirstPage - 1, 0); nPage <= nLastPage + 1 && nPage < nPageCount; ++nPage)
+        {
+            LeaderboardCache &page = GetCache(m_hSteamLeaderboard, nPage);
+            if (page.IsStale())
             {
-                if (m_usersEntry->m_eOption == ELeaderboardEntryOption::k_EValid)
-                {
-                    // printf("Creating valid user Entry name: %s\n", m_usersEntry->m_name.c_str());
-                    m_texUserEntryName.loadFromRenderedText(m_usersEntry->m_name, BLACK_TEXT);
-                    m_texUserEntryRank.loadFromRenderedText(std::to_string(m_usersEntry->m_nGlobalRank), BLACK_TEXT);
-                    m_texUserEntryScore.loadFromRenderedText(std::to_string(m_usersEntry->m_nScore), BLACK_TEXT);
-                }
+                page.Refresh();
             }
         }
     }
 
-    // Called when SteamUserStats()->DownloadLeaderboardEntries() returns asynchronously
-    void OnLeaderboardDownloadedEntries(LeaderboardScoresDownloaded_t* pLeaderboardScoresDownloaded, bool bIOFailure)
+    // What to show for a cache without entries
+    static ELeaderboardEntryOption GetStatus(const LeaderboardCache *a_pCache)
     {
-        LeaderboardEntry_t tmpLdBdEntry;
-        m_bLoading = false;
-        m_bIOFailure = bIOFailure;
+        return a_pCache && a_pCache->m_bIOFailure ? ELeaderboardEntryOption::k_EIOFail : ELeaderboardEntryOption::k_ELoading;
+    }
 
-        // printf("USER NAME: %s\n", SteamFriends()->GetPersonaName());
+    // A download finished, redraw if the leaderboard is on screen
+    void OnCacheUpdated(const LeaderboardCache &a_cache)
+    {
+        if (a_cache.m_hSteamLeaderboard == m_hSteamLeaderboard)
+        {
+            Rebuild();
+        }
+    }
 
-        // leaderboard entries handle will be invalid once we return from this function. Copy all data now.
-        m_nLeaderboardEntries = MIN(pLeaderboardScoresDownloaded->m_cEntryCount, k_nMaxLeaderboardEntries);
-        for (int index = 0; index < m_nLeaderboardEntries; index++)
+    // Redraw every row into the table next frame, without rendering any text again
+    void SetRowsDirty()
+    {
+        for (bool &bDirty : m_rgbRowDirty)
         {
-            // Store the downloaded leaderboard entry in tmpLBEntry
-            SteamUserStats()->GetDownloadedLeaderboardEntry(pLeaderboardScoresDownloaded->m_hSteamLeaderboardEntries,
-                index, &tmpLdBdEntry, NULL, 0);
+            bDirty = true;
+        }
+    }
 
-            // printf("(% d) % s - % d\n", tmpLdBdEntry.m_nGlobalRank, SteamFriends()->GetFriendPersonaName(tmpLdBdEntry.m_steamIDUser), tmpLdBdEntry.m_nScore);
+    // Top of the strip of the screen row i is drawn in, the user's row is k_nMaxLeaderboardEntries
+    static int GetRowTop(int i)
+    {
+        return i < k_nMaxLeaderboardEntries ? 134 + (LEADERBOARD_ROW_HEIGHT * (i + 1)) : 617;
+    }
 
-            // Parse the data from tmpLdBdEntry into the appropriate LeaderboardEntry(s)
-            if (m_eLeaderboardData == k_ELeaderboardDataRequestGlobal)
+    // Draw row i's cells, moved by (x, y)
+    void DrawRow(int i, int x, int y)
+    {
+        if (i < k_nMaxLeaderboardEntries)
+        {
+            // The first line of the board holds the column titles
+            m_texLeaderboardEntriesRank[i].render(446 + x, 137 + (40 * (i + 1)) + y);
+            if (m_displayedEntries[i].m_eOption == ELeaderboardEntryOption::k_EValid)
             {
-                m_leaderboardEntries.push_back(LeaderboardEntry(SteamFriends()->GetFriendPersonaName(tmpLdBdEntry.m_steamIDUser), tmpLdBdEntry.m_nScore, tmpLdBdEntry.m_nGlobalRank));
+                m_avatarCache.Render(m_displayedEntries[i].m_ulSteamID, 515 + x, 136 + (40 * (i + 1)) + y, LEADERBOARD_AVATAR_SIZE);
             }
+            m_texLeaderboardEntriesName[i]->render(545 + x, 137 + (40 * (i + 1)) + y);
+            m_texLeaderboardEntriesScore[i].render(762 + x, 137 + (40 * (i + 1)) + y);
+            DrawPace(m_displayedEntries[i], 806 + x, 137 + (40 * (i + 1)) + y);
+            return;
+        }
+
+        m_texUserEntryRank.render(460 + x, 620 + y);
+        if (m_displayedUserEntry.m_eOption == ELeaderboardEntryOption::k_EValid)
+        {
+            m_avatarCache.Render(m_displayedUserEntry.m_ulSteamID, 520 + x, 619 + y, LEADERBOARD_AVATAR_SIZE);
+        }
+        m_pTexUserEntryName->render(550 + x, 620 + y);
+        m_texUserEntryScore.render(770 + x, 620 + y);
+        DrawPace(m_displayedUserEntry, 806 + x, 620 + y);
+    }
+
+    // Draw the keystrokes per second of a_entry's run as a line, nothing if it has no splits
+    void DrawPace(const LeaderboardEntry &a_entry, int x, int y)
+    {
+        int cSplits = MIN(static_cast<int>(a_entry.m_rgnSplits.size()), LEADERBOARD_PACE_WIDTH);
+        if (a_entry.m_eOption != ELeaderboardEntryOption::k_EValid || cSplits < 2)
+            return;
 
-            // Used to get the users leaderboard entry
-            else if (m_eLeaderboardData == k_ELeaderboardDataRequestGlobalAroundUser)
+        SDL_Point rgPoints[LEADERBOARD_PACE_WIDTH];
+        for (int i = 0; i < cSplits; ++i)
+        {
+            int nKeys = MAX(MIN(a_entry.m_rgnSplits[i], LEADERBOARD_PACE_MAX_KEYS), 0);
+            rgPoints[i].x = x + i * (LEADERBOARD_PACE_WIDTH - 1) / (cSplits - 1);
+            rgPoints[i].y = y + (LEADERBOARD_PACE_HEIGHT - 1) - nKeys * (LEADERBOARD_PACE_HEIGHT - 1) / LEADERBOARD_PACE_MAX_KEYS;
+        }
+
+        ++UTexture::sRenderCount;
+        SDL_SetRenderDrawColor(m_pRenderer, 0, 0, 0, 0xFF);
+        SDL_RenderDrawLines(m_pRenderer, rgPoints, cSplits);
+    }
+
+    // Redraw the dirty rows into m_pTable. Each row's strip of the board background is copied
+    // over it first, which wipes what the row showed before.
+    void RedrawTable(UTexture &a_texBoard, int a_nBoardX, int a_nBoardY)
+    {
+        bool bAnyDirty = m_bTableDirty;
+        for (bool bDirty : m_rgbRowDirty)
+        {
+            bAnyDirty = bAnyDirty || bDirty;
+        }
+        if (!bAnyDirty)
+            return;
+
+        SDL_Texture *pTarget = SDL_GetRenderTarget(m_pRenderer);
+        SDL_SetRenderTarget(m_pRenderer, m_pTable);
+
+        // Copy the background as is, alpha included
+        a_texBoard.setBlendMode(SDL_BLENDMODE_NONE);
+        if (m_bTableDirty)
+        {
+            SDL_SetRenderDrawColor(m_pRenderer, 0, 0, 0, 0);
+            SDL_RenderClear(m_pRenderer);
+            a_texBoard.render(0, 0);
+            SetRowsDirty();
+        }
+        else
+        {
+            for (int i = 0; i <= k_nMaxLeaderboardEntries; ++i)
             {
-                // Assert m_usersEntry is the nullptr
-                if (m_usersEntry)
-                {
-                    delete m_usersEntry;
-                    m_usersEntry = nullptr;
-                }
+                if (!m_rgbRowDirty[i])
+                    continue;
 
-                // Load the users entry
-                // printf("%s ?= %s\n", SteamFriends()->GetFriendPersonaName(tmpLdBdEntry.m_steamIDUser), SteamFriends()->GetPersonaName());
-                if (strcmp(SteamFriends()->GetPersonaName(), SteamFriends()->GetFriendPersonaName(tmpLdBdEntry.m_steamIDUser)) == 0)
-                {
-                    m_usersEntry = new LeaderboardEntry(SteamFriends()->GetFriendPersonaName(tmpLdBdEntry.m_steamIDUser), tmpLdBdEntry.m_nScore, tmpLdBdEntry.m_nGlobalRank);
-                    break;
-                }
+                SDL_Rect clip = { 0, GetRowTop(i) - a_nBoardY, a_texBoard.getWidth(), LEADERBOARD_ROW_HEIGHT };
+                a_texBoard.render(clip.x, clip.y, &clip);
             }
         }
+        a_texBoard.setBlendMode(SDL_BLENDMODE_BLEND);
 
-        // show our new data
-        Rebuild();
+        for (int i = 0; i <= k_nMaxLeaderboardEntries; ++i)
+        {
+            if (m_rgbRowDirty[i])
+            {
+                DrawRow(i, -a_nBoardX, -a_nBoardY);
+                m_rgbRowDirty[i] = false;
+            }
+        }
+
+        SDL_SetRenderTarget(m_pRenderer, pTarget);
+        m_bTableDirty = false;
+    }
+
+    // Draw a top ten row if its entry changed. The name comes from the persona cache, which
+    // only renders it the first time the player is seen or after they rename, and the avatar
+    // is fetched in the background.
+    void SetEntry(int i, const LeaderboardEntry &a_entry)
+    {
+        bool bValid = a_entry.m_eOption == ELeaderboardEntryOption::k_EValid;
+        m_texLeaderboardEntriesName[i] = bValid ? m_personaCache.GetNameTexture(a_entry.m_ulSteamID) : &m_texBlank;
+        if (bValid)
+        {
+            m_avatarCache.Request(a_entry.m_ulSteamID);
+        }
+        if (m_displayedEntries[i] == a_entry)
+            return;
+
+        m_displayedEntries[i] = a_entry;
+        m_rgbRowDirty[i] = true;
+        if (bValid)
+        {
+            m_texLeaderboardEntriesRank[i].loadFromRenderedText(std::to_string(a_entry.m_nGlobalRank), BLACK_TEXT);
+            m_texLeaderboardEntriesScore[i].loadFromRenderedText(std::to_string(a_entry.m_nScore), BLACK_TEXT);
+        }
+        else
+        {
+            m_texLeaderboardEntriesRank[i].loadFromRenderedText(" ", BLACK_TEXT);
+            m_texLeaderboardEntriesScore[i].loadFromRenderedText(" ", BLACK_TEXT);
+        }
+    }
+
+    // Draw the user's row if their entry changed
+    void SetUserEntry(const LeaderboardEntry &a_entry)
+    {
+        bool bValid = a_entry.m_eOption == ELeaderboardEntryOption::k_EValid;
+        if (bValid)
+        {
+            m_pTexUserEntryName = m_personaCache.GetNameTexture(a_entry.m_ulSteamID);
+            m_avatarCache.Request(a_entry.m_ulSteamID);
+        }
+        else
+        {
+            m_pTexUserEntryName = a_entry.m_eOption == ELeaderboardEntryOption::k_ENoScore ? &m_texNoScore : &m_texBlank;
+        }
+
+        if (m_displayedUserEntry == a_entry)
+            return;
+
+        m_displayedUserEntry = a_entry;
+        m_rgbRowDirty[k_nMaxLeaderboardEntries] = true;
+        if (bValid)
+        {
+            m_texUserEntryRank.loadFromRenderedText(std::to_string(a_entry.m_nGlobalRank), BLACK_TEXT);
+            m_texUserEntryScore.loadFromRenderedText(std::to_string(a_entry.m_nScore), BLACK_TEXT);
+        }
+        else
+        {
+            m_texUserEntryRank.loadFromRenderedText(" ", BLACK_TEXT);
+            m_texUserEntryScore.loadFromRenderedText(" ", BLACK_TEXT);
+        }
     }
 };
 
+// Constructor
+STEAM_LeaderboardHandle::STEAM_LeaderboardHandle()
+{
+    m_hSteamLeaderboard = 0;
+    m_pOwner = nullptr;
+    m_eLeaderboard = k_ELeaderboardFastestRun;
+    m_bFinding = false;
+    m_bUploading = false;
+
+    m_bUploadQueued = false;
+    m_nQueuedScore = 0;
+    m_nUploadingScore = 0;
+    m_bUploaded = false;
+    m_nBestUploadedScore = 0;
+    m_nUploadRetries = 0;
+    m_unNextUploadTicks = 0;
+}
+
+// Start looking up the handle unless it's known or already being looked up
+void STEAM_LeaderboardHandle::Find(STEAM_Leaderboards *a_pOwner, ELeaderboard a_eLeaderboard)
+{
+    m_pOwner = a_pOwner;
+    m_eLeaderboard = a_eLeaderboard;
+    if (m_hSteamLeaderboard || m_bFinding || !SteamBackend())
+        return;
+
+    // find/create the leaderboard, set the function to call when this API call has completed
+    SteamAPICall_t hSteamAPICall = SteamBackend()->FindLeaderboard(k_rgpchLeaderboardNames[a_eLeaderboard]);
+    UFlightRecorder::recordSteamCall(k_EFlightFindLeaderboard, hSteamAPICall);
+    m_bFinding = m_asyncCalls.Await<LeaderboardFindResult_t>(hSteamAPICall,
+        [this](LeaderboardFindResult_t *pResult, bool bIOFailure) { OnFindLeaderboard(pResult, bIOFailure); });
+    if (!m_bFinding)
+    {
+        ULOG_WARN(k_ELogSteam, "Unable to start looking up leaderboard %s", k_rgpchLeaderboardNames[a_eLeaderboard]);
+    }
+}
+
+// Called when SteamBackend()->FindLeaderboard() returns asynchronously
+void STEAM_LeaderboardHandle::OnFindLeaderboard(LeaderboardFindResult_t *pFindLeaderboardResult, bool bIOFailure)
+{
+    m_bFinding = false;
+    UFlightRecorder::recordSteamCallback(k_EFlightFindLeaderboard, pFindLeaderboardResult->m_bLeaderboardFound && !bIOFailure, pFindLeaderboardResult->m_hSteamLeaderboard);
+
+    // see if we encountered an error during the call, the lookup is tried again next time
+    // the leaderboard menu is opened
+    if (!pFindLeaderboardResult->m_bLeaderboardFound || bIOFailure)
+    {
+        ULOG_WARN(k_ELogSteam, "FindLeaderboard(%s) failed, IO failure: %d", k_rgpchLeaderboardNames[m_eLeaderboard], bIOFailure);
+        return;
+    }
+
+    m_hSteamLeaderboard = pFindLeaderboardResult->m_hSteamLeaderboard;
+
+    // Resend the best score that didn't reach Steam last time, the journal doesn't keep its details
+    int32 nScore;
+    if (STEAM_Journal::GetBestScore(k_rgpchLeaderboardNames[m_eLeaderboard], &nScore))
+    {
+        Queue(nScore, nullptr, 0);
+    }
+
+    m_pOwner->OnFindLeaderboard(m_eLeaderboard);
+}
+
+// Queue a score, it replaces any queued score that isn't as good
+void STEAM_LeaderboardHandle::QueueUpload(int32 a_nScore, const int32 *a_pDetails, int a_cDetails)
+{
+    // Steam keeps the best score, so there's no point sending a worse one
+    if (m_bUploaded && a_nScore <= m_nBestUploadedScore)
+        return;
+
+    // Journal it in case Steam can't be reached before the game exits
+    STEAM_Journal::AddScore(k_rgpchLeaderboardNames[m_eLeaderboard], a_nScore);
+    Queue(a_nScore, a_pDetails, a_cDetails);
+}
+
+// Queue a score without journaling it
+void STEAM_LeaderboardHandle::Queue(int32 a_nScore, const int32 *a_pDetails, int a_cDetails)
+{
+    if (!m_bUploadQueued || a_nScore > m_nQueuedScore)
+    {
+        m_nQueuedScore = a_nScore;
+        m_rgnQueuedDetails.assign(a_pDetails, a_pDetails + a_cDetails);
+        m_bUploadQueued = true;
+    }
+
+    RunUploads();
+}
+
+// Start the next upload if the board has a queued score and isn't waiting on one
+void STEAM_LeaderboardHandle::RunUploads()
+{
+    if (!m_bUploadQueued || !m_hSteamLeaderboard || m_bUploading || !SteamBackend())
+        return;
+
+    if (m_nUploadRetries && static_cast<Sint32>(SDL_GetTicks() - m_unNextUploadTicks) < 0)
+        return;
+
+    m_nUploadingScore = m_nQueuedScore;
+    m_rgnUploadingDetails.swap(m_rgnQueuedDetails);
+    m_rgnQueuedDetails.clear();
+    m_bUploadQueued = false;
+
+    SteamAPICall_t hSteamAPICall = SteamBackend()->UploadLeaderboardScore(m_hSteamLeaderboard, k_ELeaderboardUploadScoreMethodKeepBest, m_nUploadingScore,
+        m_rgnUploadingDetails.empty() ? NULL : m_rgnUploadingDetails.data(), static_cast<int>(m_rgnUploadingDetails.size()));
+    UFlightRecorder::recordSteamCall(k_EFlightUploadScore, hSteamAPICall);
+    m_bUploading = m_asyncCalls.Await<LeaderboardScoreUploaded_t>(hSteamAPICall,
+        [this](LeaderboardScoreUploaded_t *pResult, bool bIOFailure) { OnUploadScore(pResult, bIOFailure); });
+    if (!m_bUploading)
+    {
+        // Couldn't be started, goes through the same backoff as a failed upload
+        LeaderboardScoreUploaded_t result;
+        memset(&result, 0, sizeof(result));
+        OnUploadScore(&result, true);
+    }
+}
+
+// Called when SteamBackend()->UploadLeaderboardScore() returns asynchronously
+void STEAM_LeaderboardHandle::OnUploadScore(LeaderboardScoreUploaded_t *pScoreUploadedResult, bool bIOFailure)
+{
+    m_bUploading = false;
+    UFlightRecorder::recordSteamCallback(k_EFlightUploadScore, pScoreUploadedResult->m_bSuccess && !bIOFailure, pScoreUploadedResult->m_hSteamLeaderboard);
+
+    if (bIOFailure || !pScoreUploadedResult->m_bSuccess)
+    {
+        // Put the score back unless a better one was queued meanwhile, and wait before trying again
+        if (!m_bUploadQueued || m_nUploadingScore > m_nQueuedScore)
+        {
+            m_nQueuedScore = m_nUploadingScore;
+            m_rgnQueuedDetails.swap(m_rgnUploadingDetails);
+        }
+        m_bUploadQueued = true;
+
+        Uint32 unRetryMS = LEADERBOARD_UPLOAD_RETRY_MAX_MS;
+        if (m_nUploadRetries < 6)
+        {
+            unRetryMS = MIN(LEADERBOARD_UPLOAD_RETRY_MS << m_nUploadRetries, LEADERBOARD_UPLOAD_RETRY_MAX_MS);
+        }
+        ++m_nUploadRetries;
+        m_unNextUploadTicks = SDL_GetTicks() + unRetryMS;
+
+        ULOG_ERROR(k_ELogSteam, "UploadLeaderboardScore(%s) failed, IO failure: %d, retrying in %u ms", k_rgpchLeaderboardNames[m_eLeaderboard], bIOFailure, unRetryMS);
+        return;
+    }
+
+    m_nUploadRetries = 0;
+    if (!m_bUploaded || m_nUploadingScore > m_nBestUploadedScore)
+    {
+        m_nBestUploadedScore = m_nUploadingScore;
+        m_bUploaded = true;
+    }
+    STEAM_Journal::RemoveScores(k_rgpchLeaderboardNames[m_eLeaderboard], m_nUploadingScore);
+
+    if (pScoreUploadedResult->m_bScoreChanged)
+    {
+        ULOG_INFO(k_ELogSteam, "Leaderboard score changed, new global rank: %d", pScoreUploadedResult->m_nGlobalRankNew);
+        m_pOwner->OnScoreChanged(m_eLeaderboard);
+    }
+
+    // Send whatever was queued while this one was on the way
+    RunUploads();
+}
+
 // Constructor
 STEAM_Leaderboards::STEAM_Leaderboards()
 {
-    m_hFastestRunLeaderboard = 0;
-    m_hLongDistanceLeaderboard = 0;
     m_nCurrentLeaderboard = 0;
 
-    m_bLoading = false;
     m_bRenderFastRunLeaderboard = true;
     m_pLeaderboardMenu = nullptr;
 
@@ -496,13 +1087,13 @@ bool STEAM_Leaderboards::init(SDL_Renderer* a_pRenderer)
     m_pLeaderboardMenu = new STEAM_LeaderboardMenu();
     if (!m_pLeaderboardMenu->init(a_pRenderer))
     {
-        // printf("Failed to load the leaderboard menu!\n");
+        ULOG_ERROR(k_ELogSteam, "Failed to load the leaderboard menu!");
         success = false;
     }
 
     if (!m_btnDirectionArrow.init(a_pRenderer, "assets/direction_arrows.png", DIRECTION_BTN_POSITON_1, OPTION_BTN_DIMENSION))
     {
-        // printf("Failed to load the direction arrow button!\n");
+        ULOG_ERROR(k_ELogRender, "Failed to load the direction arrow button!");
         success = false;
     }
 
@@ -534,6 +1125,9 @@ void STEAM_Leaderboards::update()
 // Shows / refreshes leaderboard (depends on current leaderboard status)
 void STEAM_Leaderboards::ShowLeaderboardData()
 {
+    // retry any lookups that failed
+    FindLeaderboards();
+
     if (m_bRenderFastRunLeaderboard)
     {
         ShowFastestRun();
@@ -547,15 +1141,22 @@ void STEAM_Leaderboards::ShowLeaderboardData()
 // Shows / refreshes leaderboard (fastest run)
 void STEAM_Leaderboards::ShowFastestRun()
 {
-    // we want to show the top 10 fastest run. To do so, we request global score data beginning at 0
-    m_pLeaderboardMenu->ShowLeaderboard(m_hFastestRunLeaderboard, k_ELeaderboardDataRequestGlobal);
+    // we want to show the top 10 fastest run, and the user's own entry
+    m_pLeaderboardMenu->ShowLeaderboard(m_rgLeaderboards[k_ELeaderboardFastestRun].m_hSteamLeaderboard);
 }
 
 // Shows / refreshes leaderboard (longest distance)
 void STEAM_Leaderboards::ShowLongestDistance()
 {
-    // we want to show the 10 users around us
-    m_pLeaderboardMenu->ShowLeaderboard(m_hLongDistanceLeaderboard, k_ELeaderboardDataRequestGlobal);
+    // we want to show the top 10 longest distance, and the user's own entry
+    m_pLeaderboardMenu->ShowLeaderboard(m_rgLeaderboards[k_ELeaderboardLongestDistance].m_hSteamLeaderboard);
+}
+
+// Fills the menu with a full page of made up entries and rebuilds it
+void STEAM_Leaderboards::RebuildWithTestData()
+{
+    m_pLeaderboardMenu->LoadTestEntries();
+    m_pLeaderboardMenu->Rebuild();
 }
 
 // Render the leaderboard menu
@@ -576,92 +1177,104 @@ void STEAM_Leaderboards::render()
 void STEAM_Leaderboards::handleEvent(SDL_Event& e)
 {
     m_btnDirectionArrow.handleEvent(e);
-}
 
-// Gets handles for our leaderboards. If the leaderboards doesn't exist, creates them.
-// Each time this is called, we look up another leaderboard.
-void STEAM_Leaderboards::FindLeaderboards()
-{
-    if (m_bLoading)
-        return;
-
-    SteamAPICall_t hSteamAPICall = 0;
+    // The composited table is lost with the render targets
+    if (e.type == SDL_RENDER_TARGETS_RESET)
+    {
+        m_pLeaderboardMenu->InvalidateTable();
+    }
 
-    if (!m_hFastestRunLeaderboard)
+    // Scroll the leaderboard with the mouse wheel, the arrow keys or a page at a time
+    if (e.type == SDL_MOUSEWHEEL)
     {
-        // Find the leaderboard for the fastest run
-        hSteamAPICall = SteamUserStats()->FindLeaderboard(LEADERBOARD_FASTEST_RUN);
+        m_pLeaderboardMenu->Scroll(-e.wheel.y * LEADERBOARD_WHEEL_ROWS);
     }
-    else if (!m_hLongDistanceLeaderboard)
+    else if (e.type == SDL_KEYDOWN)
     {
-        // find/create a leaderboard for the user with the most loops
-        hSteamAPICall = SteamUserStats()->FindLeaderboard(LEADERBOARD_LONGEST_DISTANCE);
+        switch (e.key.keysym.sym)
+        {
+        case SDLK_UP:
+            m_pLeaderboardMenu->Scroll(-1);
+            break;
+        case SDLK_DOWN:
+            m_pLeaderboardMenu->Scroll(1);
+            break;
+        case SDLK_PAGEUP:
+            m_pLeaderboardMenu->Scroll(-LEADERBOARD_PAGE_ROWS);
+            break;
+        case SDLK_PAGEDOWN:
+            m_pLeaderboardMenu->Scroll(LEADERBOARD_PAGE_ROWS);
+            break;
+        default:
+            break;
+        }
     }
+}
 
-    if (hSteamAPICall != 0)
+// Gets handles for our leaderboards. If the leaderboards doesn't exist, creates them.
+// Every board is looked up at once, each with its own call result.
+void STEAM_Leaderboards::FindLeaderboards()
+{
+    for (int i = 0; i < k_ELeaderboardCount; ++i)
     {
-        // set the function to call when this API call has completed
-        m_SteamCallResultCreateLeaderboard.Set(hSteamAPICall, this, &STEAM_Leaderboards::OnFindLeaderboard);
-        m_bLoading = true;
+        m_rgLeaderboards[i].Find(this, static_cast<ELeaderboard>(i));
     }
 }
 
-// Called when SteamUserStats()->FindLeader() returns asynchronously
-void STEAM_Leaderboards::OnFindLeaderboard(LeaderboardFindResult_t *pFindLeaderboardResult, bool bIOFailure)
+// Called by STEAM_LeaderboardHandle once a handle is found, prefetches the board's entries
+// so they're ready before the menu is opened
+void STEAM_Leaderboards::OnFindLeaderboard(ELeaderboard eLeaderboard)
 {
-    m_bLoading = false;
-
-    // see if we encountered an error during the call
-    if (!pFindLeaderboardResult->m_bLeaderboardFound || bIOFailure)
-    {
+    if (!m_pLeaderboardMenu)
         return;
-    }
 
-    // check to see which leaderboard handle we just retrieved
-    const char *pchName = SteamUserStats()->GetLeaderboardName(pFindLeaderboardResult->m_hSteamLeaderboard);
-    if (strcmp(pchName, LEADERBOARD_FASTEST_RUN) == 0)
+    // The board on screen was waiting for its handle, show it now
+    if ((eLeaderboard == k_ELeaderboardFastestRun) == m_bRenderFastRunLeaderboard)
     {
-        m_hFastestRunLeaderboard = pFindLeaderboardResult->m_hSteamLeaderboard;
+        ShowLeaderboardData();
     }
-    else if (strcmp(pchName, LEADERBOARD_LONGEST_DISTANCE) == 0)
+    else
     {
-        m_hLongDistanceLeaderboard = pFindLeaderboardResult->m_hSteamLeaderboard;
+        m_pLeaderboardMenu->Prefetch(m_rgLeaderboards[eLeaderboard].m_hSteamLeaderboard);
     }
-
-    // look up any other leaderboards
-    FindLeaderboards();
- 
 }
 
 // Updates leaderboards with stats from our just finished game
-void STEAM_Leaderboards::UpdateLeaderboards(STEAM_StatsAchievements *pStats)
+void STEAM_Leaderboards::UpdateLeaderboards(STEAM_StatsAchievements *pStats, const int32 *pnSplits, int cSplits)
 {
     // Each game the user finishes update the users longest distance leaderboard entry.
-    if (m_hLongDistanceLeaderboard)
-    {
-        SteamAPICall_t hSteamAPICall = SteamUserStats()->UploadLeaderboardScore(m_hLongDistanceLeaderboard, k_ELeaderboardUploadScoreMethodKeepBest, (int)pStats->getTotalLoops(), NULL, 0);
-        m_SteamCallResultUploadScore.Set(hSteamAPICall, this, &STEAM_Leaderboards::OnUploadScore);
-    }
+    m_rgLeaderboards[k_ELeaderboardLongestDistance].QueueUpload((int)pStats->getTotalLoops(), nullptr, 0);
+
+    // If the user has a new high score update the fast run leaderboard as well, the run's
+    // splits go along in the score details for the pace graph
+    int32 rgnDetails[k_cLeaderboardDetailsMax];
+    int cDetails = STEAM_ScoreDetails::PackSplits(pnSplits, cSplits, rgnDetails, k_cLeaderboardDetailsMax);
+    m_rgLeaderboards[k_ELeaderboardFastestRun].QueueUpload((int)pStats->getLoopsLastRun(), rgnDetails, cDetails);
+}
 
-    // If the user has a new high score update the fast run leaderboard as well
-    if (m_hFastestRunLeaderboard)
+// Send queued scores and retry failed uploads, called every frame
+void STEAM_Leaderboards::RunUploads()
+{
+    for (STEAM_LeaderboardHandle &leaderboard : m_rgLeaderboards)
     {
-        SteamAPICall_t hSteamAPICall = SteamUserStats()->UploadLeaderboardScore(m_hFastestRunLeaderboard, k_ELeaderboardUploadScoreMethodKeepBest, (int)pStats->getLoopsLastRun(), NULL, 0);
-        m_SteamCallResultUploadScore.Set(hSteamAPICall, this, &STEAM_Leaderboards::OnUploadScore);
+        leaderboard.RunUploads();
     }
-
 }
 
-// Called when SteamUserStats(0->UploadLeaderboardScore() returns asynchronously
-void STEAM_Leaderboards::OnUploadScore(LeaderboardScoreUploaded_t *pScoreUploadedResult, bool bIOFailure)
+// Called by STEAM_LeaderboardHandle when an upload changed the user's score, the cached
+// entries are out of date so download them again
+void STEAM_Leaderboards::OnScoreChanged(ELeaderboard eLeaderboard)
 {
-    if (!pScoreUploadedResult->m_bSuccess)
+    if (!m_pLeaderboardMenu)
+        return;
+
+    m_pLeaderboardMenu->Invalidate(m_rgLeaderboards[eLeaderboard].m_hSteamLeaderboard);
+    if ((eLeaderboard == k_ELeaderboardFastestRun) == m_bRenderFastRunLeaderboard)
     {
-        // printf("error\n");
+        ShowLeaderboardData();
     }
-
-    if (pScoreUploadedResult->m_bScoreChanged)
+    else
     {
-        // printf("could display new rank");
+        m_pLeaderboardMenu->Prefetch(m_rgLeaderboards[eLeaderboard].m_hSteamLeaderboard);
     }
 }
\ No newline at end of file
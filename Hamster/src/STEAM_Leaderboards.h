@@ -7,6 +7,7 @@
 */
 #pragma once
 #include "STEAM_StatsAchievements.h"
+#include "STEAM_Async.h"
 #include "GButton.h"
 
 // A leaderboard item
@@ -16,7 +17,68 @@ struct LeaderboardMenuItem_t
     bool m_bNextLeaderboard;
 };
 
+// The leaderboards the game uses, add new boards before k_ELeaderboardCount and name
+// them in k_rgpchLeaderboardNames
+enum ELeaderboard
+{
+    k_ELeaderboardFastestRun,
+    k_ELeaderboardLongestDistance,
+    k_ELeaderboardCount
+};
+
 class STEAM_LeaderboardMenu;
+class STEAM_Leaderboards;
+
+// One of the game's leaderboards. Looks up its handle, each board has its own lookup so they
+// all run at once, and uploads its scores one at a time. Scores queued while an upload is on
+// the way are coalesced into the best one, and failed uploads are retried with backoff.
+class STEAM_LeaderboardHandle
+{
+public:
+    // Constructor
+    STEAM_LeaderboardHandle();
+
+    // Start looking up the handle unless it's known or already being looked up
+    void Find(STEAM_Leaderboards *a_pOwner, ELeaderboard a_eLeaderboard);
+
+    // Queue a score and journal it, it replaces any queued score that isn't as good. The
+    // a_cDetails score details are uploaded with it.
+    void QueueUpload(int32 a_nScore, const int32 *a_pDetails, int a_cDetails);
+
+    // Start the next upload if the board has a queued score and isn't waiting on one
+    void RunUploads();
+
+    // Handle of the leaderboard, 0 until it's found
+    SteamLeaderboard_t m_hSteamLeaderboard;
+
+private:
+    // Queue a score without journaling it
+    void Queue(int32 a_nScore, const int32 *a_pDetails, int a_cDetails);
+
+    // Called when SteamBackend()->FindLeaderboard() returns asynchronously
+    void OnFindLeaderboard(LeaderboardFindResult_t *pFindLeaderboardResult, bool bIOFailure);
+
+    // Called when SteamBackend()->UploadLeaderboardScore() returns asynchronously
+    void OnUploadScore(LeaderboardScoreUploaded_t *pScoreUploadedResult, bool bIOFailure);
+
+    // The lookup and upload on the way, cancelled if the handle goes away first
+    STEAM_AsyncScope m_asyncCalls;
+    bool m_bFinding;               // Waiting on FindLeaderboard()
+    bool m_bUploading;             // Waiting on UploadLeaderboardScore()
+
+    STEAM_Leaderboards *m_pOwner;
+    ELeaderboard m_eLeaderboard;
+
+    bool m_bUploadQueued;          // m_nQueuedScore is waiting to be uploaded
+    int32 m_nQueuedScore;          // Best score queued since the last upload started
+    int32 m_nUploadingScore;       // Score of the upload on the way
+    std::vector<int32> m_rgnQueuedDetails;       // Details of m_nQueuedScore
+    std::vector<int32> m_rgnUploadingDetails;    // Details of m_nUploadingScore
+    bool m_bUploaded;              // m_nBestUploadedScore is valid
+    int32 m_nBestUploadedScore;    // Best score Steam has accepted, lower scores aren't sent
+    int m_nUploadRetries;          // Uploads that failed in a row
+    Uint32 m_unNextUploadTicks;    // Uploads wait until this time after a failure
+};
 
 class STEAM_Leaderboards
 {
@@ -57,25 +119,31 @@ public:
     // Render the leaderboard menu's
     void render();
 
-    // Updates leaderboards with stats from our just finished game
-    void UpdateLeaderboards(STEAM_StatsAchievements *pStats);
+    // Updates leaderboards with stats from our just finished game, pnSplits holds the
+    // keystrokes made in each of its cSplits seconds
+    void UpdateLeaderboards(STEAM_StatsAchievements *pStats, const int32 *pnSplits, int cSplits);
+
+    // Send queued scores and retry failed uploads, called every frame
+    void RunUploads();
+
+    // Fills the menu with a full page of made up entries and rebuilds it, lets the
+    // microbenchmarks time Rebuild() without Steam
+    void RebuildWithTestData();
 
 private:
+    friend class STEAM_LeaderboardHandle;
+
+    // Looks up every leaderboard handle that isn't known yet, all at once
     void FindLeaderboards();
 
-    // Called when SteamUserStats()->FindOrCreateLeaderboard() returns asynchronously
-    void OnFindLeaderboard(LeaderboardFindResult_t *pFindLeaderboardResult, bool bIOFailure);
-    CCallResult<STEAM_Leaderboards, LeaderboardFindResult_t> m_SteamCallResultCreateLeaderboard;
+    // Called by STEAM_LeaderboardHandle once a handle is found, prefetches the board's entries
+    void OnFindLeaderboard(ELeaderboard eLeaderboard);
 
-    // Called when SteamUserStats()->UploadLeaderboardScore() returns asynchronously
-    void OnUploadScore(LeaderboardScoreUploaded_t *pFindLeaderboardResult, bool bIOFailure);
-    CCallResult<STEAM_Leaderboards, LeaderboardScoreUploaded_t> m_SteamCallResultUploadScore;
+    // Called by STEAM_LeaderboardHandle when an upload changed the user's score
+    void OnScoreChanged(ELeaderboard eLeaderboard);
 
     // Handles to our leaderboards
-    SteamLeaderboard_t m_hFastestRunLeaderboard;
-    SteamLeaderboard_t m_hLongDistanceLeaderboard;
-
-    int m_bLoading;                            // True if we're looking up a leaderboard handle
+    STEAM_LeaderboardHandle m_rgLeaderboards[k_ELeaderboardCount];
 
     STEAM_LeaderboardMenu* m_pLeaderboardMenu; // Displays the current leaderboard
     int m_nCurrentLeaderboard;                 // Index for leaderboard the user is currently viewing 
@@ -0,0 +1,1397 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_LocalBackend.cpp
+*/
+#include "STEAM_LocalBackend.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// The app id the local backend reports
+#define LOCAL_APP_ID 1583410
+
+// Made up avatars are this wide and tall, like Steam's small avatars
+#define LOCAL_AVATAR_SIZE 32
+
+// Account id of the local player, made up players count up from LOCAL_FIRST_MADE_UP_ID
+#define LOCAL_PLAYER_ID 1
+#define LOCAL_FIRST_MADE_UP_ID 1000
+
+// Average made up score, scores fall off exponentially like the real boards
+#define LOCAL_MEAN_SCORE 40.0
+
+// Downloads older than this many requests are freed
+#define LOCAL_MAX_DOWNLOADS 32
+
+// The state file is rewritten at most this often, changes in between are written together
+#define LOCAL_SAVE_MS 1000
+
+// Connection requests are resent this often until they're answered or time out
+#define LOCAL_NET_CONNECT_RETRY_MS 250
+#define LOCAL_NET_CONNECT_TIMEOUT_MS 10000
+
+// Connected sockets send a keepalive when they've been quiet this long, and time out when
+// they haven't heard from the peer for LOCAL_NET_TIMEOUT_MS
+#define LOCAL_NET_KEEPALIVE_MS 1000
+#define LOCAL_NET_TIMEOUT_MS 10000
+
+// Biggest message that can be sent, messages go out as one datagram each
+#define LOCAL_NET_MAX_MESSAGE 1200
+
+namespace
+{
+    // The first byte of every datagram the local networking sockets send
+    enum ELocalDatagram
+    {
+        k_ELocalDatagramConnect = 1,
+        k_ELocalDatagramAccept,
+        k_ELocalDatagramData,      // Followed by the send flags and the message
+        k_ELocalDatagramClose,
+        k_ELocalDatagramKeepalive
+    };
+
+    // Messages handed out by ReceiveMessagesOnConnection(), freed by Release()
+    struct LocalMessage_t : public SteamNetworkingMessage_t
+    {
+        std::vector<uint8> m_rgubData;
+
+        static void Release(SteamNetworkingMessage_t *pMessage)
+        {
+            delete static_cast<LocalMessage_t *>(pMessage);
+        }
+    };
+
+    void closeSocket(intptr_t socketHandle)
+    {
+#ifdef _WIN32
+        closesocket(static_cast<SOCKET>(socketHandle));
+#else
+        close(static_cast<int>(socketHandle));
+#endif
+    }
+
+    // Open a non blocking UDP socket bound to unPort, 0 picks any free port. -1 on failure.
+    intptr_t openSocket(uint16 unPort)
+    {
+#ifdef _WIN32
+        static bool s_bWinsockStarted = false;
+        if (!s_bWinsockStarted)
+        {
+            WSADATA wsaData;
+            if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+                return -1;
+            s_bWinsockStarted = true;
+        }
+
+        SOCKET socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (socketHandle == INVALID_SOCKET)
+            return -1;
+        u_long ulNonBlocking = 1;
+        ioctlsocket(socketHandle, FIONBIO, &ulNonBlocking);
+#else
+        int socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (socketHandle < 0)
+            return -1;
+        fcntl(socketHandle, F_SETFL, fcntl(socketHandle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(unPort);
+        if (bind(socketHandle, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            closeSocket(static_cast<intptr_t>(socketHandle));
+            return -1;
+        }
+        return static_cast<intptr_t>(socketHandle);
+    }
+
+    // Send one datagram, addresses that aren't IPv4 are sent to loopback
+    void sendTo(intptr_t socketHandle, const SteamNetworkingIPAddr &addrTo, const void *pvData, int cubData)
+    {
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(addrTo.IsIPv4() ? addrTo.GetIPv4() : INADDR_LOOPBACK);
+        addr.sin_port = htons(addrTo.m_port);
+#ifdef _WIN32
+        sendto(static_cast<SOCKET>(socketHandle), static_cast<const char *>(pvData), cubData, 0, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+#else
+        sendto(static_cast<int>(socketHandle), pvData, cubData, 0, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+#endif
+    }
+
+    // Read one datagram, returns its size, -1 when nothing is waiting and -2 for a datagram
+    // that couldn't be read, e.g. Windows reporting an earlier send as unreachable
+    int receiveFrom(intptr_t socketHandle, uint8 *pubBuffer, int cubBuffer, SteamNetworkingIPAddr *pAddrFrom)
+    {
+        sockaddr_in addr;
+#ifdef _WIN32
+        int cubAddr = sizeof(addr);
+        int cubRead = recvfrom(static_cast<SOCKET>(socketHandle), reinterpret_cast<char *>(pubBuffer), cubBuffer, 0, reinterpret_cast<sockaddr *>(&addr), &cubAddr);
+        if (cubRead < 0)
+            return WSAGetLastError() == WSAEWOULDBLOCK ? -1 : -2;
+#else
+        socklen_t cubAddr = sizeof(addr);
+        int cubRead = static_cast<int>(recvfrom(static_cast<int>(socketHandle), pubBuffer, cubBuffer, 0, reinterpret_cast<sockaddr *>(&addr), &cubAddr));
+        if (cubRead < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK ? -1 : -2;
+#endif
+        pAddrFrom->SetIPv4(ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port));
+        return cubRead;
+    }
+
+    // Send a datagram that's only its type
+    void sendDatagram(intptr_t socketHandle, const SteamNetworkingIPAddr &addrTo, ELocalDatagram eDatagram)
+    {
+        uint8 ubType = static_cast<uint8>(eDatagram);
+        sendTo(socketHandle, addrTo, &ubType, 1);
+    }
+}
+
+STEAM_LocalBackend::STEAM_LocalBackend(const STEAM_LocalConfig_t &config)
+    :
+    m_config(config),
+    m_rng(config.m_unSeed),
+    m_sPersonaName("Local Player"),
+    m_bSaveDirty(false),
+    m_unLastSaveTicks(0),
+    m_hNextDownload(1),
+    m_hNextAPICall(1),
+    m_unNextNetHandle(1),
+    m_rngNet(config.m_unSeed + 1),
+    m_hInputStep(0),
+    m_ulInputStartCounter(0),
+    m_iNextName(0)
+{
+    memset(m_rgchNames, 0, sizeof(m_rgchNames));
+}
+
+// Parse the command line, returns true if the local backend was requested
+bool STEAM_LocalBackend::ParseArgs(int argc, char *args[], STEAM_LocalConfig_t &config)
+{
+    bool bRequested = false;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        const char *pchValue = args[i + 1];
+        if (strcmp(args[i], "--local-steam") == 0)
+        {
+            config.m_sPath = pchValue;
+            bRequested = true;
+        }
+        else if (strcmp(args[i], "--steam-latency") == 0)
+        {
+            // "<ms>" for a fixed latency, "<min>-<max>" for a range
+            config.m_unLatencyMinMS = static_cast<Uint32>(atoi(pchValue));
+            const char *pchMax = strchr(pchValue, '-');
+            config.m_unLatencyMaxMS = pchMax ? static_cast<Uint32>(atoi(pchMax + 1)) : config.m_unLatencyMinMS;
+            config.m_unLatencyMaxMS = SDL_max(config.m_unLatencyMaxMS, config.m_unLatencyMinMS);
+        }
+        else if (strcmp(args[i], "--steam-failure-rate") == 0)
+        {
+            config.m_flFailureRate = SDL_min(SDL_max(static_cast<float>(atof(pchValue)), 0.f), 1.f);
+        }
+        else if (strcmp(args[i], "--steam-entries") == 0)
+        {
+            config.m_nLeaderboardEntries = SDL_max(atoi(pchValue), 0);
+        }
+        else if (strcmp(args[i], "--steam-seed") == 0)
+        {
+            config.m_unSeed = static_cast<Uint32>(strtoul(pchValue, nullptr, 10));
+        }
+        else if (strcmp(args[i], "--steam-cloud") == 0)
+        {
+            config.m_bCloudEnabled = atoi(pchValue) != 0;
+        }
+        else if (strcmp(args[i], "--net-latency") == 0)
+        {
+            // "<ms>" for a fixed latency, "<min>-<max>" for a range
+            config.m_unNetLatencyMinMS = static_cast<Uint32>(atoi(pchValue));
+            const char *pchMax = strchr(pchValue, '-');
+            config.m_unNetLatencyMaxMS = pchMax ? static_cast<Uint32>(atoi(pchMax + 1)) : config.m_unNetLatencyMinMS;
+            config.m_unNetLatencyMaxMS = SDL_max(config.m_unNetLatencyMaxMS, config.m_unNetLatencyMinMS);
+        }
+        else if (strcmp(args[i], "--net-loss") == 0)
+        {
+            config.m_flNetLossRate = SDL_min(SDL_max(static_cast<float>(atof(pchValue)), 0.f), 1.f);
+        }
+        else if (strcmp(args[i], "--steam-input") == 0)
+        {
+            // "<presses/s>" or "<presses/s>:<press ms>"
+            config.m_flInputMashRate = SDL_max(static_cast<float>(atof(pchValue)), 0.f);
+            const char *pchPress = strchr(pchValue, ':');
+            if (pchPress)
+            {
+                config.m_unInputPressMS = static_cast<Uint32>(SDL_max(atoi(pchPress + 1), 1));
+            }
+        }
+    }
+    return bRequested;
+}
+
+// Load the saved state and build the leaderboards
+bool STEAM_LocalBackend::Init()
+{
+    if (!Load())
+        return false;
+
+    ULOG_INFO(k_ELogSteam, "Local Steam backend: %s, latency %u-%u ms, failure rate %.2f, %d made up entries per leaderboard",
+        m_config.m_sPath, m_config.m_unLatencyMinMS, m_config.m_unLatencyMaxMS, m_config.m_flFailureRate, m_config.m_nLeaderboardEntries);
+    return true;
+}
+
+// Save the state, close the sockets and drop anything still in flight
+void STEAM_LocalBackend::Shutdown()
+{
+    Save();
+    {
+        std::lock_guard<std::mutex> lock(m_mutexNet);
+        for (std::pair<const HSteamNetConnection, NetConnection_t> &connection : m_mapConnections)
+        {
+            if (connection.second.m_eState == k_ESteamNetworkingConnectionState_Connected)
+                sendDatagram(connection.second.m_socket, connection.second.m_addrRemote, k_ELocalDatagramClose);
+            if (!connection.second.m_hListenSocket)
+                closeSocket(connection.second.m_socket);
+        }
+        for (std::pair<const HSteamListenSocket, intptr_t> &listenSocket : m_mapListenSockets)
+        {
+            closeSocket(listenSocket.second);
+        }
+        m_mapConnections.clear();
+        m_mapListenSockets.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutexPending);
+    m_rgPending.clear();
+    m_mapDownloads.clear();
+    m_mapCloudReads.clear();
+}
+
+// Write the state file if it changed, at most once every LOCAL_SAVE_MS
+void STEAM_LocalBackend::RunFrame()
+{
+    if (m_bSaveDirty && SDL_GetTicks() - m_unLastSaveTicks >= LOCAL_SAVE_MS)
+    {
+        Save();
+    }
+}
+
+// Read the sockets, then copy out the callbacks and call results whose latency has passed
+void STEAM_LocalBackend::Poll(std::vector<STEAM_Message_t> &rgMessages)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutexNet);
+        if (!m_mapListenSockets.empty() || !m_mapConnections.empty())
+            PumpNetwork();
+    }
+
+    std::vector<Pending_t> rgDue;
+    {
+        std::lock_guard<std::mutex> lock(m_mutexPending);
+        if (m_rgPending.empty())
+            return;
+
+        Uint32 unNow = SDL_GetTicks();
+        for (auto it = m_rgPending.begin(); it != m_rgPending.end();)
+        {
+            if (static_cast<Sint32>(unNow - it->m_unDueTicks) >= 0)
+            {
+                rgDue.push_back(std::move(*it));
+                it = m_rgPending.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    std::stable_sort(rgDue.begin(), rgDue.end(), [](const Pending_t &a, const Pending_t &b)
+        {
+            return static_cast<Sint32>(a.m_unDueTicks - b.m_unDueTicks) < 0;
+        });
+
+    Uint64 unPolledTicks = SDL_GetPerformanceCounter();
+    for (Pending_t &pending : rgDue)
+    {
+        STEAM_Message_t message;
+        message.m_iCallback = pending.m_iCallback;
+        message.m_hAPICall = pending.m_hAPICall;
+        message.m_bIOFailure = pending.m_bIOFailure;
+        message.m_unPolledTicks = unPolledTicks;
+        message.m_rgubParam.swap(pending.m_rgubParam);
+        rgMessages.push_back(std::move(message));
+    }
+}
+
+uint32 STEAM_LocalBackend::GetAppID()
+{
+    return LOCAL_APP_ID;
+}
+
+// Every made up avatar is LOCAL_AVATAR_SIZE square
+bool STEAM_LocalBackend::GetImageSize(int iImage, uint32 *pnWidth, uint32 *pnHeight)
+{
+    if (iImage <= 0)
+        return false;
+
+    *pnWidth = LOCAL_AVATAR_SIZE;
+    *pnHeight = LOCAL_AVATAR_SIZE;
+    return true;
+}
+
+// Draws a mirrored 5x5 pattern in a colour picked from the account id. Only reads iImage so
+// it's safe to call from any thread.
+bool STEAM_LocalBackend::GetImageRGBA(int iImage, uint8 *pubDest, int nDestBufferSize)
+{
+    if (iImage <= 0 || nDestBufferSize < LOCAL_AVATAR_SIZE * LOCAL_AVATAR_SIZE * 4)
+        return false;
+
+    Uint32 unHash = static_cast<Uint32>(iImage) * 2654435761u;
+    const uint8 rgubColour[4] = { static_cast<uint8>(64 + (unHash & 0x7F)), static_cast<uint8>(64 + ((unHash >> 8) & 0x7F)), static_cast<uint8>(64 + ((unHash >> 16) & 0x7F)), 0xFF };
+    const uint8 rgubBackground[4] = { 0xE0, 0xE0, 0xE0, 0xFF };
+
+    const int nCell = (LOCAL_AVATAR_SIZE + 4) / 5;
+    for (int y = 0; y < LOCAL_AVATAR_SIZE; ++y)
+    {
+        for (int x = 0; x < LOCAL_AVATAR_SIZE; ++x)
+        {
+            int nColumn = MIN(x / nCell, 4 - x / nCell);
+            bool bFilled = (unHash >> (nColumn * 5 + y / nCell)) & 1;
+            memcpy(pubDest + (y * LOCAL_AVATAR_SIZE + x) * 4, bFilled ? rgubColour : rgubBackground, 4);
+        }
+    }
+    return true;
+}
+
+CSteamID STEAM_LocalBackend::GetSteamID()
+{
+    return MakeSteamID(LOCAL_PLAYER_ID);
+}
+
+const char *STEAM_LocalBackend::GetPersonaName()
+{
+    return m_sPersonaName.c_str();
+}
+
+// The local player's name, or a made up one
+const char *STEAM_LocalBackend::GetFriendPersonaName(CSteamID steamIDFriend)
+{
+    if (steamIDFriend.GetAccountID() == LOCAL_PLAYER_ID)
+        return m_sPersonaName.c_str();
+
+    char *pchName = m_rgchNames[m_iNextName];
+    m_iNextName = (m_iNextName + 1) % static_cast<int>(SDL_arraysize(m_rgchNames));
+    snprintf(pchName, sizeof(m_rgchNames[0]), "Hamster %u", steamIDFriend.GetAccountID());
+    return pchName;
+}
+
+// Made up avatars are handled by account id. The first time a player's avatar is asked for
+// it's still loading and AvatarImageLoaded_t is posted once it "arrives".
+int STEAM_LocalBackend::GetSmallFriendAvatar(CSteamID steamIDFriend)
+{
+    uint32 unAccountID = steamIDFriend.GetAccountID();
+    if (m_setAvatarsRequested.insert(unAccountID).second)
+    {
+        AvatarImageLoaded_t callback;
+        callback.m_steamID = steamIDFriend;
+        callback.m_iImage = static_cast<int>(unAccountID);
+        callback.m_iWide = LOCAL_AVATAR_SIZE;
+        callback.m_iTall = LOCAL_AVATAR_SIZE;
+        Post(callback);
+        return -1;
+    }
+    return static_cast<int>(unAccountID);
+}
+
+// Posts UserStatsReceived_t
+bool STEAM_LocalBackend::RequestCurrentStats()
+{
+    UserStatsReceived_t callback;
+    callback.m_nGameID = CGameID(LOCAL_APP_ID).ToUint64();
+    callback.m_eResult = RollFailure() ? k_EResultFail : k_EResultOK;
+    callback.m_steamIDUser = MakeSteamID(LOCAL_PLAYER_ID);
+    Post(callback);
+    return true;
+}
+
+// Stats that were never set read as 0
+bool STEAM_LocalBackend::GetStat(const char *pchName, int32 *pData)
+{
+    auto it = m_mapStats.find(pchName);
+    *pData = it != m_mapStats.end() ? it->second : 0;
+    return true;
+}
+
+bool STEAM_LocalBackend::SetStat(const char *pchName, int32 nData)
+{
+    m_mapStats[pchName] = nData;
+    return true;
+}
+
+bool STEAM_LocalBackend::GetAchievement(const char *pchName, bool *pbAchieved)
+{
+    auto it = m_mapAchievements.find(pchName);
+    *pbAchieved = it != m_mapAchievements.end() && it->second;
+    return true;
+}
+
+// Unlocked achievements are announced by the next StoreStats()
+bool STEAM_LocalBackend::SetAchievement(const char *pchName)
+{
+    bool &bAchieved = m_mapAchievements[pchName];
+    if (!bAchieved)
+    {
+        bAchieved = true;
+        m_rgNewAchievements.push_back(pchName);
+    }
+    return true;
+}
+
+// There's no schema, the api name stands in for the display name
+const char *STEAM_LocalBackend::GetAchievementDisplayAttribute(const char *pchName, const char *pchKey)
+{
+    if (strcmp(pchKey, "name") == 0)
+        return pchName;
+    if (strcmp(pchKey, "hidden") == 0)
+        return "0";
+    return "";
+}
+
+// Posts UserStatsStored_t and a UserAchievementStored_t per new achievement, the file is
+// written by the next RunFrame()
+bool STEAM_LocalBackend::StoreStats()
+{
+    UserStatsStored_t callback;
+    callback.m_nGameID = CGameID(LOCAL_APP_ID).ToUint64();
+    callback.m_eResult = RollFailure() ? k_EResultFail : k_EResultOK;
+    Post(callback);
+
+    if (callback.m_eResult == k_EResultOK)
+    {
+        m_bSaveDirty = true;
+        for (const std::string &sAchievement : m_rgNewAchievements)
+        {
+            UserAchievementStored_t achievementStored;
+            memset(&achievementStored, 0, sizeof(achievementStored));
+            achievementStored.m_nGameID = callback.m_nGameID;
+            snprintf(achievementStored.m_rgchAchievementName, sizeof(achievementStored.m_rgchAchievementName), "%s", sAchievement.c_str());
+            Post(achievementStored);
+        }
+        m_rgNewAchievements.clear();
+    }
+    return true;
+}
+
+bool STEAM_LocalBackend::ResetAllStats(bool bAchievementsToo)
+{
+    m_mapStats.clear();
+    if (bAchievementsToo)
+    {
+        m_mapAchievements.clear();
+        m_rgNewAchievements.clear();
+    }
+    m_bSaveDirty = true;
+    return true;
+}
+
+// Posts LeaderboardFindResult_t. Unknown leaderboards are created, like FindOrCreateLeaderboard
+SteamAPICall_t STEAM_LocalBackend::FindLeaderboard(const char *pchLeaderboardName)
+{
+    const Leaderboard_t &leaderboard = FindOrCreateLeaderboard(pchLeaderboardName);
+
+    LeaderboardFindResult_t result;
+    result.m_hSteamLeaderboard = static_cast<SteamLeaderboard_t>(&leaderboard - m_rgLeaderboards.data()) + 1;
+    result.m_bLeaderboardFound = 1;
+
+    SteamAPICall_t hAPICall = NextAPICall();
+    Post(result, hAPICall, RollFailure());
+    return hAPICall;
+}
+
+const char *STEAM_LocalBackend::GetLeaderboardName(SteamLeaderboard_t hSteamLeaderboard)
+{
+    Leaderboard_t *pLeaderboard = GetLeaderboard(hSteamLeaderboard);
+    return pLeaderboard ? pLeaderboard->m_sName.c_str() : "";
+}
+
+int STEAM_LocalBackend::GetLeaderboardEntryCount(SteamLeaderboard_t hSteamLeaderboard)
+{
+    Leaderboard_t *pLeaderboard = GetLeaderboard(hSteamLeaderboard);
+    return pLeaderboard ? GetScoreCount(*pLeaderboard) : 0;
+}
+
+// Copies the requested range out of the leaderboard and posts LeaderboardScoresDownloaded_t.
+// Ranges are 1 based like Steam's, around user ranges are relative to the player's entry.
+SteamAPICall_t STEAM_LocalBackend::DownloadLeaderboardEntries(SteamLeaderboard_t hSteamLeaderboard, ELeaderboardDataRequest eLeaderboardDataRequest, int nRangeStart, int nRangeEnd)
+{
+    Leaderboard_t *pLeaderboard = GetLeaderboard(hSteamLeaderboard);
+    if (!pLeaderboard)
+        return k_uAPICallInvalid;
+
+    int cScores = GetScoreCount(*pLeaderboard);
+    int nFirst = 0, nLast = -1;
+    int iPlayer = pLeaderboard->m_iPlayerScore;
+    switch (eLeaderboardDataRequest)
+    {
+    case k_ELeaderboardDataRequestGlobal:
+        nFirst = SDL_max(nRangeStart, 1) - 1;
+        nLast = SDL_min(nRangeEnd, cScores) - 1;
+        break;
+
+    case k_ELeaderboardDataRequestGlobalAroundUser:
+        if (iPlayer >= 0)
+        {
+            nFirst = SDL_max(iPlayer + nRangeStart, 0);
+            nLast = SDL_min(iPlayer + nRangeEnd, cScores - 1);
+        }
+        break;
+
+    // Only the local player is a friend
+    default:
+        if (iPlayer >= 0)
+        {
+            nFirst = nLast = iPlayer;
+        }
+        break;
+    }
+
+    // A failed download comes back empty
+    bool bIOFailure = RollFailure();
+    if (bIOFailure)
+    {
+        nLast = nFirst - 1;
+    }
+
+    // Keep the entries around for GetDownloadedLeaderboardEntry(), dropping old downloads
+    SteamLeaderboardEntries_t hEntries = m_hNextDownload++;
+    std::vector<DownloadedEntry_t> &rgEntries = m_mapDownloads[hEntries];
+    for (int i = nFirst; i <= nLast; ++i)
+    {
+        const Score_t &score = GetScore(*pLeaderboard, i);
+        LeaderboardEntry_t entry = {};
+        entry.m_steamIDUser = MakeSteamID(score.m_unAccountID);
+        entry.m_nGlobalRank = i + 1;
+        entry.m_nScore = score.m_nScore;
+        entry.m_cDetails = static_cast<int32>(score.m_rgnDetails.size());
+        entry.m_hUGC = k_UGCHandleInvalid;
+
+        DownloadedEntry_t downloaded;
+        downloaded.m_entry = entry;
+        downloaded.m_rgnDetails = score.m_rgnDetails;
+        rgEntries.push_back(std::move(downloaded));
+    }
+    m_mapDownloads.erase(hEntries - LOCAL_MAX_DOWNLOADS);
+
+    LeaderboardScoresDownloaded_t result;
+    result.m_hSteamLeaderboard = hSteamLeaderboard;
+    result.m_hSteamLeaderboardEntries = hEntries;
+    result.m_cEntryCount = static_cast<int>(rgEntries.size());
+
+    SteamAPICall_t hAPICall = NextAPICall();
+    Post(result, hAPICall, bIOFailure);
+    return hAPICall;
+}
+
+bool STEAM_LocalBackend::GetDownloadedLeaderboardEntry(SteamLeaderboardEntries_t hSteamLeaderboardEntries, int index, LeaderboardEntry_t *pLeaderboardEntry, int32 *pDetails, int cDetailsMax)
+{
+    auto it = m_mapDownloads.find(hSteamLeaderboardEntries);
+    if (it == m_mapDownloads.end() || index < 0 || index >= static_cast<int>(it->second.size()))
+        return false;
+
+    // Like Steam, only as many details as fit are copied but m_cDetails says how many there are
+    const DownloadedEntry_t &downloaded = it->second[index];
+    *pLeaderboardEntry = downloaded.m_entry;
+    if (pDetails)
+    {
+        std::copy(downloaded.m_rgnDetails.begin(), downloaded.m_rgnDetails.begin() + SDL_min(cDetailsMax, static_cast<int>(downloaded.m_rgnDetails.size())), pDetails);
+    }
+    return true;
+}
+
+// Moves the player's entry, along with its details, and posts LeaderboardScoreUploaded_t
+SteamAPICall_t STEAM_LocalBackend::UploadLeaderboardScore(SteamLeaderboard_t hSteamLeaderboard, ELeaderboardUploadScoreMethod eLeaderboardUploadScoreMethod, int32 nScore, const int32 *pScoreDetails, int cScoreDetailsCount)
+{
+    Leaderboard_t *pLeaderboard = GetLeaderboard(hSteamLeaderboard);
+    if (!pLeaderboard || cScoreDetailsCount < 0 || cScoreDetailsCount > k_cLeaderboardDetailsMax)
+        return k_uAPICallInvalid;
+
+    LeaderboardScoreUploaded_t result;
+    memset(&result, 0, sizeof(result));
+    result.m_hSteamLeaderboard = hSteamLeaderboard;
+    result.m_nScore = nScore;
+
+    SteamAPICall_t hAPICall = NextAPICall();
+    if (RollFailure())
+    {
+        Post(result, hAPICall, true);
+        return hAPICall;
+    }
+
+    int iPrevious = pLeaderboard->m_iPlayerScore;
+    result.m_bSuccess = 1;
+    result.m_nGlobalRankPrevious = iPrevious + 1;
+    if (iPrevious < 0 || eLeaderboardUploadScoreMethod == k_ELeaderboardUploadScoreMethodForceUpdate || nScore > pLeaderboard->m_playerScore.m_nScore)
+    {
+        std::vector<int32> rgnDetails;
+        if (cScoreDetailsCount > 0)
+        {
+            rgnDetails.assign(pScoreDetails, pScoreDetails + cScoreDetailsCount);
+        }
+        SetPlayerScore(*pLeaderboard, nScore, rgnDetails);
+        result.m_bScoreChanged = 1;
+        m_bSaveDirty = true;
+    }
+    result.m_nGlobalRankNew = pLeaderboard->m_iPlayerScore + 1;
+
+    Post(result, hAPICall, false);
+    return hAPICall;
+}
+
+bool STEAM_LocalBackend::IsCloudEnabledForAccount()
+{
+    return m_config.m_bCloudEnabled;
+}
+
+bool STEAM_LocalBackend::IsCloudEnabledForApp()
+{
+    return m_config.m_bCloudEnabled;
+}
+
+bool STEAM_LocalBackend::FileExists(const char *pchFile)
+{
+    return m_mapCloudFiles.count(pchFile) != 0;
+}
+
+int32 STEAM_LocalBackend::GetFileSize(const char *pchFile)
+{
+    auto it = m_mapCloudFiles.find(pchFile);
+    return it != m_mapCloudFiles.end() ? static_cast<int32>(it->second.size()) : 0;
+}
+
+// Replaces the file straight away, like the Steam client's local copy, and posts
+// RemoteStorageFileWriteAsyncComplete_t once the "upload" is done. The state file is written
+// by the next RunFrame().
+SteamAPICall_t STEAM_LocalBackend::FileWriteAsync(const char *pchFile, const void *pvData, uint32 cubData)
+{
+    if (!m_config.m_bCloudEnabled || pvData == nullptr)
+        return k_uAPICallInvalid;
+
+    RemoteStorageFileWriteAsyncComplete_t result;
+    result.m_eResult = k_EResultOK;
+
+    SteamAPICall_t hAPICall = NextAPICall();
+    bool bIOFailure = RollFailure();
+    if (!bIOFailure)
+    {
+        const uint8 *pubData = static_cast<const uint8 *>(pvData);
+        m_mapCloudFiles[pchFile].assign(pubData, pubData + cubData);
+        m_bSaveDirty = true;
+    }
+    Post(result, hAPICall, bIOFailure);
+    return hAPICall;
+}
+
+// Copies the range out now, FileReadAsyncComplete() hands it over once the result is posted
+SteamAPICall_t STEAM_LocalBackend::FileReadAsync(const char *pchFile, uint32 nOffset, uint32 cubToRead)
+{
+    auto it = m_mapCloudFiles.find(pchFile);
+    if (!m_config.m_bCloudEnabled || it == m_mapCloudFiles.end() || nOffset > it->second.size())
+        return k_uAPICallInvalid;
+
+    const std::vector<uint8> &rgubFile = it->second;
+    uint32 cubRead = SDL_min(cubToRead, static_cast<uint32>(rgubFile.size()) - nOffset);
+
+    RemoteStorageFileReadAsyncComplete_t result;
+    result.m_hFileReadAsync = NextAPICall();
+    result.m_eResult = k_EResultOK;
+    result.m_nOffset = nOffset;
+    result.m_cubRead = cubRead;
+
+    m_mapCloudReads[result.m_hFileReadAsync].assign(rgubFile.begin() + nOffset, rgubFile.begin() + nOffset + cubRead);
+    Post(result, result.m_hFileReadAsync, RollFailure());
+    return result.m_hFileReadAsync;
+}
+
+// Hand over the bytes a finished read copied out, each read can only be collected once
+bool STEAM_LocalBackend::FileReadAsyncComplete(SteamAPICall_t hReadCall, void *pvBuffer, uint32 cubToRead)
+{
+    auto it = m_mapCloudReads.find(hReadCall);
+    if (it == m_mapCloudReads.end() || cubToRead < it->second.size())
+        return false;
+
+    if (!it->second.empty())
+        memcpy(pvBuffer, it->second.data(), it->second.size());
+    m_mapCloudReads.erase(it);
+    return true;
+}
+
+// Listens for connections on localAddress's port
+HSteamListenSocket STEAM_LocalBackend::CreateListenSocketIP(const SteamNetworkingIPAddr &localAddress)
+{
+    intptr_t socketHandle = openSocket(localAddress.m_port);
+    if (socketHandle < 0)
+    {
+        ULOG_ERROR(k_ELogSteam, "Unable to listen on UDP port %u", static_cast<unsigned>(localAddress.m_port));
+        return k_HSteamListenSocket_Invalid;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutexNet);
+    HSteamListenSocket hSocket = m_unNextNetHandle++;
+    m_mapListenSockets[hSocket] = socketHandle;
+    return hSocket;
+}
+
+// Opens a socket of its own and keeps asking address to accept until it does or time runs out
+HSteamNetConnection STEAM_LocalBackend::ConnectByIPAddress(const SteamNetworkingIPAddr &address)
+{
+    intptr_t socketHandle = openSocket(0);
+    if (socketHandle < 0)
+    {
+        ULOG_ERROR(k_ELogSteam, "Unable to open a UDP socket");
+        return k_HSteamNetConnection_Invalid;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutexNet);
+    Uint32 unNow = SDL_GetTicks();
+    HSteamNetConnection hConn = m_unNextNetHandle++;
+    NetConnection_t &connection = m_mapConnections[hConn];
+    connection.m_hListenSocket = k_HSteamListenSocket_Invalid;
+    connection.m_eState = k_ESteamNetworkingConnectionState_None;
+    connection.m_socket = socketHandle;
+    connection.m_addrRemote = address;
+    connection.m_unNextConnectTicks = unNow + LOCAL_NET_CONNECT_RETRY_MS;
+    connection.m_unConnectDeadlineTicks = unNow + LOCAL_NET_CONNECT_TIMEOUT_MS;
+    connection.m_unLastReceivedTicks = unNow;
+    connection.m_unLastSentTicks = unNow;
+    connection.m_nNextMessageNumber = 1;
+
+    sendDatagram(socketHandle, address, k_ELocalDatagramConnect);
+    SetConnectionState(hConn, connection, k_ESteamNetworkingConnectionState_Connecting, 0, nullptr);
+    return hConn;
+}
+
+// Answers a connection request that came in on a listen socket
+EResult STEAM_LocalBackend::AcceptConnection(HSteamNetConnection hConn)
+{
+    std::lock_guard<std::mutex> lock(m_mutexNet);
+    auto it = m_mapConnections.find(hConn);
+    if (it == m_mapConnections.end() || !it->second.m_hListenSocket)
+        return k_EResultInvalidParam;
+    if (it->second.m_eState != k_ESteamNetworkingConnectionState_Connecting)
+        return k_EResultInvalidState;
+
+    NetConnection_t &connection = it->second;
+    sendDatagram(connection.m_socket, connection.m_addrRemote, k_ELocalDatagramAccept);
+    connection.m_unLastReceivedTicks = connection.m_unLastSentTicks = SDL_GetTicks();
+    SetConnectionState(hConn, connection, k_ESteamNetworkingConnectionState_Connected, 0, nullptr);
+    return k_EResultOK;
+}
+
+// Tells the peer and frees the handle, no callback is posted for a connection the game closed
+bool STEAM_LocalBackend::CloseConnection(HSteamNetConnection hPeer, int nReason, const char *pszDebug, bool bEnableLinger)
+{
+    std::lock_guard<std::mutex> lock(m_mutexNet);
+    auto it = m_mapConnections.find(hPeer);
+    if (it == m_mapConnections.end())
+        return false;
+
+    NetConnection_t &connection = it->second;
+    if (connection.m_eState == k_ESteamNetworkingConnectionState_Connected || connection.m_eState == k_ESteamNetworkingConnectionState_Connecting)
+        sendDatagram(connection.m_socket, connection.m_addrRemote, k_ELocalDatagramClose);
+    if (!connection.m_hListenSocket)
+        closeSocket(connection.m_socket);
+    m_mapConnections.erase(it);
+    return true;
+}
+
+// Closes the socket and every connection accepted on it
+bool STEAM_LocalBackend::CloseListenSocket(HSteamListenSocket hSocket)
+{
+    std::lock_guard<std::mutex> lock(m_mutexNet);
+    auto itSocket = m_mapListenSockets.find(hSocket);
+    if (itSocket == m_mapListenSockets.end())
+        return false;
+
+    for (auto it = m_mapConnections.begin(); it != m_mapConnections.end();)
+    {
+        if (it->second.m_hListenSocket != hSocket)
+        {
+            ++it;
+            continue;
+        }
+        if (it->second.m_eState == k_ESteamNetworkingConnectionState_Connected)
+            sendDatagram(it->second.m_socket, it->second.m_addrRemote, k_ELocalDatagramClose);
+        it = m_mapConnections.erase(it);
+    }
+    closeSocket(itSocket->second);
+    m_mapListenSockets.erase(itSocket);
+    return true;
+}
+
+// Sends the message as a single datagram. Loss and latency are simulated by the receiver.
+EResult STEAM_LocalBackend::SendMessageToConnection(HSteamNetConnection hConn, const void *pData, uint32 cbData, int nSendFlags, int64 *pOutMessageNumber)
+{
+    if (cbData > LOCAL_NET_MAX_MESSAGE)
+        return k_EResultLimitExceeded;
+
+    std::lock_guard<std::mutex> lock(m_mutexNet);
+    auto it = m_mapConnections.find(hConn);
+    if (it == m_mapConnections.end())
+        return k_EResultInvalidParam;
+    if (it->second.m_eState != k_ESteamNetworkingConnectionState_Connected)
+        return it->second.m_eState == k_ESteamNetworkingConnectionState_Connecting ? k_EResultInvalidState : k_EResultNoConnection;
+
+    NetConnection_t &connection = it->second;
+    uint8 rgubDatagram[2 + LOCAL_NET_MAX_MESSAGE];
+    rgubDatagram[0] = k_ELocalDatagramData;
+    rgubDatagram[1] = static_cast<uint8>(nSendFlags & k_nSteamNetworkingSend_Reliable);
+    if (cbData)
+        memcpy(rgubDatagram + 2, pData, cbData);
+    sendTo(connection.m_socket, connection.m_addrRemote, rgubDatagram, static_cast<int>(cbData) + 2);
+    connection.m_unLastSentTicks = SDL_GetTicks();
+
+    int64 nMessageNumber = connection.m_nNextMessageNumber++;
+    if (pOutMessageNumber)
+        *pOutMessageNumber = nMessageNumber;
+    return k_EResultOK;
+}
+
+// Hands out the messages whose simulated latency has passed, in the order they arrived
+int STEAM_LocalBackend::ReceiveMessagesOnConnection(HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages)
+{
+    std::lock_guard<std::mutex> lock(m_mutexNet);
+    auto it = m_mapConnections.find(hConn);
+    if (it == m_mapConnections.end())
+        return -1;
+
+    Uint32 unNow = SDL_GetTicks();
+    std::deque<Inbound_t> &rgInbox = it->second.m_rgInbox;
+    int cMessages = 0;
+    for (auto itMessage = rgInbox.begin(); itMessage != rgInbox.end() && cMessages < nMaxMessages;)
+    {
+        if (static_cast<Sint32>(unNow - itMessage->m_unDueTicks) < 0)
+        {
+            ++itMessage;
+            continue;
+        }
+
+        LocalMessage_t *pMessage = new LocalMessage_t();
+        pMessage->m_rgubData.swap(itMessage->m_rgubData);
+        pMessage->m_pData = pMessage->m_rgubData.data();
+        pMessage->m_cbSize = static_cast<int>(pMessage->m_rgubData.size());
+        pMessage->m_conn = hConn;
+        pMessage->m_usecTimeReceived = static_cast<SteamNetworkingMicroseconds>(unNow) * 1000;
+        pMessage->m_nMessageNumber = 0;
+        pMessage->m_pfnFreeData = nullptr;
+        pMessage->m_pfnRelease = &LocalMessage_t::Release;
+        ppOutMessages[cMessages++] = pMessage;
+        itMessage = rgInbox.erase(itMessage);
+    }
+    return cMessages;
+}
+
+// Starts timing the made up controller's presses
+bool STEAM_LocalBackend::InputInit()
+{
+    std::lock_guard<std::mutex> lock(m_mutexInput);
+    m_ulInputStartCounter = SDL_GetPerformanceCounter();
+    return true;
+}
+
+bool STEAM_LocalBackend::InputShutdown()
+{
+    return true;
+}
+
+// One controller when --steam-input asked for one
+int STEAM_LocalBackend::GetConnectedControllers(InputHandle_t *handlesOut)
+{
+    if (m_config.m_flInputMashRate <= 0.f)
+        return 0;
+
+    handlesOut[0] = 1;
+    return 1;
+}
+
+InputActionSetHandle_t STEAM_LocalBackend::GetActionSetHandle(const char *pszActionSetName)
+{
+    return GetInputHandle(pszActionSetName);
+}
+
+InputDigitalActionHandle_t STEAM_LocalBackend::GetDigitalActionHandle(const char *pszActionName)
+{
+    InputDigitalActionHandle_t hAction = GetInputHandle(pszActionName);
+    if (strcmp(pszActionName, "step") == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_mutexInput);
+        m_hInputStep = hAction;
+    }
+    return hAction;
+}
+
+// "step" goes down every 1 / m_flInputMashRate seconds and stays down for m_unInputPressMS,
+// timed from InputInit(). Nothing else is ever pressed.
+InputDigitalActionData_t STEAM_LocalBackend::GetDigitalActionData(InputHandle_t inputHandle, InputDigitalActionHandle_t digitalActionHandle)
+{
+    InputDigitalActionData_t data;
+    data.bActive = inputHandle == 1 && digitalActionHandle != 0 && m_config.m_flInputMashRate > 0.f;
+    data.bState = false;
+
+    std::lock_guard<std::mutex> lock(m_mutexInput);
+    if (data.bActive && digitalActionHandle == m_hInputStep)
+    {
+        double flElapsedMS = static_cast<double>(SDL_GetPerformanceCounter() - m_ulInputStartCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+        double flPeriodMS = 1000.0 / m_config.m_flInputMashRate;
+        data.bState = fmod(flElapsedMS, flPeriodMS) < m_config.m_unInputPressMS;
+    }
+    return data;
+}
+
+// Handle of an action set or action name, names get handles in the order they're asked for
+uint64 STEAM_LocalBackend::GetInputHandle(const char *pchName)
+{
+    std::lock_guard<std::mutex> lock(m_mutexInput);
+    for (size_t i = 0; i < m_rgInputNames.size(); ++i)
+    {
+        if (m_rgInputNames[i] == pchName)
+            return i + 1;
+    }
+    m_rgInputNames.push_back(pchName);
+    return m_rgInputNames.size();
+}
+
+// Read every socket and resend connection requests, called from Poll() under m_mutexNet
+void STEAM_LocalBackend::PumpNetwork()
+{
+    uint8 rgubDatagram[2 + LOCAL_NET_MAX_MESSAGE];
+    SteamNetworkingIPAddr addrFrom;
+
+    // Read everything waiting, a few datagrams that can't be read don't stop the rest
+    for (std::pair<const HSteamListenSocket, intptr_t> &listenSocket : m_mapListenSockets)
+    {
+        for (int cErrors = 0; cErrors < 8;)
+        {
+            int cubRead = receiveFrom(listenSocket.second, rgubDatagram, sizeof(rgubDatagram), &addrFrom);
+            if (cubRead == -1)
+                break;
+            if (cubRead < 1)
+            {
+                ++cErrors;
+                continue;
+            }
+            ReceiveDatagram(listenSocket.first, k_HSteamNetConnection_Invalid, rgubDatagram, cubRead, addrFrom);
+        }
+    }
+    for (std::pair<const HSteamNetConnection, NetConnection_t> &connection : m_mapConnections)
+    {
+        if (connection.second.m_hListenSocket)
+            continue;
+
+        for (int cErrors = 0; cErrors < 8;)
+        {
+            int cubRead = receiveFrom(connection.second.m_socket, rgubDatagram, sizeof(rgubDatagram), &addrFrom);
+            if (cubRead == -1)
+                break;
+            if (cubRead < 1)
+            {
+                ++cErrors;
+                continue;
+            }
+            ReceiveDatagram(k_HSteamListenSocket_Invalid, connection.first, rgubDatagram, cubRead, addrFrom);
+        }
+    }
+
+    // Resend connection requests, time out, and keep quiet connections alive
+    Uint32 unNow = SDL_GetTicks();
+    for (std::pair<const HSteamNetConnection, NetConnection_t> &pair : m_mapConnections)
+    {
+        NetConnection_t &connection = pair.second;
+        if (connection.m_eState == k_ESteamNetworkingConnectionState_Connecting && !connection.m_hListenSocket)
+        {
+            if (static_cast<Sint32>(unNow - connection.m_unConnectDeadlineTicks) >= 0)
+            {
+                SetConnectionState(pair.first, connection, k_ESteamNetworkingConnectionState_ProblemDetectedLocally, k_ESteamNetConnectionEnd_Misc_Timeout, "Timed out connecting");
+            }
+            else if (static_cast<Sint32>(unNow - connection.m_unNextConnectTicks) >= 0)
+            {
+                sendDatagram(connection.m_socket, connection.m_addrRemote, k_ELocalDatagramConnect);
+                connection.m_unNextConnectTicks = unNow + LOCAL_NET_CONNECT_RETRY_MS;
+            }
+        }
+        else if (connection.m_eState == k_ESteamNetworkingConnectionState_Connected)
+        {
+            if (unNow - connection.m_unLastReceivedTicks >= LOCAL_NET_TIMEOUT_MS)
+            {
+                SetConnectionState(pair.first, connection, k_ESteamNetworkingConnectionState_ProblemDetectedLocally, k_ESteamNetConnectionEnd_Misc_Timeout, "Connection timed out");
+            }
+            else if (unNow - connection.m_unLastSentTicks >= LOCAL_NET_KEEPALIVE_MS)
+            {
+                sendDatagram(connection.m_socket, connection.m_addrRemote, k_ELocalDatagramKeepalive);
+                connection.m_unLastSentTicks = unNow;
+            }
+        }
+    }
+}
+
+// Handle a datagram that arrived on a listen socket, or on an outgoing connection's socket
+void STEAM_LocalBackend::ReceiveDatagram(HSteamListenSocket hListenSocket, HSteamNetConnection hOutgoing, const uint8 *pubData, int cubData, const SteamNetworkingIPAddr &addrFrom)
+{
+    // Datagrams on a listen socket are told apart by who sent them
+    HSteamNetConnection hConn = hOutgoing;
+    if (hListenSocket)
+    {
+        hConn = k_HSteamNetConnection_Invalid;
+        for (std::pair<const HSteamNetConnection, NetConnection_t> &connection : m_mapConnections)
+        {
+            if (connection.second.m_hListenSocket == hListenSocket && connection.second.m_addrRemote == addrFrom)
+            {
+                hConn = connection.first;
+                break;
+            }
+        }
+    }
+
+    Uint32 unNow = SDL_GetTicks();
+    if (pubData[0] == k_ELocalDatagramConnect)
+    {
+        if (!hListenSocket)
+            return;
+
+        // A new peer, the game accepts or closes it when it sees the callback
+        if (!hConn)
+        {
+            hConn = m_unNextNetHandle++;
+            NetConnection_t &connection = m_mapConnections[hConn];
+            connection.m_hListenSocket = hListenSocket;
+            connection.m_eState = k_ESteamNetworkingConnectionState_None;
+            connection.m_socket = m_mapListenSockets[hListenSocket];
+            connection.m_addrRemote = addrFrom;
+            connection.m_unNextConnectTicks = connection.m_unConnectDeadlineTicks = unNow;
+            connection.m_unLastReceivedTicks = connection.m_unLastSentTicks = unNow;
+            connection.m_nNextMessageNumber = 1;
+            SetConnectionState(hConn, connection, k_ESteamNetworkingConnectionState_Connecting, 0, nullptr);
+        }
+
+        // The accept was lost, send it again
+        else if (m_mapConnections[hConn].m_eState == k_ESteamNetworkingConnectionState_Connected)
+        {
+            sendDatagram(m_mapConnections[hConn].m_socket, addrFrom, k_ELocalDatagramAccept);
+        }
+        return;
+    }
+
+    auto it = m_mapConnections.find(hConn);
+    if (it == m_mapConnections.end())
+        return;
+
+    NetConnection_t &connection = it->second;
+    connection.m_unLastReceivedTicks = unNow;
+    switch (pubData[0])
+    {
+    case k_ELocalDatagramAccept:
+        if (!connection.m_hListenSocket && connection.m_eState == k_ESteamNetworkingConnectionState_Connecting)
+            SetConnectionState(hConn, connection, k_ESteamNetworkingConnectionState_Connected, 0, nullptr);
+        break;
+
+    // Unreliable messages may be dropped, reliable ones stay in order behind the last one
+    case k_ELocalDatagramData:
+        if (connection.m_eState == k_ESteamNetworkingConnectionState_Connected && cubData >= 2)
+        {
+            bool bReliable = (pubData[1] & k_nSteamNetworkingSend_Reliable) != 0;
+            if (!bReliable && m_config.m_flNetLossRate > 0.f && std::uniform_real_distribution<float>(0.f, 1.f)(m_rngNet) < m_config.m_flNetLossRate)
+                break;
+
+            Inbound_t inbound;
+            inbound.m_unDueTicks = unNow + std::uniform_int_distribution<Uint32>(m_config.m_unNetLatencyMinMS, m_config.m_unNetLatencyMaxMS)(m_rngNet);
+            if (bReliable && !connection.m_rgInbox.empty() && static_cast<Sint32>(connection.m_rgInbox.back().m_unDueTicks - inbound.m_unDueTicks) > 0)
+                inbound.m_unDueTicks = connection.m_rgInbox.back().m_unDueTicks;
+            inbound.m_rgubData.assign(pubData + 2, pubData + cubData);
+            connection.m_rgInbox.push_back(std::move(inbound));
+        }
+        break;
+
+    case k_ELocalDatagramClose:
+        if (connection.m_eState == k_ESteamNetworkingConnectionState_Connected || connection.m_eState == k_ESteamNetworkingConnectionState_Connecting)
+            SetConnectionState(hConn, connection, k_ESteamNetworkingConnectionState_ClosedByPeer, k_ESteamNetConnectionEnd_App_Generic, "Closed by peer");
+        break;
+
+    default:
+        break;
+    }
+}
+
+// Move a connection to eState and post SteamNetConnectionStatusChangedCallback_t straight
+// away, the network has its own latency
+void STEAM_LocalBackend::SetConnectionState(HSteamNetConnection hConn, NetConnection_t &connection, ESteamNetworkingConnectionState eState, int nEndReason, const char *pszDebug)
+{
+    SteamNetConnectionStatusChangedCallback_t callback;
+    memset(&callback, 0, sizeof(callback));
+    callback.m_hConn = hConn;
+    callback.m_info.m_hListenSocket = connection.m_hListenSocket;
+    callback.m_info.m_addrRemote = connection.m_addrRemote;
+    callback.m_info.m_eState = eState;
+    callback.m_info.m_eEndReason = nEndReason;
+    snprintf(callback.m_info.m_szEndDebug, sizeof(callback.m_info.m_szEndDebug), "%s", pszDebug ? pszDebug : "");
+    callback.m_eOldState = connection.m_eState;
+    connection.m_eState = eState;
+    PostAt(callback, k_uAPICallInvalid, false, SDL_GetTicks());
+}
+
+// Queue a callback, or a call result when hAPICall is valid
+template<class P>
+void STEAM_LocalBackend::Post(const P &param, SteamAPICall_t hAPICall, bool bIOFailure)
+{
+    std::uniform_int_distribution<Uint32> latency(m_config.m_unLatencyMinMS, m_config.m_unLatencyMaxMS);
+    PostAt(param, hAPICall, bIOFailure, SDL_GetTicks() + latency(m_rng));
+}
+
+// Queue a callback or call result due at unDueTicks, safe from any thread
+template<class P>
+void STEAM_LocalBackend::PostAt(const P &param, SteamAPICall_t hAPICall, bool bIOFailure, Uint32 unDueTicks)
+{
+    Pending_t pending;
+    pending.m_unDueTicks = unDueTicks;
+    pending.m_iCallback = P::k_iCallback;
+    pending.m_hAPICall = hAPICall;
+    pending.m_bIOFailure = bIOFailure;
+    pending.m_rgubParam.resize(sizeof(P));
+    memcpy(pending.m_rgubParam.data(), &param, sizeof(P));
+
+    std::lock_guard<std::mutex> lock(m_mutexPending);
+    m_rgPending.push_back(std::move(pending));
+}
+
+SteamAPICall_t STEAM_LocalBackend::NextAPICall()
+{
+    return m_hNextAPICall++;
+}
+
+bool STEAM_LocalBackend::RollFailure()
+{
+    return m_config.m_flFailureRate > 0.f && std::uniform_real_distribution<float>(0.f, 1.f)(m_rng) < m_config.m_flFailureRate;
+}
+
+STEAM_LocalBackend::Leaderboard_t *STEAM_LocalBackend::GetLeaderboard(SteamLeaderboard_t hSteamLeaderboard)
+{
+    if (hSteamLeaderboard == 0 || hSteamLeaderboard > m_rgLeaderboards.size())
+        return nullptr;
+    return &m_rgLeaderboards[static_cast<size_t>(hSteamLeaderboard - 1)];
+}
+
+STEAM_LocalBackend::Leaderboard_t &STEAM_LocalBackend::FindOrCreateLeaderboard(const std::string &sName)
+{
+    for (Leaderboard_t &leaderboard : m_rgLeaderboards)
+    {
+        if (leaderboard.m_sName == sName)
+            return leaderboard;
+    }
+
+    m_rgLeaderboards.push_back(Leaderboard_t());
+    m_rgLeaderboards.back().m_sName = sName;
+    m_rgLeaderboards.back().m_iPlayerScore = -1;
+    AddMadeUpScores(m_rgLeaderboards.back());
+    return m_rgLeaderboards.back();
+}
+
+// Fill the leaderboard with made up players, the same seed and name give the same players
+void STEAM_LocalBackend::AddMadeUpScores(Leaderboard_t &leaderboard)
+{
+    std::seed_seq seed{ m_config.m_unSeed, static_cast<Uint32>(std::hash<std::string>()(leaderboard.m_sName)) };
+    std::mt19937 rng(seed);
+    std::exponential_distribution<double> score(1.0 / LOCAL_MEAN_SCORE);
+
+    std::vector<Score_t> &rgScores = leaderboard.m_rgMadeUpScores;
+    rgScores.reserve(rgScores.size() + m_config.m_nLeaderboardEntries);
+    for (int i = 0; i < m_config.m_nLeaderboardEntries; ++i)
+    {
+        rgScores.push_back(Score_t{ static_cast<uint32>(LOCAL_FIRST_MADE_UP_ID + i), static_cast<int32>(score(rng)) });
+    }
+    std::stable_sort(rgScores.begin(), rgScores.end(), [](const Score_t &a, const Score_t &b) { return a.m_nScore > b.m_nScore; });
+}
+
+// Entries on the board, the player's included
+int STEAM_LocalBackend::GetScoreCount(const Leaderboard_t &leaderboard)
+{
+    return static_cast<int>(leaderboard.m_rgMadeUpScores.size()) + (leaderboard.m_iPlayerScore >= 0 ? 1 : 0);
+}
+
+// Entry at iScore, the made up players after the player's entry are one further down
+const STEAM_LocalBackend::Score_t &STEAM_LocalBackend::GetScore(const Leaderboard_t &leaderboard, int iScore)
+{
+    if (leaderboard.m_iPlayerScore < 0 || iScore < leaderboard.m_iPlayerScore)
+        return leaderboard.m_rgMadeUpScores[iScore];
+    if (iScore == leaderboard.m_iPlayerScore)
+        return leaderboard.m_playerScore;
+    return leaderboard.m_rgMadeUpScores[iScore - 1];
+}
+
+// Put the player after every made up player with the same or a better score
+void STEAM_LocalBackend::SetPlayerScore(Leaderboard_t &leaderboard, int32 nScore, const std::vector<int32> &rgnDetails)
+{
+    const std::vector<Score_t> &rgScores = leaderboard.m_rgMadeUpScores;
+    auto it = std::upper_bound(rgScores.begin(), rgScores.end(), nScore, [](int32 nValue, const Score_t &score) { return nValue > score.m_nScore; });
+    leaderboard.m_playerScore.m_unAccountID = LOCAL_PLAYER_ID;
+    leaderboard.m_playerScore.m_nScore = nScore;
+    leaderboard.m_playerScore.m_rgnDetails = rgnDetails;
+    leaderboard.m_iPlayerScore = static_cast<int>(it - rgScores.begin());
+}
+
+CSteamID STEAM_LocalBackend::MakeSteamID(uint32 unAccountID)
+{
+    return CSteamID(unAccountID, k_EUniversePublic, k_EAccountTypeIndividual);
+}
+
+// Read the state file, a missing file starts a fresh player. Lines are
+//     persona <name>
+//     stat <name> <value>
+//     achievement <name>
+//     score <leaderboard> <value> [<detail> ...]
+//     cloud <file> <hex bytes>
+bool STEAM_LocalBackend::Load()
+{
+    SDL_RWops *file = SDL_RWFromFile(m_config.m_sPath.c_str(), "rb");
+    if (file == nullptr)
+    {
+        ULOG_INFO(k_ELogSteam, "No local Steam state at %s, starting fresh", m_config.m_sPath);
+        return true;
+    }
+
+    std::string sText(static_cast<size_t>(SDL_max(SDL_RWsize(file), 0)), '\0');
+    size_t cubRead = sText.empty() ? 0 : SDL_RWread(file, &sText[0], 1, sText.size());
+    SDL_RWclose(file);
+    if (cubRead != sText.size())
+    {
+        ULOG_ERROR(k_ELogSteam, "Failed to read the local Steam state from %s!", m_config.m_sPath);
+        return false;
+    }
+
+    std::istringstream text(sText);
+    std::string sLine;
+    while (std::getline(text, sLine))
+    {
+        std::istringstream line(sLine);
+        std::string sKey, sName;
+        line >> sKey;
+        if (sKey == "persona")
+        {
+            std::getline(line >> std::ws, m_sPersonaName);
+        }
+        else if (sKey == "stat")
+        {
+            int32 nValue = 0;
+            if (line >> sName >> nValue)
+                m_mapStats[sName] = nValue;
+        }
+        else if (sKey == "achievement")
+        {
+            if (line >> sName)
+                m_mapAchievements[sName] = true;
+        }
+        else if (sKey == "score")
+        {
+            int32 nScore = 0;
+            if (line >> sName >> nScore)
+            {
+                std::vector<int32> rgnDetails;
+                int32 nDetail;
+                while (rgnDetails.size() < k_cLeaderboardDetailsMax && line >> nDetail)
+                {
+                    rgnDetails.push_back(nDetail);
+                }
+                SetPlayerScore(FindOrCreateLeaderboard(sName), nScore, rgnDetails);
+            }
+        }
+        else if (sKey == "cloud")
+        {
+            std::string sHex;
+            if (line >> sName)
+            {
+                line >> sHex;
+                std::vector<uint8> &rgubFile = m_mapCloudFiles[sName];
+                rgubFile.clear();
+                for (size_t i = 0; i + 1 < sHex.size(); i += 2)
+                {
+                    rgubFile.push_back(static_cast<uint8>(strtoul(sHex.substr(i, 2).c_str(), nullptr, 16)));
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Write the player's state, the made up players are rebuilt from the seed
+bool STEAM_LocalBackend::Save()
+{
+    m_unLastSaveTicks = SDL_GetTicks();
+
+    std::ostringstream text;
+    text << "persona " << m_sPersonaName << "\n";
+    for (const std::pair<const std::string, int32> &stat : m_mapStats)
+    {
+        text << "stat " << stat.first << " " << stat.second << "\n";
+    }
+    for (const std::pair<const std::string, bool> &achievement : m_mapAchievements)
+    {
+        if (achievement.second)
+            text << "achievement " << achievement.first << "\n";
+    }
+    for (const Leaderboard_t &leaderboard : m_rgLeaderboards)
+    {
+        if (leaderboard.m_iPlayerScore >= 0)
+        {
+            const Score_t &score = leaderboard.m_playerScore;
+            text << "score " << leaderboard.m_sName << " " << score.m_nScore;
+            for (int32 nDetail : score.m_rgnDetails)
+            {
+                text << " " << nDetail;
+            }
+            text << "\n";
+        }
+    }
+    for (const std::pair<const std::string, std::vector<uint8>> &file : m_mapCloudFiles)
+    {
+        text << "cloud " << file.first << " ";
+        for (uint8 ubByte : file.second)
+        {
+            char rgchByte[3];
+            snprintf(rgchByte, sizeof(rgchByte), "%02x", ubByte);
+            text << rgchByte;
+        }
+        text << "\n";
+    }
+
+    SDL_RWops *file = SDL_RWFromFile(m_config.m_sPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        ULOG_ERROR(k_ELogSteam, "Unable to write the local Steam state to %s! SDL Error: %s", m_config.m_sPath, SDL_GetError());
+        return false;
+    }
+
+    const std::string sText = text.str();
+    bool bSuccess = SDL_RWwrite(file, sText.data(), 1, sText.size()) == sText.size();
+    SDL_RWclose(file);
+
+    // A failed write is tried again LOCAL_SAVE_MS later
+    m_bSaveDirty = !bSuccess;
+    return bSuccess;
+}
\ No newline at end of file
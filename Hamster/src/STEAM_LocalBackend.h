@@ -0,0 +1,266 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_LocalBackend.h
+*/
+#pragma once
+#include "STEAM_Backend.h"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Settings for the local backend, "--local-steam <file> [--steam-latency <ms>|<min>-<max>]
+// [--steam-failure-rate <0-1>] [--steam-entries <count>] [--steam-seed <n>] [--steam-cloud <0|1>]
+// [--net-latency <ms>|<min>-<max>] [--net-loss <0-1>] [--steam-input <presses/s>[:<press ms>]]".
+// The options can follow any other mode's options, e.g. "--bench script.txt --local-steam steam.txt".
+struct STEAM_LocalConfig_t
+{
+    std::string m_sPath;            // Stats, achievements and the player's scores are kept here
+    Uint32 m_unLatencyMinMS;        // Each callback and call result is delayed by a random time
+    Uint32 m_unLatencyMaxMS;        // between the min and max
+    float m_flFailureRate;          // Chance an async call comes back as an IO failure
+    int m_nLeaderboardEntries;      // Made up players added to each leaderboard
+    Uint32 m_unSeed;                // Seeds the made up players, latency and failures
+    bool m_bCloudEnabled;           // Whether the player has Steam Cloud turned on
+    Uint32 m_unNetLatencyMinMS;     // Network messages are delayed by a random time between
+    Uint32 m_unNetLatencyMaxMS;     // the min and max on arrival
+    float m_flNetLossRate;          // Chance an unreliable message is dropped on arrival
+    float m_flInputMashRate;        // A controller presses "step" this many times a second, 0
+    Uint32 m_unInputPressMS;        // for no controller, holding it down this long each time
+
+    STEAM_LocalConfig_t()
+    {
+        m_unLatencyMinMS = 50;
+        m_unLatencyMaxMS = 250;
+        m_flFailureRate = 0.f;
+        m_nLeaderboardEntries = 1000;
+        m_unSeed = 1;
+        m_bCloudEnabled = true;
+        m_unNetLatencyMinMS = 0;
+        m_unNetLatencyMaxMS = 0;
+        m_flNetLossRate = 0.f;
+        m_flInputMashRate = 0.f;
+        m_unInputPressMS = 4;
+    }
+};
+
+// In process stand in for the Steam client. Keeps stats, achievements, leaderboards and Steam
+// Cloud files in memory, saved to a text file, and posts callbacks and call results after a configurable
+// latency with an optional IO failure rate. Leaderboards are padded with made up players so
+// downloads, ranks and uploads can be tested against boards with millions of entries.
+// Networking sockets run over real UDP sockets, so two local processes can connect to each
+// other over loopback, with simulated latency and loss. Steam Input can have a controller that
+// mashes the step action at a fixed rate, with presses shorter than a frame.
+class STEAM_LocalBackend : public STEAM_Backend
+{
+public:
+    explicit STEAM_LocalBackend(const STEAM_LocalConfig_t &config);
+
+    // Parse the command line, returns true if the local backend was requested
+    static bool ParseArgs(int argc, char *args[], STEAM_LocalConfig_t &config);
+
+    bool Init() override;
+    void Shutdown() override;
+    void Poll(std::vector<STEAM_Message_t> &rgMessages) override;
+    void RunFrame() override;
+    const char *GetName() override { return "local"; }
+
+    uint32 GetAppID() override;
+    bool GetImageSize(int iImage, uint32 *pnWidth, uint32 *pnHeight) override;
+    bool GetImageRGBA(int iImage, uint8 *pubDest, int nDestBufferSize) override;
+
+    CSteamID GetSteamID() override;
+
+    const char *GetPersonaName() override;
+    const char *GetFriendPersonaName(CSteamID steamIDFriend) override;
+    int GetSmallFriendAvatar(CSteamID steamIDFriend) override;
+
+    bool RequestCurrentStats() override;
+    bool GetStat(const char *pchName, int32 *pData) override;
+    bool SetStat(const char *pchName, int32 nData) override;
+    bool GetAchievement(const char *pchName, bool *pbAchieved) override;
+    bool SetAchievement(const char *pchName) override;
+    const char *GetAchievementDisplayAttribute(const char *pchName, const char *pchKey) override;
+    bool StoreStats() override;
+    bool ResetAllStats(bool bAchievementsToo) override;
+
+    SteamAPICall_t FindLeaderboard(const char *pchLeaderboardName) override;
+    const char *GetLeaderboardName(SteamLeaderboard_t hSteamLeaderboard) override;
+    int GetLeaderboardEntryCount(SteamLeaderboard_t hSteamLeaderboard) override;
+    SteamAPICall_t DownloadLeaderboardEntries(SteamLeaderboard_t hSteamLeaderboard, ELeaderboardDataRequest eLeaderboardDataRequest, int nRangeStart, int nRangeEnd) override;
+    bool GetDownloadedLeaderboardEntry(SteamLeaderboardEntries_t hSteamLeaderboardEntries, int index, LeaderboardEntry_t *pLeaderboardEntry, int32 *pDetails, int cDetailsMax) override;
+    SteamAPICall_t UploadLeaderboardScore(SteamLeaderboard_t hSteamLeaderboard, ELeaderboardUploadScoreMethod eLeaderboardUploadScoreMethod, int32 nScore, const int32 *pScoreDetails, int cScoreDetailsCount) override;
+
+    bool IsCloudEnabledForAccount() override;
+    bool IsCloudEnabledForApp() override;
+    bool FileExists(const char *pchFile) override;
+    int32 GetFileSize(const char *pchFile) override;
+    SteamAPICall_t FileWriteAsync(const char *pchFile, const void *pvData, uint32 cubData) override;
+    SteamAPICall_t FileReadAsync(const char *pchFile, uint32 nOffset, uint32 cubToRead) override;
+    bool FileReadAsyncComplete(SteamAPICall_t hReadCall, void *pvBuffer, uint32 cubToRead) override;
+
+    HSteamListenSocket CreateListenSocketIP(const SteamNetworkingIPAddr &localAddress) override;
+    HSteamNetConnection ConnectByIPAddress(const SteamNetworkingIPAddr &address) override;
+    EResult AcceptConnection(HSteamNetConnection hConn) override;
+    bool CloseConnection(HSteamNetConnection hPeer, int nReason, const char *pszDebug, bool bEnableLinger) override;
+    bool CloseListenSocket(HSteamListenSocket hSocket) override;
+    EResult SendMessageToConnection(HSteamNetConnection hConn, const void *pData, uint32 cbData, int nSendFlags, int64 *pOutMessageNumber) override;
+    int ReceiveMessagesOnConnection(HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages) override;
+
+    bool InputInit() override;
+    bool InputShutdown() override;
+    void InputRunFrame() override {}
+    int GetConnectedControllers(InputHandle_t *handlesOut) override;
+    InputActionSetHandle_t GetActionSetHandle(const char *pszActionSetName) override;
+    void ActivateActionSet(InputHandle_t inputHandle, InputActionSetHandle_t actionSetHandle) override {}
+    InputDigitalActionHandle_t GetDigitalActionHandle(const char *pszActionName) override;
+    InputDigitalActionData_t GetDigitalActionData(InputHandle_t inputHandle, InputDigitalActionHandle_t digitalActionHandle) override;
+
+private:
+    // One player's score
+    struct Score_t
+    {
+        uint32 m_unAccountID;
+        int32 m_nScore;
+        std::vector<int32> m_rgnDetails;
+    };
+
+    // A downloaded entry and its details
+    struct DownloadedEntry_t
+    {
+        LeaderboardEntry_t m_entry;
+        std::vector<int32> m_rgnDetails;
+    };
+
+    // The made up players never move once the board is made, so they're kept sorted best
+    // score first and the player's entry is slotted in by rank. Moving it is a binary search
+    // however many entries the board has.
+    struct Leaderboard_t
+    {
+        std::string m_sName;
+        std::vector<Score_t> m_rgMadeUpScores;
+        Score_t m_playerScore;
+        int m_iPlayerScore;            // Index of the player's entry, -1 if they haven't got one
+    };
+
+    // A callback or call result waiting for its latency to pass
+    struct Pending_t
+    {
+        Uint32 m_unDueTicks;
+        int m_iCallback;
+        SteamAPICall_t m_hAPICall;
+        bool m_bIOFailure;
+        std::vector<uint8> m_rgubParam;
+    };
+
+    // A message that arrived on a connection, held until its simulated latency passes
+    struct Inbound_t
+    {
+        Uint32 m_unDueTicks;
+        std::vector<uint8> m_rgubData;
+    };
+
+    // A connection over UDP. Outgoing connections have a socket of their own, accepted ones
+    // share their listen socket's.
+    struct NetConnection_t
+    {
+        HSteamListenSocket m_hListenSocket;         // 0 for outgoing connections
+        ESteamNetworkingConnectionState m_eState;
+        intptr_t m_socket;
+        SteamNetworkingIPAddr m_addrRemote;
+        Uint32 m_unNextConnectTicks;                // Connection requests are resent until answered
+        Uint32 m_unConnectDeadlineTicks;
+        Uint32 m_unLastReceivedTicks;               // Connections that go quiet for too long time out
+        Uint32 m_unLastSentTicks;                   // Quiet connections send keepalives
+        int64 m_nNextMessageNumber;
+        std::deque<Inbound_t> m_rgInbox;
+    };
+
+    // Queue a callback, or a call result when hAPICall is valid
+    template<class P>
+    void Post(const P &param, SteamAPICall_t hAPICall = k_uAPICallInvalid, bool bIOFailure = false);
+
+    // Queue a callback or call result due at unDueTicks, safe from any thread
+    template<class P>
+    void PostAt(const P &param, SteamAPICall_t hAPICall, bool bIOFailure, Uint32 unDueTicks);
+
+    // Read every socket and resend connection requests, called from Poll() under m_mutexNet
+    void PumpNetwork();
+
+    // Handle a datagram that arrived on a listen socket, or on an outgoing connection's socket
+    void ReceiveDatagram(HSteamListenSocket hListenSocket, HSteamNetConnection hOutgoing, const uint8 *pubData, int cubData, const SteamNetworkingIPAddr &addrFrom);
+
+    // Move a connection to eState and post SteamNetConnectionStatusChangedCallback_t
+    void SetConnectionState(HSteamNetConnection hConn, NetConnection_t &connection, ESteamNetworkingConnectionState eState, int nEndReason, const char *pszDebug);
+
+    // Handle of an action set or action name, names get handles in the order they're asked for
+    uint64 GetInputHandle(const char *pchName);
+
+    // Next call handle, and whether the call should fail
+    SteamAPICall_t NextAPICall();
+    bool RollFailure();
+
+    // Leaderboard helpers
+    Leaderboard_t *GetLeaderboard(SteamLeaderboard_t hSteamLeaderboard);
+    Leaderboard_t &FindOrCreateLeaderboard(const std::string &sName);
+    void AddMadeUpScores(Leaderboard_t &leaderboard);
+    int GetScoreCount(const Leaderboard_t &leaderboard);
+    const Score_t &GetScore(const Leaderboard_t &leaderboard, int iScore);
+    void SetPlayerScore(Leaderboard_t &leaderboard, int32 nScore, const std::vector<int32> &rgnDetails);
+    CSteamID MakeSteamID(uint32 unAccountID);
+
+    // Read and write m_config.m_sPath
+    bool Load();
+    bool Save();
+    bool m_bSaveDirty;             // Changed since the last Save(), RunFrame() writes it out
+    Uint32 m_unLastSaveTicks;
+
+    STEAM_LocalConfig_t m_config;
+    std::mt19937 m_rng;
+
+    std::string m_sPersonaName;
+    std::map<std::string, int32> m_mapStats;
+    std::map<std::string, bool> m_mapAchievements;
+    std::vector<std::string> m_rgNewAchievements;    // Set since the last StoreStats()
+    std::vector<Leaderboard_t> m_rgLeaderboards;     // Handle is the index + 1
+
+    // Downloaded entries waiting for GetDownloadedLeaderboardEntry()
+    std::unordered_map<SteamLeaderboardEntries_t, std::vector<DownloadedEntry_t>> m_mapDownloads;
+    SteamLeaderboardEntries_t m_hNextDownload;
+
+    // Posted on the game thread and polled on the pump thread
+    std::mutex m_mutexPending;
+    std::vector<Pending_t> m_rgPending;
+    SteamAPICall_t m_hNextAPICall;
+
+    // Steam Cloud files, and the bytes each read in flight copied out
+    std::map<std::string, std::vector<uint8>> m_mapCloudFiles;
+    std::unordered_map<SteamAPICall_t, std::vector<uint8>> m_mapCloudReads;
+
+    // Networking sockets, used from the game thread and polled on the pump thread
+    std::mutex m_mutexNet;
+    std::map<HSteamListenSocket, intptr_t> m_mapListenSockets;
+    std::map<HSteamNetConnection, NetConnection_t> m_mapConnections;
+    uint32 m_unNextNetHandle;
+    std::mt19937 m_rngNet;
+
+    // Steam Input, used from STEAM_Input's thread
+    std::mutex m_mutexInput;
+    std::vector<std::string> m_rgInputNames;
+    InputDigitalActionHandle_t m_hInputStep;    // The action the controller mashes
+    Uint64 m_ulInputStartCounter;               // Presses are timed from InputInit()
+
+    // Players whose avatar was asked for, the first time it comes back as still loading
+    std::unordered_set<uint32> m_setAvatarsRequested;
+
+    // GetFriendPersonaName() hands out pointers into these
+    char m_rgchNames[8][64];
+    int m_iNextName;
+};
\ No newline at end of file
@@ -0,0 +1,135 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_PersonaCache.cpp
+*/
+#include "STEAM_PersonaCache.h"
+#include <algorithm>
+
+// Players kept before the ones shown longest ago are dropped
+#define PERSONA_CACHE_MAX_ENTRIES 256
+
+// Constructor
+STEAM_PersonaCache::STEAM_PersonaCache() :
+    m_CallbackPersonaStateChange(this, &STEAM_PersonaCache::OnPersonaStateChange)
+{
+    m_pRenderer = nullptr;
+    m_pFont = nullptr;
+    m_unUseCounter = 0;
+    m_unGeneration = 0;
+}
+
+// Destructor
+STEAM_PersonaCache::~STEAM_PersonaCache()
+{
+    free();
+}
+
+// Set the renderer and font names are rendered with
+void STEAM_PersonaCache::init(SDL_Renderer *pRenderer, TTF_Font *pFont)
+{
+    m_pRenderer = pRenderer;
+    m_pFont = pFont;
+}
+
+// The cached player, added if it's the first time they're seen
+STEAM_PersonaCache::Persona_t &STEAM_PersonaCache::GetPersona(CSteamID steamID)
+{
+    Persona_t &persona = m_mapPersonas[steamID.ConvertToUint64()];
+    persona.m_unLastUsed = ++m_unUseCounter;
+    return persona;
+}
+
+// Name of steamID, looked up from Steam only if it isn't cached or it changed
+const std::string &STEAM_PersonaCache::GetName(CSteamID steamID)
+{
+    Persona_t &persona = GetPersona(steamID);
+    if (!persona.m_bNameKnown && SteamBackend())
+    {
+        std::string sName = SteamBackend()->GetFriendPersonaName(steamID);
+        if (sName != persona.m_sName)
+        {
+            persona.m_sName = sName;
+            persona.m_bRendered = false;
+        }
+        persona.m_bNameKnown = true;
+    }
+    return persona.m_sName;
+}
+
+// Texture showing the name of steamID, rendered only if it isn't cached or the name changed
+UTexture *STEAM_PersonaCache::GetNameTexture(CSteamID steamID)
+{
+    GetName(steamID);
+    Persona_t &persona = GetPersona(steamID);
+    if (!persona.m_bRendered)
+    {
+        persona.m_texName.initUTexture(m_pRenderer);
+        persona.m_texName.initFont(m_pFont);
+
+        // SDL_ttf can't render an empty string
+        if (!persona.m_texName.loadFromRenderedText(persona.m_sName.empty() ? " " : persona.m_sName, BLACK_TEXT))
+        {
+            ULOG_ERROR(k_ELogRender, "Failed to render the persona name of %llu", steamID.ConvertToUint64());
+        }
+        persona.m_bRendered = true;
+    }
+    return &persona.m_texName;
+}
+
+// Cache a name without asking Steam
+void STEAM_PersonaCache::SetName(CSteamID steamID, const std::string &sName)
+{
+    Persona_t &persona = GetPersona(steamID);
+    if (sName != persona.m_sName)
+    {
+        persona.m_sName = sName;
+        persona.m_bRendered = false;
+    }
+    persona.m_bNameKnown = true;
+}
+
+// Drop the players shown longest ago until the cache fits, except the rgulKeep ones
+void STEAM_PersonaCache::Trim(const uint64 *rgulKeep, int cKeep)
+{
+    if (m_mapPersonas.size() <= PERSONA_CACHE_MAX_ENTRIES)
+        return;
+
+    std::vector<std::pair<Uint32, uint64>> rgLastUsed;
+    for (const std::pair<const uint64, Persona_t> &persona : m_mapPersonas)
+    {
+        if (std::find(rgulKeep, rgulKeep + cKeep, persona.first) == rgulKeep + cKeep)
+        {
+            rgLastUsed.push_back(std::make_pair(persona.second.m_unLastUsed, persona.first));
+        }
+    }
+
+    size_t cDrop = MIN(m_mapPersonas.size() - PERSONA_CACHE_MAX_ENTRIES, rgLastUsed.size());
+    std::partial_sort(rgLastUsed.begin(), rgLastUsed.begin() + cDrop, rgLastUsed.end());
+    for (size_t i = 0; i < cDrop; ++i)
+    {
+        m_mapPersonas.erase(rgLastUsed[i].second);
+    }
+}
+
+// Free every cached texture
+void STEAM_PersonaCache::free()
+{
+    m_mapPersonas.clear();
+}
+
+// Called when a user's persona changes, the name is looked up again next time it's shown
+void STEAM_PersonaCache::OnPersonaStateChange(PersonaStateChange_t *pParam)
+{
+    if (!(pParam->m_nChangeFlags & k_EPersonaChangeName))
+        return;
+
+    auto it = m_mapPersonas.find(pParam->m_ulSteamID);
+    if (it != m_mapPersonas.end())
+    {
+        it->second.m_bNameKnown = false;
+        ++m_unGeneration;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_PersonaCache.h
+*/
+#pragma once
+#include "STEAM_Backend.h"
+#include "UTexture.h"
+#include <unordered_map>
+
+// Persona names of the players on the leaderboards and their rendered text, keyed by
+// SteamID. A player's name is looked up and rendered the first time they're seen, after that
+// refreshing a board only costs a hash lookup per row. Names are looked up again when Steam
+// posts a PersonaStateChange_t saying they changed, and players that haven't been shown in a
+// while are dropped once there are more than PERSONA_CACHE_MAX_ENTRIES.
+class STEAM_PersonaCache
+{
+public:
+    // Constructor
+    STEAM_PersonaCache();
+
+    // Destructor
+    ~STEAM_PersonaCache();
+
+    // Set the renderer and font names are rendered with
+    void init(SDL_Renderer *pRenderer, TTF_Font *pFont);
+
+    // Name of steamID, looked up from Steam only if it isn't cached or it changed
+    const std::string &GetName(CSteamID steamID);
+
+    // Texture showing the name of steamID, rendered only if it isn't cached or the name changed
+    UTexture *GetNameTexture(CSteamID steamID);
+
+    // Cache a name without asking Steam, lets the microbenchmarks run without Steam
+    void SetName(CSteamID steamID, const std::string &sName);
+
+    // Drop the players shown longest ago until the cache fits, except the rgulKeep ones
+    void Trim(const uint64 *rgulKeep, int cKeep);
+
+    // Goes up every time a cached name changes, anything showing names should redraw
+    Uint32 GetGeneration() const { return m_unGeneration; }
+
+    // Free every cached texture
+    void free();
+
+private:
+    struct Persona_t
+    {
+        std::string m_sName;       // Persona name
+        bool m_bNameKnown;         // m_sName is up to date
+        UTexture m_texName;        // m_sName rendered
+        bool m_bRendered;          // m_texName shows m_sName
+        Uint32 m_unLastUsed;       // m_unUseCounter when the name was last asked for
+
+        Persona_t() : m_bNameKnown(false), m_bRendered(false), m_unLastUsed(0) {}
+    };
+
+    // The cached player, added if it's the first time they're seen
+    Persona_t &GetPersona(CSteamID steamID);
+
+    // Called when a user's persona changes, the name is looked up again next time it's shown
+    STEAM_BACKEND_CALLBACK(STEAM_PersonaCache, OnPersonaStateChange, PersonaStateChange_t, m_CallbackPersonaStateChange);
+
+    std::unordered_map<uint64, Persona_t> m_mapPersonas;
+    SDL_Renderer *m_pRenderer;
+    TTF_Font *m_pFont;
+    Uint32 m_unUseCounter;     // Counts lookups, orders the players for Trim()
+    Uint32 m_unGeneration;     // Cached names that changed
+};
\ No newline at end of file
@@ -0,0 +1,155 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Pump.cpp
+*/
+#include "STEAM_Pump.h"
+#include "STEAM_Async.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// How often the backend is polled
+#define STEAM_PUMP_INTERVAL_MS 16
+
+// Messages that can wait for the game thread, must be a power of two
+#define STEAM_PUMP_CAPACITY 256
+
+namespace
+{
+    // Single producer, single consumer ring. The pump thread owns mHead and the game thread
+    // owns mTail, a slot belongs to the producer until mHead moves past it.
+    STEAM_Message_t gRing[STEAM_PUMP_CAPACITY];
+    std::atomic<Uint32> gHead(0);
+    std::atomic<Uint32> gTail(0);
+
+    std::thread gThread;
+    std::atomic<bool> gRunning(false);
+    std::mutex gWakeMutex;
+    std::condition_variable gWake;
+    bool gWoken = false;
+
+    // Hand a message to the game thread, waits while the ring is full
+    void push(STEAM_Message_t &aMessage)
+    {
+        Uint32 head = gHead.load(std::memory_order_relaxed);
+        while (head - gTail.load(std::memory_order_acquire) >= STEAM_PUMP_CAPACITY)
+        {
+            if (!gRunning.load())
+                return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        gRing[head & (STEAM_PUMP_CAPACITY - 1)] = std::move(aMessage);
+        gHead.store(head + 1, std::memory_order_release);
+    }
+
+    // Poll the backend until Stop()
+    void run(STEAM_Backend *aBackend)
+    {
+        std::vector<STEAM_Message_t> messages;
+        while (gRunning.load())
+        {
+            aBackend->Poll(messages);
+            for (STEAM_Message_t &message : messages)
+            {
+                push(message);
+            }
+            messages.clear();
+
+            std::unique_lock<std::mutex> lock(gWakeMutex);
+            gWake.wait_for(lock, std::chrono::milliseconds(STEAM_PUMP_INTERVAL_MS), [] { return gWoken || !gRunning.load(); });
+            gWoken = false;
+        }
+    }
+
+    // Log a latency summary
+    void logLatency(const char *aName, const STEAM_Latency_t &aLatency)
+    {
+        ULOG_INFO(k_ELogSteam, "Steam %s latency: %u samples, mean %.1f us, max %.1f us", aName, aLatency.m_cSamples,
+            aLatency.m_cSamples ? aLatency.m_flTotalUS / aLatency.m_cSamples : 0.0, aLatency.m_flMaxUS);
+    }
+}
+
+// Start polling pBackend
+void STEAM_Pump::Start(STEAM_Backend *pBackend)
+{
+    Stop();
+    gRunning = true;
+    gThread = std::thread(run, pBackend);
+}
+
+// Stop polling and log the dispatch latency
+void STEAM_Pump::Stop()
+{
+    if (!gThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(gWakeMutex);
+        gRunning = false;
+    }
+    gWake.notify_one();
+    gThread.join();
+
+    // Drop whatever the game never dispatched
+    while (gTail.load() != gHead.load())
+    {
+        gRing[gTail.load() & (STEAM_PUMP_CAPACITY - 1)] = STEAM_Message_t();
+        gTail.store(gTail.load() + 1);
+    }
+
+    STEAM_Latency_t handoff, callResult;
+    STEAM_Backend::GetLatency(&handoff, &callResult);
+    logLatency("handoff", handoff);
+    logLatency("call result", callResult);
+}
+
+// Poll now instead of waiting for the next interval
+void STEAM_Pump::Wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(gWakeMutex);
+        gWoken = true;
+    }
+    gWake.notify_one();
+}
+
+// Run the handlers for everything polled so far, on the game thread, then fail the awaited
+// calls that ran out of time and run the backend's frame. Polls inline when the pump isn't
+// running.
+void STEAM_Pump::Dispatch()
+{
+    if (!gRunning.load())
+    {
+        if (SteamBackend())
+        {
+            SteamBackend()->RunCallbacks();
+        }
+        STEAM_AsyncScope::RunTimeouts();
+        if (SteamBackend())
+        {
+            SteamBackend()->RunFrame();
+        }
+        return;
+    }
+
+    // Only take what's there now, handlers that start calls get their results next frame
+    Uint32 tail = gTail.load(std::memory_order_relaxed);
+    const Uint32 head = gHead.load(std::memory_order_acquire);
+    while (tail != head)
+    {
+        STEAM_Message_t message = std::move(gRing[tail & (STEAM_PUMP_CAPACITY - 1)]);
+        gTail.store(++tail, std::memory_order_release);
+        STEAM_Backend::Dispatch(message);
+    }
+    STEAM_AsyncScope::RunTimeouts();
+    if (SteamBackend())
+    {
+        SteamBackend()->RunFrame();
+    }
+}
\ No newline at end of file
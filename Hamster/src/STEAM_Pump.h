@@ -0,0 +1,31 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Pump.h
+*/
+#pragma once
+#include "STEAM_Backend.h"
+
+// Polls the Steam backend on its own thread every STEAM_PUMP_INTERVAL_MS, or sooner when
+// woken, and hands the callbacks and call results to the game thread through a lock free
+// queue. Steam latency no longer depends on the frame rate, and the game thread only pays for
+// running the handlers.
+class STEAM_Pump
+{
+public:
+    // Start polling pBackend
+    static void Start(STEAM_Backend *pBackend);
+
+    // Stop polling and log the dispatch latency
+    static void Stop();
+
+    // Poll now instead of waiting for the next interval
+    static void Wake();
+
+    // Run the handlers for everything polled so far, on the game thread, then fail the awaited
+    // calls that ran out of time and run the backend's frame. Polls inline when the pump isn't
+    // running.
+    static void Dispatch();
+};
\ No newline at end of file
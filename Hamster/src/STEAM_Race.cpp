@@ -0,0 +1,465 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Race.cpp
+*/
+#include "STEAM_Race.h"
+
+// How quickly the clock offset follows the fastest arrival, per frame
+#define RACE_CLOCK_SMOOTHING 0.1f
+
+// Messages read from the connection at a time
+#define RACE_RECEIVE_BATCH 16
+
+namespace
+{
+    // 7 bits a byte, low bits first, the top bit says another byte follows
+    void writeVarint(uint8 *&pubOut, uint32 unValue)
+    {
+        while (unValue >= 0x80)
+        {
+            *pubOut++ = static_cast<uint8>(unValue | 0x80);
+            unValue >>= 7;
+        }
+        *pubOut++ = static_cast<uint8>(unValue);
+    }
+
+    bool readVarint(const uint8 *&pubIn, const uint8 *pubEnd, uint32 &unValue)
+    {
+        unValue = 0;
+        for (int nShift = 0; nShift < 35 && pubIn < pubEnd; nShift += 7)
+        {
+            uint8 ubByte = *pubIn++;
+            unValue |= static_cast<uint32>(ubByte & 0x7F) << nShift;
+            if (!(ubByte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    // Small differences either way get small codes, 0, -1, 1, -2 become 0, 1, 2, 3
+    uint32 zigzag(int32 nValue)
+    {
+        return (static_cast<uint32>(nValue) << 1) ^ static_cast<uint32>(nValue >> 31);
+    }
+
+    int32 unzigzag(uint32 unCode)
+    {
+        return static_cast<int32>(unCode >> 1) ^ -static_cast<int32>(unCode & 1);
+    }
+
+    // "a.b.c.d:port" for the log
+    std::string addressToString(const SteamNetworkingIPAddr &addr)
+    {
+        uint32 unIP = addr.GetIPv4();
+        char rgchAddress[32];
+        snprintf(rgchAddress, sizeof(rgchAddress), "%u.%u.%u.%u:%u", (unIP >> 24) & 0xFF, (unIP >> 16) & 0xFF, (unIP >> 8) & 0xFF, unIP & 0xFF, static_cast<unsigned>(addr.m_port));
+        return rgchAddress;
+    }
+}
+
+// Constructor
+STEAM_Race::STEAM_Race() :
+    m_CallbackConnectionStatusChanged(this, &STEAM_Race::OnConnectionStatusChanged)
+{
+    m_hListenSocket = k_HSteamListenSocket_Invalid;
+    m_hConn = k_HSteamNetConnection_Invalid;
+    m_bConnected = false;
+    m_unConnectedTicks = 0;
+    m_unNextConnectTicks = 0;
+    m_unNextSendTicks = 0;
+    m_fntRace = nullptr;
+    m_nLabelLoops = -2;
+    m_bLabelPlaying = false;
+    ResetConnection();
+}
+
+// Destructor
+STEAM_Race::~STEAM_Race()
+{
+    free();
+}
+
+// Reads "--race-host <port>" or "--race-join <ip>:<port>", false when neither is given
+bool STEAM_Race::ParseArgs(int argc, char *args[], STEAM_RaceConfig_t &config)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        const char *pchValue = args[i + 1];
+        if (strcmp(args[i], "--race-host") == 0)
+        {
+            unsigned long ulPort = strtoul(pchValue, nullptr, 10);
+            if (ulPort == 0 || ulPort > 0xFFFF)
+            {
+                ULOG_WARN(k_ELogSteam, "--race-host wants a port, not \"%s\"", pchValue);
+                return false;
+            }
+            config.m_bHost = true;
+            config.m_addr.SetIPv4(0, static_cast<uint16>(ulPort));
+            return true;
+        }
+        else if (strcmp(args[i], "--race-join") == 0)
+        {
+            // Four dotted bytes then the port
+            uint32 unIP = 0;
+            const char *pch = pchValue;
+            bool bValid = true;
+            for (int iByte = 0; iByte < 4 && bValid; ++iByte)
+            {
+                char *pchEnd = nullptr;
+                unsigned long ulByte = strtoul(pch, &pchEnd, 10);
+                bValid = pchEnd != pch && ulByte <= 0xFF && *pchEnd == (iByte < 3 ? '.' : ':');
+                unIP = (unIP << 8) | static_cast<uint32>(ulByte);
+                pch = pchEnd + 1;
+            }
+            unsigned long ulPort = bValid ? strtoul(pch, nullptr, 10) : 0;
+            if (ulPort == 0 || ulPort > 0xFFFF)
+            {
+                ULOG_WARN(k_ELogSteam, "--race-join wants <ip>:<port>, not \"%s\"", pchValue);
+                return false;
+            }
+            config.m_bHost = false;
+            config.m_addr.SetIPv4(unIP, static_cast<uint16>(ulPort));
+            return true;
+        }
+    }
+    return false;
+}
+
+// Start hosting or joining, the opponent label is drawn with pRenderer
+bool STEAM_Race::init(SDL_Renderer *pRenderer, const STEAM_RaceConfig_t &config)
+{
+    m_config = config;
+
+    Uint64 loadStart = SDL_GetPerformanceCounter();
+    m_fntRace = TTF_OpenFont("assets/font.ttf", 18);
+    UFlightRecorder::recordAsset(k_EFlightFont, "assets/font.ttf", m_fntRace != nullptr, loadStart);
+    if (!m_fntRace)
+    {
+        ULOG_ERROR(k_ELogRender, "Failed to load race font, SDL_ttf Error: %s", TTF_GetError());
+        return false;
+    }
+    m_texLabel.initUTexture(pRenderer);
+    m_texLabel.initFont(m_fntRace);
+
+    if (m_config.m_bHost)
+    {
+        m_hListenSocket = SteamBackend()->CreateListenSocketIP(m_config.m_addr);
+        if (m_hListenSocket == k_HSteamListenSocket_Invalid)
+        {
+            ULOG_ERROR(k_ELogSteam, "Unable to host a race on port %u", static_cast<unsigned>(m_config.m_addr.m_port));
+            return false;
+        }
+        ULOG_INFO(k_ELogSteam, "Hosting a race on port %u", static_cast<unsigned>(m_config.m_addr.m_port));
+    }
+    else
+    {
+        Connect();
+    }
+    return true;
+}
+
+// Send our state when a tick is due and read the opponent's, called once a frame
+void STEAM_Race::Update(bool bPlaying, int nSteps)
+{
+    Uint32 unNow = SDL_GetTicks();
+    if (!m_config.m_bHost && m_hConn == k_HSteamNetConnection_Invalid && static_cast<Sint32>(unNow - m_unNextConnectTicks) >= 0)
+    {
+        Connect();
+    }
+    if (!m_bConnected)
+        return;
+
+    // Read everything that came in since last frame
+    SteamNetworkingMessage_t *rgpMessages[RACE_RECEIVE_BATCH];
+    int cMessages = RACE_RECEIVE_BATCH;
+    while (cMessages == RACE_RECEIVE_BATCH)
+    {
+        cMessages = SteamBackend()->ReceiveMessagesOnConnection(m_hConn, rgpMessages, RACE_RECEIVE_BATCH);
+        for (int i = 0; i < cMessages; ++i)
+        {
+            m_cubReceived += rgpMessages[i]->m_cbSize;
+            if (!ReceiveState(static_cast<const uint8 *>(rgpMessages[i]->m_pData), rgpMessages[i]->m_cbSize))
+            {
+                ULOG_DEBUG(k_ELogSteam, "Dropped a race packet of %d bytes", rgpMessages[i]->m_cbSize);
+            }
+            rgpMessages[i]->Release();
+        }
+    }
+
+    // A frame that ran long sends one packet, not one per tick it missed
+    if (static_cast<Sint32>(unNow - m_unNextSendTicks) >= 0)
+    {
+        RaceState_t state;
+        state.m_unSeq = m_unNextSeq++;
+        state.m_unTimeMS = unNow - m_unConnectedTicks;
+        state.m_nSteps = nSteps;
+        state.m_ubFlags = bPlaying ? k_nRaceFlagPlaying : 0;
+        SendState(state);
+
+        m_unNextSendTicks += RACE_TICK_MS;
+        if (static_cast<Sint32>(unNow - m_unNextSendTicks) >= 0)
+        {
+            m_unNextSendTicks = unNow + RACE_TICK_MS;
+        }
+    }
+
+    Interpolate();
+}
+
+// Draw the opponent's loops, or that we're waiting for one
+void STEAM_Race::render()
+{
+    if (!m_fntRace)
+        return;
+
+    // Only rendered again when the text changes
+    int nLoops = -1;
+    if (m_bConnected)
+    {
+        nLoops = m_cSamples ? m_rgSamples[(m_iNextSample + RACE_INTERP_SAMPLES - 1) % RACE_INTERP_SAMPLES].m_nSteps / 5 : 0;
+    }
+    if (nLoops != m_nLabelLoops || m_bOpponentPlaying != m_bLabelPlaying)
+    {
+        if (nLoops < 0)
+        {
+            m_texLabel.loadFromRenderedText("Waiting for opponent...", BLACK_TEXT);
+        }
+        else
+        {
+            m_texLabel.loadFromRenderedText((m_bOpponentPlaying ? "Opponent running: " : "Opponent: ") + std::to_string(nLoops) + " loops", BLACK_TEXT);
+        }
+        m_nLabelLoops = nLoops;
+        m_bLabelPlaying = m_bOpponentPlaying;
+    }
+
+    // Under the high score
+    m_texLabel.render(static_cast<int>(ULib::SCREEN_DIMENSIONS.x * (9.0 / 12.0)), static_cast<int>(ULib::SCREEN_DIMENSIONS.y * (1.0 / 25.0)) + 36);
+}
+
+// Close the connection and log the bandwidth used
+void STEAM_Race::free()
+{
+    if (SteamBackend())
+    {
+        if (m_hConn != k_HSteamNetConnection_Invalid)
+        {
+            SteamBackend()->CloseConnection(m_hConn, 0, "Race over", false);
+        }
+        if (m_hListenSocket != k_HSteamListenSocket_Invalid)
+        {
+            SteamBackend()->CloseListenSocket(m_hListenSocket);
+        }
+    }
+    ResetConnection();
+    m_hConn = k_HSteamNetConnection_Invalid;
+    m_hListenSocket = k_HSteamListenSocket_Invalid;
+
+    m_texLabel.free();
+    if (m_fntRace)
+    {
+        TTF_CloseFont(m_fntRace);
+        m_fntRace = nullptr;
+    }
+}
+
+// Called when a connection changes state
+void STEAM_Race::OnConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t *pCallback)
+{
+    ESteamNetworkingConnectionState eState = pCallback->m_info.m_eState;
+
+    // Someone wants to race, the host takes the first one that asks
+    if (m_config.m_bHost && eState == k_ESteamNetworkingConnectionState_Connecting && m_hListenSocket != k_HSteamListenSocket_Invalid && pCallback->m_info.m_hListenSocket == m_hListenSocket)
+    {
+        if (m_hConn != k_HSteamNetConnection_Invalid || SteamBackend()->AcceptConnection(pCallback->m_hConn) != k_EResultOK)
+        {
+            SteamBackend()->CloseConnection(pCallback->m_hConn, 0, "Race is full", false);
+            return;
+        }
+        m_hConn = pCallback->m_hConn;
+        return;
+    }
+
+    if (pCallback->m_hConn != m_hConn || m_hConn == k_HSteamNetConnection_Invalid)
+        return;
+
+    if (eState == k_ESteamNetworkingConnectionState_Connected)
+    {
+        ResetConnection();
+        m_bConnected = true;
+        m_unConnectedTicks = SDL_GetTicks();
+        m_unNextSendTicks = m_unConnectedTicks;
+        ULOG_INFO(k_ELogSteam, "Racing %s", addressToString(pCallback->m_info.m_addrRemote));
+    }
+    else if (eState == k_ESteamNetworkingConnectionState_ClosedByPeer || eState == k_ESteamNetworkingConnectionState_ProblemDetectedLocally)
+    {
+        ULOG_INFO(k_ELogSteam, "Race connection to %s closed: %s", addressToString(pCallback->m_info.m_addrRemote), pCallback->m_info.m_szEndDebug);
+        SteamBackend()->CloseConnection(m_hConn, 0, nullptr, false);
+        m_hConn = k_HSteamNetConnection_Invalid;
+        ResetConnection();
+        m_unNextConnectTicks = SDL_GetTicks() + RACE_RETRY_MS;
+    }
+}
+
+// Start connecting to the host
+void STEAM_Race::Connect()
+{
+    m_hConn = SteamBackend()->ConnectByIPAddress(m_config.m_addr);
+    if (m_hConn == k_HSteamNetConnection_Invalid)
+    {
+        ULOG_WARN(k_ELogSteam, "Unable to connect to the race at %s, trying again in %d ms", addressToString(m_config.m_addr), RACE_RETRY_MS);
+        m_unNextConnectTicks = SDL_GetTicks() + RACE_RETRY_MS;
+        return;
+    }
+    ULOG_INFO(k_ELogSteam, "Joining the race at %s", addressToString(m_config.m_addr));
+}
+
+// Forget everything about the last opponent, logging the bandwidth the race used
+void STEAM_Race::ResetConnection()
+{
+    if (m_bConnected)
+    {
+        float flSeconds = SDL_max(static_cast<float>(SDL_GetTicks() - m_unConnectedTicks) / 1000.f, 0.001f);
+        ULOG_INFO(k_ELogSteam, "Race used %.0f B/s up and %.0f B/s down over %.1f s, %u packets sent", static_cast<float>(m_cubSent) / flSeconds, static_cast<float>(m_cubReceived) / flSeconds, flSeconds, m_unNextSeq - 1);
+    }
+
+    m_bConnected = false;
+    m_unNextSeq = 1;
+    m_unPeerAckedSeq = 0;
+    m_unReceivedSeq = 0;
+    memset(m_rgSent, 0, sizeof(m_rgSent));
+    memset(m_rgReceived, 0, sizeof(m_rgReceived));
+    m_cSamples = 0;
+    m_iNextSample = 0;
+    m_bClockSynced = false;
+    m_flClockOffset = 0.f;
+    m_flOpponentSteps = 0.f;
+    m_bOpponentPlaying = false;
+    m_cubSent = 0;
+    m_cubReceived = 0;
+}
+
+// Encode and send our state
+void STEAM_Race::SendState(const RaceState_t &state)
+{
+    // Against the newest state the peer has, or whole when that's too old to still be kept
+    RaceState_t baseline;
+    memset(&baseline, 0, sizeof(baseline));
+    const RaceState_t &acked = m_rgSent[m_unPeerAckedSeq % RACE_HISTORY];
+    if (m_unPeerAckedSeq && state.m_unSeq - m_unPeerAckedSeq < RACE_HISTORY && acked.m_unSeq == m_unPeerAckedSeq)
+    {
+        baseline = acked;
+    }
+
+    uint8 rgubPacket[32];
+    uint8 *pub = rgubPacket;
+    writeVarint(pub, state.m_unSeq);
+    writeVarint(pub, m_unReceivedSeq);
+    writeVarint(pub, baseline.m_unSeq ? state.m_unSeq - baseline.m_unSeq : 0);
+    writeVarint(pub, zigzag(static_cast<int32>(state.m_unTimeMS - baseline.m_unTimeMS)));
+    writeVarint(pub, zigzag(state.m_nSteps - baseline.m_nSteps));
+    *pub++ = state.m_ubFlags;
+    m_rgSent[state.m_unSeq % RACE_HISTORY] = state;
+
+    uint32 cubPacket = static_cast<uint32>(pub - rgubPacket);
+    if (SteamBackend()->SendMessageToConnection(m_hConn, rgubPacket, cubPacket, k_nSteamNetworkingSend_UnreliableNoNagle, nullptr) == k_EResultOK)
+    {
+        m_cubSent += cubPacket;
+    }
+}
+
+// Decode an opponent packet, false if it's malformed or its baseline is gone
+bool STEAM_Race::ReceiveState(const uint8 *pubData, int cubData)
+{
+    const uint8 *pub = pubData;
+    const uint8 *pubEnd = pubData + cubData;
+    uint32 unSeq, unAck, unBaselineDistance, unTimeCode, unStepsCode;
+    if (!readVarint(pub, pubEnd, unSeq) || !readVarint(pub, pubEnd, unAck) || !readVarint(pub, pubEnd, unBaselineDistance) ||
+        !readVarint(pub, pubEnd, unTimeCode) || !readVarint(pub, pubEnd, unStepsCode) || pub >= pubEnd || unSeq == 0)
+        return false;
+    uint8 ubFlags = *pub;
+
+    // Acks only move forward, a late packet can't take one back
+    if (unAck > m_unPeerAckedSeq && unAck < m_unNextSeq)
+    {
+        m_unPeerAckedSeq = unAck;
+    }
+
+    // Late or duplicated, we already have a newer state
+    if (unSeq <= m_unReceivedSeq)
+        return true;
+
+    RaceState_t state;
+    state.m_unSeq = unSeq;
+    state.m_unTimeMS = static_cast<uint32>(unzigzag(unTimeCode));
+    state.m_nSteps = unzigzag(unStepsCode);
+    state.m_ubFlags = ubFlags;
+    if (unBaselineDistance)
+    {
+        const RaceState_t &baseline = m_rgReceived[(unSeq - unBaselineDistance) % RACE_HISTORY];
+        if (unBaselineDistance >= unSeq || baseline.m_unSeq != unSeq - unBaselineDistance)
+            return false;
+        state.m_unTimeMS += baseline.m_unTimeMS;
+        state.m_nSteps += baseline.m_nSteps;
+    }
+    m_rgReceived[unSeq % RACE_HISTORY] = state;
+    m_unReceivedSeq = unSeq;
+    m_bOpponentPlaying = (ubFlags & k_nRaceFlagPlaying) != 0;
+
+    Sample_t &sample = m_rgSamples[m_iNextSample];
+    sample.m_unTimeMS = state.m_unTimeMS;
+    sample.m_nSteps = state.m_nSteps;
+    sample.m_unArrivalTicks = SDL_GetTicks();
+    m_iNextSample = (m_iNextSample + 1) % RACE_INTERP_SAMPLES;
+    m_cSamples = SDL_min(m_cSamples + 1, RACE_INTERP_SAMPLES);
+    return true;
+}
+
+// Move m_flOpponentSteps to where the opponent was RACE_INTERP_DELAY_MS ago
+void STEAM_Race::Interpolate()
+{
+    if (!m_cSamples)
+        return;
+
+    // The sample that took least time to arrive has the least latency in it, the difference
+    // between the clocks is taken from that one
+    int iOldest = (m_iNextSample + RACE_INTERP_SAMPLES - m_cSamples) % RACE_INTERP_SAMPLES;
+    float flFastest = 0.f;
+    for (int i = 0; i < m_cSamples; ++i)
+    {
+        const Sample_t &sample = m_rgSamples[(iOldest + i) % RACE_INTERP_SAMPLES];
+        float flOffset = static_cast<float>(static_cast<Sint32>(sample.m_unArrivalTicks - sample.m_unTimeMS));
+        flFastest = i ? SDL_min(flFastest, flOffset) : flOffset;
+    }
+    m_flClockOffset = m_bClockSynced ? m_flClockOffset + (flFastest - m_flClockOffset) * RACE_CLOCK_SMOOTHING : flFastest;
+    m_bClockSynced = true;
+
+    // The opponent's time to draw, by their clock
+    float flRenderTime = static_cast<float>(SDL_GetTicks()) - m_flClockOffset - RACE_INTERP_DELAY_MS;
+
+    // Before the buffer holds the oldest state, past it the newest, nothing is extrapolated
+    const Sample_t *pBefore = nullptr;
+    for (int i = 0; i < m_cSamples; ++i)
+    {
+        const Sample_t &sample = m_rgSamples[(iOldest + i) % RACE_INTERP_SAMPLES];
+        if (static_cast<float>(sample.m_unTimeMS) < flRenderTime)
+        {
+            pBefore = &sample;
+            continue;
+        }
+
+        // A new run starting drops the steps to 0, that's shown straight away
+        if (!pBefore || sample.m_nSteps < pBefore->m_nSteps || sample.m_unTimeMS == pBefore->m_unTimeMS)
+        {
+            m_flOpponentSteps = static_cast<float>(sample.m_nSteps);
+            return;
+        }
+
+        float flT = (flRenderTime - static_cast<float>(pBefore->m_unTimeMS)) / static_cast<float>(sample.m_unTimeMS - pBefore->m_unTimeMS);
+        m_flOpponentSteps = static_cast<float>(pBefore->m_nSteps) + flT * static_cast<float>(sample.m_nSteps - pBefore->m_nSteps);
+        return;
+    }
+    m_flOpponentSteps = static_cast<float>(pBefore->m_nSteps);
+}
\ No newline at end of file
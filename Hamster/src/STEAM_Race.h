@@ -0,0 +1,154 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_Race.h
+*/
+#pragma once
+#include "STEAM_Backend.h"
+#include "UTexture.h"
+
+// How often the race state is sent to the opponent
+#define RACE_TICK_MS 50
+
+// The opponent is drawn this far behind their newest state, so a late packet or two doesn't
+// stop their wheel
+#define RACE_INTERP_DELAY_MS 100
+
+// Sent and received states kept to delta encode against, and opponent states kept to
+// interpolate between
+#define RACE_HISTORY 32
+#define RACE_INTERP_SAMPLES 16
+
+// Joining tries again this long after a connection fails or closes
+#define RACE_RETRY_MS 2000
+
+// Who to race, from the command line
+struct STEAM_RaceConfig_t
+{
+    bool m_bHost;                      // Listen on m_addr's port for an opponent
+    SteamNetworkingIPAddr m_addr;      // Port to host on, or the host to join
+
+    STEAM_RaceConfig_t() : m_bHost(false) { m_addr.Clear(); }
+};
+
+// A live race against one other player over the backend's networking sockets. Each side sends
+// its step count every RACE_TICK_MS as a small unreliable packet, and draws the opponent's
+// wheel from the states it receives.
+//
+// Packets are varints: the sequence number, the newest sequence received from the peer as an
+// ack, how many packets back the baseline is (0 when the state is sent whole), then the time
+// and step count as zigzag encoded differences from the baseline and a flags byte. The
+// baseline is the newest state the peer has acked, so losing any packet only costs the state
+// in it, and a packet usually takes 6 to 8 bytes.
+//
+// Received states are kept with when they arrived. The lowest arrival delay seen over the
+// buffer is the clock offset, and the opponent is drawn RACE_INTERP_DELAY_MS behind their
+// clock by interpolating between the two states either side of that time.
+class STEAM_Race
+{
+public:
+    // Constructor
+    STEAM_Race();
+
+    // Destructor
+    ~STEAM_Race();
+
+    // Reads "--race-host <port>" or "--race-join <ip>:<port>", false when neither is given
+    static bool ParseArgs(int argc, char *args[], STEAM_RaceConfig_t &config);
+
+    // Start hosting or joining, the opponent label is drawn with pRenderer
+    bool init(SDL_Renderer *pRenderer, const STEAM_RaceConfig_t &config);
+
+    // Send our state when a tick is due and read the opponent's, called once a frame
+    void Update(bool bPlaying, int nSteps);
+
+    // An opponent is connected
+    bool IsOpponentConnected() const { return m_bConnected; }
+
+    // Rotation of the opponent's wheel, interpolated between the states received
+    double GetOpponentDegree() const { return m_flOpponentSteps * 72.0; }
+
+    // Draw the opponent's loops, or that we're waiting for one
+    void render();
+
+    // Close the connection and log the bandwidth used
+    void free();
+
+private:
+    // A player's state at a point in their run
+    struct RaceState_t
+    {
+        uint32 m_unSeq;        // Sequence number of the packet that carried it, 0 for none
+        uint32 m_unTimeMS;     // Sender's clock, ms since the connection came up
+        int32 m_nSteps;
+        uint8 m_ubFlags;
+    };
+
+    // An opponent state and when it arrived by our clock
+    struct Sample_t
+    {
+        uint32 m_unTimeMS;
+        int32 m_nSteps;
+        Uint32 m_unArrivalTicks;
+    };
+
+    // Flags sent with every state
+    enum
+    {
+        k_nRaceFlagPlaying = 1
+    };
+
+    // Called when a connection changes state
+    STEAM_BACKEND_CALLBACK(STEAM_Race, OnConnectionStatusChanged, SteamNetConnectionStatusChangedCallback_t, m_CallbackConnectionStatusChanged);
+
+    // Start connecting to the host
+    void Connect();
+
+    // Forget everything about the last opponent, logging the bandwidth the race used
+    void ResetConnection();
+
+    // Encode and send our state
+    void SendState(const RaceState_t &state);
+
+    // Decode an opponent packet, false if it's malformed or its baseline is gone
+    bool ReceiveState(const uint8 *pubData, int cubData);
+
+    // Move m_flOpponentSteps to where the opponent was RACE_INTERP_DELAY_MS ago
+    void Interpolate();
+
+    STEAM_RaceConfig_t m_config;
+    HSteamListenSocket m_hListenSocket;
+    HSteamNetConnection m_hConn;
+    bool m_bConnected;
+    Uint32 m_unConnectedTicks;     // When the connection came up, packet times count from here
+    Uint32 m_unNextConnectTicks;   // Joiners try connecting again at this time
+    Uint32 m_unNextSendTicks;
+
+    // Delta encoding
+    uint32 m_unNextSeq;
+    uint32 m_unPeerAckedSeq;       // Newest of our packets the peer has received
+    uint32 m_unReceivedSeq;        // Newest of the peer's packets we've received
+    RaceState_t m_rgSent[RACE_HISTORY];
+    RaceState_t m_rgReceived[RACE_HISTORY];
+
+    // Interpolation
+    Sample_t m_rgSamples[RACE_INTERP_SAMPLES];
+    int m_cSamples;
+    int m_iNextSample;
+    bool m_bClockSynced;
+    float m_flClockOffset;         // Our ticks minus the opponent's clock, ms
+    float m_flOpponentSteps;
+    bool m_bOpponentPlaying;
+
+    // Bytes sent and received this connection
+    uint64 m_cubSent;
+    uint64 m_cubReceived;
+
+    // Opponent label
+    TTF_Font *m_fntRace;
+    UTexture m_texLabel;
+    int m_nLabelLoops;             // Loops m_texLabel shows, -1 while waiting, -2 before it's drawn
+    bool m_bLabelPlaying;          // m_texLabel says the opponent is running
+};
\ No newline at end of file
@@ -0,0 +1,114 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_ScoreDetails.cpp
+*/
+#include "STEAM_ScoreDetails.h"
+
+namespace
+{
+    // Header layout, the version in the low byte, then the split count and the bit width
+    const int k_nCountShift = 8;
+    const int k_nWidthShift = 16;
+
+    // Small differences either way get small codes, 0, -1, 1, -2 become 0, 1, 2, 3
+    uint32 zigzag(int32 nValue)
+    {
+        return (static_cast<uint32>(nValue) << 1) ^ static_cast<uint32>(nValue >> 31);
+    }
+
+    int32 unzigzag(uint32 unCode)
+    {
+        return static_cast<int32>(unCode >> 1) ^ -static_cast<int32>(unCode & 1);
+    }
+
+    // Details needed for cSplits codes of nWidth bits and the header
+    int detailsNeeded(int cSplits, int nWidth)
+    {
+        return 1 + (cSplits * nWidth + 31) / 32;
+    }
+}
+
+// Pack cSplits splits into pDetails, returns the details used or 0 if they don't fit
+int STEAM_ScoreDetails::PackSplits(const int32 *rgnSplits, int cSplits, int32 *pDetails, int cDetailsMax)
+{
+    if (cSplits <= 0 || cSplits > SCORE_DETAILS_MAX_SPLITS)
+        return 0;
+
+    // Every code gets the width of the widest one
+    uint32 unAllCodes = 0;
+    int32 nPrevious = 0;
+    for (int i = 0; i < cSplits; ++i)
+    {
+        unAllCodes |= zigzag(rgnSplits[i] - nPrevious);
+        nPrevious = rgnSplits[i];
+    }
+    int nWidth = 1;
+    while (nWidth < 32 && (unAllCodes >> nWidth) != 0)
+    {
+        ++nWidth;
+    }
+
+    int cDetails = detailsNeeded(cSplits, nWidth);
+    if (cDetails > cDetailsMax)
+        return 0;
+
+    pDetails[0] = SCORE_DETAILS_VERSION | (cSplits << k_nCountShift) | (nWidth << k_nWidthShift);
+
+    // Codes are written low bits first, spilling into the next detail when one fills up
+    uint64 ulBits = 0;
+    int nBits = 0;
+    int iDetail = 1;
+    nPrevious = 0;
+    for (int i = 0; i < cSplits; ++i)
+    {
+        ulBits |= static_cast<uint64>(zigzag(rgnSplits[i] - nPrevious)) << nBits;
+        nPrevious = rgnSplits[i];
+        nBits += nWidth;
+        if (nBits >= 32)
+        {
+            pDetails[iDetail++] = static_cast<int32>(static_cast<uint32>(ulBits));
+            ulBits >>= 32;
+            nBits -= 32;
+        }
+    }
+    if (nBits > 0)
+    {
+        pDetails[iDetail++] = static_cast<int32>(static_cast<uint32>(ulBits));
+    }
+    return iDetail;
+}
+
+// Unpack splits from cDetails details, returns the splits read or 0 if they aren't splits
+int STEAM_ScoreDetails::UnpackSplits(const int32 *pDetails, int cDetails, int32 *rgnSplits, int cSplitsMax)
+{
+    if (cDetails < 1)
+        return 0;
+
+    uint32 unHeader = static_cast<uint32>(pDetails[0]);
+    int cSplits = (unHeader >> k_nCountShift) & 0xFF;
+    int nWidth = (unHeader >> k_nWidthShift) & 0xFF;
+    if ((unHeader & 0xFF) != SCORE_DETAILS_VERSION || cSplits == 0 || cSplits > cSplitsMax || nWidth < 1 || nWidth > 32 || detailsNeeded(cSplits, nWidth) > cDetails)
+        return 0;
+
+    const uint64 ulMask = (static_cast<uint64>(1) << nWidth) - 1;
+    uint64 ulBits = 0;
+    int nBits = 0;
+    int iDetail = 1;
+    int32 nPrevious = 0;
+    for (int i = 0; i < cSplits; ++i)
+    {
+        if (nBits < nWidth)
+        {
+            ulBits |= static_cast<uint64>(static_cast<uint32>(pDetails[iDetail++])) << nBits;
+            nBits += 32;
+        }
+        nPrevious += unzigzag(static_cast<uint32>(ulBits & ulMask));
+        rgnSplits[i] = nPrevious;
+        ulBits >>= nWidth;
+        nBits -= nWidth;
+    }
+    return cSplits;
+}
\ No newline at end of file
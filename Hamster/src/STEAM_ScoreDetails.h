@@ -0,0 +1,32 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster STEAM_ScoreDetails.h
+*/
+#pragma once
+#include "ULib.h"
+#include "../../Steam/steam_api_common.h"
+
+// Bumped whenever the packing changes, details with another version are ignored
+#define SCORE_DETAILS_VERSION 1
+
+// Most splits the header can count
+#define SCORE_DETAILS_MAX_SPLITS 255
+
+// Packs a run's splits, keystrokes made in each second of the run, into the int32 details
+// Steam keeps with a leaderboard score, so a board download brings the pace of every run with
+// it. The first int32 is a header holding the version, the split count and the bit width,
+// then each split is stored as the zigzag encoded difference from the one before it in that
+// many bits. A 34 second run at up to 15 keys a second takes 7 of the 64 details.
+class STEAM_ScoreDetails
+{
+public:
+    // Pack cSplits splits into pDetails, returns the details used or 0 if they don't fit
+    static int PackSplits(const int32 *rgnSplits, int cSplits, int32 *pDetails, int cDetailsMax);
+
+    // Unpack splits from cDetails details, returns the splits read or 0 if the details aren't
+    // splits packed by PackSplits()
+    static int UnpackSplits(const int32 *pDetails, int cDetails, int32 *rgnSplits, int cSplitsMax);
+};
\ No newline at end of file
@@ -6,55 +6,84 @@
 * File: Hamster STEAM_StatsAchievements.cpp
 */
 #include "STEAM_StatsAchievements.h"
+#include "STEAM_Journal.h"
 #include "ULib.h"
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
-#define _ACH_ID( id, name ) { id, #id, name, "", 0, 0 }
-
-
-#ifndef ACH_COUNT 
-#define ACH_COUNT 4 // Achievement count
-#endif
+#define _ACH_ID( id, name, stat, comparison, threshold ) { id, #id, name, "", 0, 0, stat, comparison, threshold }
 
 
 #ifndef ACH_RENDER_TIME 
 #define ACH_RENDER_TIME 4.5f // Achievement render time
 #endif
 
+// Changed stats are batched into one StoreStats() at most this often, Steam throttles games
+// that store more often
+#ifndef STATS_STORE_INTERVAL_MS
+#define STATS_STORE_INTERVAL_MS 10000
+#endif
+
+// Stats, achievements and scores Steam hasn't confirmed yet are kept here
+#define STEAM_JOURNAL_PATH "assets/steam_journal.txt"
+
+// Stat details, indexed by EStat
+struct Stat_t
+{
+    const char *m_pchName;  // Name on Steam
+    bool m_bStored;         // Kept on Steam, otherwise it only lasts the session
+};
+
+Stat_t g_rgStats[k_EStatCount] =
+{
+    { "GamesPlayed", true },
+    { "TotalRuns", true },
+    { "TotalLoops", true },
+    { "LoopsLastRun", false },
+};
+
+// Every achievement and the rule that unlocks it
 Achievement_t g_rgAchievements[] =
 {
-    _ACH_ID(ACH_FIRST_GAME, "Good Morning"),
-    _ACH_ID(ACH_FIRST_RUN, "Back to Basics"),
-    _ACH_ID(ACH_FAST_RUN, "Super Speed"),
-    _ACH_ID(ACH_LONG_DISTANCE, "Marathon Runner"),
+    _ACH_ID(ACH_FIRST_GAME, "Good Morning", k_EStatGamesPlayed, k_EAchievementAtLeast, 1),
+    _ACH_ID(ACH_FIRST_RUN, "Back to Basics", k_EStatTotalRuns, k_EAchievementAtLeast, 1),
+    _ACH_ID(ACH_FAST_RUN, "Super Speed", k_EStatLoopsLastRun, k_EAchievementAtLeast, 405),
+    _ACH_ID(ACH_LONG_DISTANCE, "Marathon Runner", k_EStatTotalLoops, k_EAchievementAtLeast, 3300),
 };
 
+#define ACH_COUNT static_cast<int>(SDL_arraysize(g_rgAchievements)) // Achievement count
+
 // Constructor
 STEAM_StatsAchievements::STEAM_StatsAchievements()
     :
-    mSteamUser(nullptr),
-    mSteamUserStats(nullptr),
-    mGameId(SteamUtils()->GetAppID()),
     m_CallbackUserStatsReceived(this, &STEAM_StatsAchievements::onUserStatsReceived),
     m_CallbackUserStatsStored(this, &STEAM_StatsAchievements::onUserStatsStored),
-    m_CallbackAchievementStored(this, &STEAM_StatsAchievements::onAchievementStored)
+    m_CallbackAchievementStored(this, &STEAM_StatsAchievements::onAchievementStored),
+    mGameId(SteamBackend()->GetAppID()),
+    mSteamBackend(nullptr)
 {
     m_bRequestedStats = false;
     m_bStatsValid = false;
     m_bStoreStats = false;
-    m_bNewGame = true;
+    m_unLastStoreTicks = 0;
+    m_bStoredOnce = false;
 
     m_flCurrAchTime = 0.f;
     m_bFullyOpaque = false;
 
-    mLoopsLastRun = 0;
-
     m_shUpdateCount = 0;
-    
-    mGamesPlayed = 0;
-    mTotalRuns = 0;
-    mTotalLoops = 0;
+
+    // Subscribe each achievement to its stat, a stat change only evaluates its own achievements
+    for (int iStat = 0; iStat < k_EStatCount; ++iStat)
+    {
+        m_rgnStats[iStat] = 0;
+        m_rgbStatDirty[iStat] = false;
+    }
+    for (int iAch = 0; iAch < ACH_COUNT; ++iAch)
+    {
+        m_rgAchievementsByStat[g_rgAchievements[iAch].m_eStat].push_back(iAch);
+    }
 }
 
 // Initialize the STEAM_StatsAchievements
@@ -63,26 +92,19 @@ bool STEAM_StatsAchievements::init()
     // Initialize the success flag
     bool success = true;
 
-    // Set SteamUser interface
-    mSteamUser = SteamUser();
-    // If setting up SteamUser interface failed
-    if (mSteamUser == nullptr)
+    // Set the Steam backend
+    mSteamBackend = SteamBackend();
+    // If there's no Steam backend
+    if (mSteamBackend == nullptr)
     {
-        // printf("Failed to load Steam User interface!\n");
+        ULOG_ERROR(k_ELogSteam, "Failed to load the Steam backend!");
         success = false;
     }
-
-    // Otherwise continue setup 
     else
     {
-        // Set SteamUserStats interface
-        mSteamUserStats = SteamUserStats();
-        // If setting up SteamUserStats interface failed
-        if (mSteamUserStats == nullptr)
-        {
-            // printf("Failed to load Steam UserStats interface!\n");
-            success = false;
-        }
+        // Replay whatever didn't reach Steam last time, and count this game
+        STEAM_Journal::Open(STEAM_JOURNAL_PATH);
+        addStat(k_EStatGamesPlayed, 1);
     }
 
     return success;
@@ -96,18 +118,19 @@ void STEAM_StatsAchievements::update(const float &dt)
         return;
 
     m_shUpdateCount = 0;
-    SteamAPI_RunCallbacks();
+    STEAM_Journal::Flush(false);
     if (!m_bRequestedStats)
     {
         // Is Steam Loaded? if no, can't get stats, done
-        if (nullptr == mSteamUserStats || nullptr == mSteamUser)
+        if (nullptr == mSteamBackend)
         {
             m_bRequestedStats = true;
             return;
         }
 
         // If yes, request our stats
-         bool bSuccess = mSteamUserStats->RequestCurrentStats();
+         bool bSuccess = mSteamBackend->RequestCurrentStats();
+         UFlightRecorder::recordSteamCall(k_EFlightRequestStats, bSuccess);
 
         // This function  should only return galse if we werent logged in, and we 
         // already checked that. But handle it being false again anyway, just ask 
@@ -119,24 +142,45 @@ void STEAM_StatsAchievements::update(const float &dt)
     if (!m_bStatsValid)
         return;
 
-    // Get info from sources
+    // Achievements were evaluated as their stats changed, store stats
+    storeStatsIfNecessary(false);
+}
 
-    // Evaluate achievements
-    for (int iAch = 0; iAch < ACH_COUNT; ++iAch)
+// Accumulators
+void STEAM_StatsAchievements::addLoops(int nLoops)
+{
+    addStat(k_EStatTotalLoops, nLoops);
+    addStat(k_EStatTotalRuns, 1);
+    setStat(k_EStatLoopsLastRun, nLoops);
+}
+
+// Add nDelta to a stat, journaling it if it's kept on Steam
+void STEAM_StatsAchievements::addStat(EStat eStat, int32 nDelta)
+{
+    if (g_rgStats[eStat].m_bStored)
     {
-        evaluateAchievement(g_rgAchievements[iAch]);
+        STEAM_Journal::AddStat(g_rgStats[eStat].m_pchName, nDelta);
     }
-
-    // Store stats
-    storeStatsIfNecessary();
+    setStat(eStat, m_rgnStats[eStat] + nDelta);
 }
 
-// Accumulators
-void STEAM_StatsAchievements::addLoops(int nLoops)
+// Change a stat and evaluate only the achievements that depend on it, so they unlock on the
+// frame the stat changes. Until Steam's stats arrive nothing is evaluated, they're all
+// evaluated once when they do.
+void STEAM_StatsAchievements::setStat(EStat eStat, int32 nValue)
 {
-    mTotalLoops += nLoops;
-    mLoopsLastRun = nLoops;
-    ++mTotalRuns;
+    if (g_rgStats[eStat].m_bStored && m_rgnStats[eStat] != nValue)
+    {
+        m_rgbStatDirty[eStat] = true;
+    }
+    m_rgnStats[eStat] = nValue;
+    if (!m_bStatsValid)
+        return;
+
+    for (int iAch : m_rgAchievementsByStat[eStat])
+    {
+        evaluateAchievement(g_rgAchievements[iAch]);
+    }
 }
 
 // See if we should unlock this achievement
@@ -146,32 +190,27 @@ void STEAM_StatsAchievements::evaluateAchievement(Achievement_t &achievement)
     if (achievement.m_bAchieved)
         return;
 
-    switch (achievement.mAchievementID)
+    int32 nValue = m_rgnStats[achievement.m_eStat];
+    bool bUnlocked = false;
+    switch (achievement.m_eComparison)
     {
-    case ACH_FIRST_GAME:
-        unlockAchievement(achievement);
+    case k_EAchievementAtLeast:
+        bUnlocked = nValue >= achievement.m_nThreshold;
         break;
-    case ACH_FIRST_RUN:
-        if (mTotalRuns >= 1)
-        {
-            unlockAchievement(achievement);
-        }
-        break;
-    case ACH_FAST_RUN:
-        if (mLoopsLastRun >= 405)
-        {
-            unlockAchievement(achievement);
-        }
+    case k_EAchievementAtMost:
+        bUnlocked = nValue <= achievement.m_nThreshold;
         break;
-    case ACH_LONG_DISTANCE:
-        if (mTotalLoops >= 3300)
-        {
-            unlockAchievement(achievement);
-        }
+    case k_EAchievementEqual:
+        bUnlocked = nValue == achievement.m_nThreshold;
         break;
     default:
         break;
     }
+
+    if (bUnlocked)
+    {
+        unlockAchievement(achievement);
+    }
 }
 
 // Unlock this achievement
@@ -183,36 +222,84 @@ void STEAM_StatsAchievements::unlockAchievement(Achievement_t &achievement)
     achievement.m_iIconImage = 0;
 
     // mark it down
-    mSteamUserStats->SetAchievement(achievement.mAchievementIDChar);
+    STEAM_Journal::AddAchievement(achievement.mAchievementIDChar);
+    mSteamBackend->SetAchievement(achievement.mAchievementIDChar);
+    UFlightRecorder::recordSteamCall(k_EFlightSetAchievement, achievement.mAchievementID);
 
     // Store stats end of frame
     m_bStoreStats = true;
 }
 
-// Store stats in the Steam database
-void STEAM_StatsAchievements::storeStatsIfNecessary()
+// Store the changed stats now instead of waiting for the store window
+void STEAM_StatsAchievements::flushStats()
+{
+    storeStatsIfNecessary(true);
+}
+
+// Store stats in the Steam database. Only the stats that changed are set, and everything
+// that changed within STATS_STORE_INTERVAL_MS goes in one StoreStats().
+void STEAM_StatsAchievements::storeStatsIfNecessary(bool bForce)
 {
-    if (m_bStoreStats)
+    if (!m_bStatsValid || !mSteamBackend)
+        return;
+
+    // already set any achievements in UnlockAchievement
+    bool bDirty = m_bStoreStats;
+    for (int iStat = 0; iStat < k_EStatCount; ++iStat)
     {
-        // already set any achievements in UnlockAchievement
+        bDirty = bDirty || m_rgbStatDirty[iStat];
+    }
+    if (!bDirty)
+        return;
 
-        // set stats
-        mSteamUserStats->SetStat("TotalRuns", mTotalRuns);
-        mSteamUserStats->SetStat("TotalLoops", mTotalLoops);
+    if (!bForce && m_bStoredOnce && SDL_GetTicks() - m_unLastStoreTicks < STATS_STORE_INTERVAL_MS)
+        return;
 
-        bool bSuccess = mSteamUserStats->StoreStats();
-        // If this failed, we never sent anything to the server, try
-        // again later.
-        m_bStoreStats = !bSuccess;
+    // set the changed stats, and journal the values so they can be replayed if they don't arrive
+    const char *rgpchStats[k_EStatCount];
+    int32 rgnStats[k_EStatCount];
+    int cStats = 0;
+    for (int iStat = 0; iStat < k_EStatCount; ++iStat)
+    {
+        if (m_rgbStatDirty[iStat])
+        {
+            rgpchStats[cStats] = g_rgStats[iStat].m_pchName;
+            rgnStats[cStats] = m_rgnStats[iStat];
+            mSteamBackend->SetStat(rgpchStats[cStats], rgnStats[cStats]);
+            ++cStats;
+        }
+    }
+    STEAM_Journal::BeginStore(rgpchStats, rgnStats, cStats);
+
+    m_unLastStoreTicks = SDL_GetTicks();
+    m_bStoredOnce = true;
+    bool bSuccess = mSteamBackend->StoreStats();
+    UFlightRecorder::recordSteamCall(k_EFlightStoreStats, bSuccess);
+    ULOG_DEBUG(k_ELogSteam, "StoreStats with %d changed stats, success: %d", cStats, bSuccess);
+
+    // If this failed, we never sent anything to the server, try again later. Steam keeps
+    // the values that were set, so they don't have to be set again.
+    m_bStoreStats = !bSuccess;
+    if (bSuccess)
+    {
+        for (int iStat = 0; iStat < k_EStatCount; ++iStat)
+        {
+            m_rgbStatDirty[iStat] = false;
+        }
+    }
+    else
+    {
+        STEAM_Journal::EndStore(false);
     }
 }
 
 // We have recieved stats data from Steam. We then immediately update our data.
 void STEAM_StatsAchievements::onUserStatsReceived(UserStatsReceived_t *pCallback)
 {
-    // printf("OnUserStatsReceived Callback\n");
+    ULOG_DEBUG(k_ELogSteam, "OnUserStatsReceived Callback");
+    UFlightRecorder::recordSteamCallback(k_EFlightUserStatsReceived, pCallback->m_eResult, pCallback->m_nGameID);
     m_bUsersStatsRecieved = true;
-    if (!mSteamUserStats)
+    if (!mSteamBackend)
         return;
 
     // we may get callbacks for other games' stats arriving, ignore them
@@ -220,34 +307,61 @@ void STEAM_StatsAchievements::onUserStatsReceived(UserStatsReceived_t *pCallback
     {
         if (k_EResultOK == pCallback->m_eResult)
         {
-            // printf("Received stats and achievements from Steam\n");
+            ULOG_INFO(k_ELogSteam, "Received stats and achievements from Steam");
             m_bStatsValid = true;
 
             // load achievements
             for (int iAch = 0; iAch < ACH_COUNT; ++iAch)
             {
                 Achievement_t &ach = g_rgAchievements[iAch];
-                mSteamUserStats->GetAchievement(ach.mAchievementIDChar, &ach.m_bAchieved);
-                // printf("[Achievement #%d]Name: %s, Desc: %s, Unlocked: %s\n", iAch, mSteamUserStats->GetAchievementDisplayAttribute(ach.mAchievementIDChar, "name"), mSteamUserStats->GetAchievementDisplayAttribute(ach.mAchievementIDChar, "desc"), ach.m_bAchieved ? "true" : "false");
+                mSteamBackend->GetAchievement(ach.mAchievementIDChar, &ach.m_bAchieved);
+                ULOG_DEBUG(k_ELogSteam, "[Achievement #%d]Name: %s, Desc: %s, Unlocked: %s", iAch, mSteamBackend->GetAchievementDisplayAttribute(ach.mAchievementIDChar, "name"), mSteamBackend->GetAchievementDisplayAttribute(ach.mAchievementIDChar, "desc"), ach.m_bAchieved ? "true" : "false");
+            }
+
+            // load stats, plus whatever the journal has that Steam doesn't
+            for (int iStat = 0; iStat < k_EStatCount; ++iStat)
+            {
+                if (g_rgStats[iStat].m_bStored)
+                {
+                    int32 nSteamValue = 0;
+                    mSteamBackend->GetStat(g_rgStats[iStat].m_pchName, &nSteamValue);
+                    m_rgnStats[iStat] = STEAM_Journal::ApplyStat(g_rgStats[iStat].m_pchName, nSteamValue);
+
+                    // only the stats the journal moved have to be sent
+                    m_rgbStatDirty[iStat] = m_rgnStats[iStat] != nSteamValue;
+                }
+            }
+
+            // unlock achievements earned while Steam couldn't be reached
+            std::vector<std::string> rgAchievements;
+            STEAM_Journal::GetAchievements(rgAchievements);
+            for (int iAch = 0; iAch < ACH_COUNT; ++iAch)
+            {
+                Achievement_t &ach = g_rgAchievements[iAch];
+                if (!ach.m_bAchieved && std::find(rgAchievements.begin(), rgAchievements.end(), ach.mAchievementIDChar) != rgAchievements.end())
+                {
+                    ach.m_bAchieved = true;
+                    mSteamBackend->SetAchievement(ach.mAchievementIDChar);
+                }
             }
 
-            // load stats
-            mSteamUserStats->GetStat("GamesPlayed", &mGamesPlayed);
-            mSteamUserStats->GetStat("TotalRuns", &mTotalRuns);
-            mSteamUserStats->GetStat("TotalLoops", &mTotalLoops);
+            // evaluate everything once, from now on achievements are evaluated as their stats change
+            for (int iAch = 0; iAch < ACH_COUNT; ++iAch)
+            {
+                evaluateAchievement(g_rgAchievements[iAch]);
+            }
 
-            // Increment the number of games played if this is a new game
-            if (m_bNewGame)
+            // Send the journal to Steam, this includes the game we just started. Unconfirmed
+            // achievements or stores that may not have arrived need a store even when no stat moved.
+            if (STEAM_Journal::HasStatsPending())
             {
-                ++mGamesPlayed;
-                mSteamUserStats->SetStat("GamesPlayed", mGamesPlayed);
-                storeStatsIfNecessary();
-                m_bNewGame = false;
+                m_bStoreStats = true;
             }
+            storeStatsIfNecessary(false);
         }
         else
         {
-            // printf("RequestStats - failed, %d\n", pCallback->m_eResult);
+            ULOG_ERROR(k_ELogSteam, "RequestStats - failed, %d", pCallback->m_eResult);
         }
     }
 }
@@ -255,20 +369,24 @@ void STEAM_StatsAchievements::onUserStatsReceived(UserStatsReceived_t *pCallback
 // Our stats data was stored!
 void STEAM_StatsAchievements::onUserStatsStored(UserStatsStored_t *pCallback)
 {
-    // printf("OnUserStatsStored Callback\n");
+    ULOG_DEBUG(k_ELogSteam, "OnUserStatsStored Callback");
+    UFlightRecorder::recordSteamCallback(k_EFlightUserStatsStored, pCallback->m_eResult, pCallback->m_nGameID);
 
     // We may get callbacks for other games' stats arriving, ignore them
     if (mGameId.ToUint64() == pCallback->m_nGameID)
     {
+        // Steam has everything journaled before this store now
+        STEAM_Journal::EndStore(k_EResultOK == pCallback->m_eResult);
+
         if (k_EResultOK == pCallback->m_eResult)
         {
-            // printf("StoreStats - success\n");
+            ULOG_DEBUG(k_ELogSteam, "StoreStats - success");
         }
         else if (k_EResultInvalidParam == pCallback->m_eResult)
         {
             // One or more stats we set broke a constraint. They've been reverted,
             // and we should re-iterate the values now to keep in sync.
-            // printf("StoreStats - some failed to validate\n");
+            ULOG_WARN(k_ELogSteam, "StoreStats - some failed to validate");
             // Fake up a callback here so that we re-load the values.
             UserStatsReceived_t callback;
             callback.m_eResult = k_EResultOK;
@@ -277,7 +395,9 @@ void STEAM_StatsAchievements::onUserStatsStored(UserStatsStored_t *pCallback)
         }
         else
         {
-            // printf("StoreStats - failed, %d\n", pCallback->m_eResult);
+            // The journal still has everything, try again on the next update
+            ULOG_ERROR(k_ELogSteam, "StoreStats - failed, %d", pCallback->m_eResult);
+            m_bStoreStats = true;
         }
     }
 }
@@ -285,18 +405,19 @@ void STEAM_StatsAchievements::onUserStatsStored(UserStatsStored_t *pCallback)
 // An achievements was stored
 void STEAM_StatsAchievements::onAchievementStored(UserAchievementStored_t *pCallback)
 {
-    // printf("OnAchievementStored Callback\n");
+    ULOG_DEBUG(k_ELogSteam, "OnAchievementStored Callback");
+    UFlightRecorder::recordSteamCallback(k_EFlightAchievementStored, pCallback->m_nCurProgress, pCallback->m_nGameID);
 
     // we may get callbacks for other games stats arriving, ignore them
     if (mGameId.ToUint64() == pCallback->m_nGameID)
     {
         if (0 == pCallback->m_nMaxProgress)
         {
-            // printf("Achievement '%s' unlocked!", pCallback->m_rgchAchievementName);
+            ULOG_INFO(k_ELogSteam, "Achievement '%s' unlocked!", pCallback->m_rgchAchievementName);
         }
         else
         {
-            // printf("Achievement '%s' progress callback, (%d / %d)\n", pCallback->m_rgchAchievementName, pCallback->m_nCurProgress, pCallback->m_nMaxProgress);
+            ULOG_INFO(k_ELogSteam, "Achievement '%s' progress callback, (%d / %d)", pCallback->m_rgchAchievementName, pCallback->m_nCurProgress, pCallback->m_nMaxProgress);
         }
     }
 }
@@ -304,13 +425,19 @@ void STEAM_StatsAchievements::onAchievementStored(UserAchievementStored_t *pCall
 // Clear all stats and achievements
 void STEAM_StatsAchievements::clearStatsAchievements()
 {
-    mSteamUserStats->ResetAllStats(true);
+    mSteamBackend->ResetAllStats(true);
 }
 
 // Free allocated resources
 void STEAM_StatsAchievements::free()
 {
+    // Send what's left and write out anything Steam hasn't confirmed, it's replayed next time
+    if (mSteamBackend)
+    {
+        flushStats();
+        STEAM_Journal::Close();
+    }
+
     // Prevent dangling pointers, their resources are deallocated later in the program
-    mSteamUserStats = nullptr;
-    mSteamUser = nullptr;
+    mSteamBackend = nullptr;
 }
\ No newline at end of file
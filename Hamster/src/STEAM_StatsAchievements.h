@@ -9,10 +9,7 @@
 #include "ULib.h"
 #include "UTexture.h"
 #include <deque>
-#include "../../Steam/steam_api.h"
-#include "../../Steam/isteamuser.h"
-#include "../../Steam/isteamuserstats.h"
-#include "../../Steam/steam_api_common.h"
+#include "STEAM_Backend.h"
 
 enum Achievements
 {
@@ -22,6 +19,25 @@ enum Achievements
     ACH_LONG_DISTANCE = 3,
 };
 
+// Stats achievements are unlocked by, the stored ones are kept on Steam. Add new stats
+// before k_EStatCount and describe them in g_rgStats.
+enum EStat
+{
+	k_EStatGamesPlayed,
+	k_EStatTotalRuns,
+	k_EStatTotalLoops,
+	k_EStatLoopsLastRun,
+	k_EStatCount
+};
+
+// How an achievement's stat is compared with its threshold
+enum EAchievementComparison
+{
+	k_EAchievementAtLeast,
+	k_EAchievementAtMost,
+	k_EAchievementEqual
+};
+
 struct Achievement_t
 {
 	Achievements mAchievementID;
@@ -30,6 +46,11 @@ struct Achievement_t
 	char m_rgchDescription[256];
 	bool m_bAchieved;
 	int m_iIconImage;
+
+	// Unlocked when m_eStat compared with m_nThreshold holds
+	EStat m_eStat;
+	EAchievementComparison m_eComparison;
+	int32 m_nThreshold;
 };
 
 class STEAM_StatsAchievements
@@ -47,11 +68,14 @@ public:
 	// Accumulators
 	void addLoops(int nLoops);
 
+	// Store the changed stats now instead of waiting for the store window
+	void flushStats();
+
 	// Accessors
-	int getTotalRuns() { return mTotalRuns; }
-	int getTotalLoops() { return mTotalLoops; }
-	int getGamesPlayed() { return mGamesPlayed; }
-	int getLoopsLastRun() { return mLoopsLastRun; }
+	int getTotalRuns() { return m_rgnStats[k_EStatTotalRuns]; }
+	int getTotalLoops() { return m_rgnStats[k_EStatTotalLoops]; }
+	int getGamesPlayed() { return m_rgnStats[k_EStatGamesPlayed]; }
+	int getLoopsLastRun() { return m_rgnStats[k_EStatLoopsLastRun]; }
 
 	// Clear all stats and achievements
 	void clearStatsAchievements();
@@ -63,44 +87,49 @@ public:
 	bool m_bUsersStatsRecieved = false;
 
 	// Our Steam callbacks
-	STEAM_CALLBACK(STEAM_StatsAchievements, onUserStatsReceived, UserStatsReceived_t, m_CallbackUserStatsReceived);
-	STEAM_CALLBACK(STEAM_StatsAchievements, onUserStatsStored, UserStatsStored_t, m_CallbackUserStatsStored);
-	STEAM_CALLBACK(STEAM_StatsAchievements, onAchievementStored, UserAchievementStored_t, m_CallbackAchievementStored);
+	STEAM_BACKEND_CALLBACK(STEAM_StatsAchievements, onUserStatsReceived, UserStatsReceived_t, m_CallbackUserStatsReceived);
+	STEAM_BACKEND_CALLBACK(STEAM_StatsAchievements, onUserStatsStored, UserStatsStored_t, m_CallbackUserStatsStored);
+	STEAM_BACKEND_CALLBACK(STEAM_StatsAchievements, onAchievementStored, UserAchievementStored_t, m_CallbackAchievementStored);
 
 private:
 
+	// Add nDelta to a stat, journaling it if it's kept on Steam
+	void addStat(EStat eStat, int32 nDelta);
+
+	// Change a stat and evaluate only the achievements that depend on it
+	void setStat(EStat eStat, int32 nValue);
+
 	// Determine if we get this achievement now
 	void evaluateAchievement(Achievement_t &achievement);
 	void unlockAchievement(Achievement_t &achievement);
 
-	// Store stats
-	void storeStatsIfNecessary();
+	// Store the changed stats, at most once every STATS_STORE_INTERVAL_MS unless bForce is set
+	void storeStatsIfNecessary(bool bForce);
 
 	// Our Game Id
 	CGameID mGameId;
 
-	// Steam User interface
-	ISteamUser *mSteamUser;
-
-	// Steam UserStats interface
-	ISteamUserStats *mSteamUserStats;
+	// Steam backend, nullptr if Steam isn't running
+	STEAM_Backend *mSteamBackend;
 
 	// Did we get the stats from Steam?
 	bool m_bRequestedStats;
 	bool m_bStatsValid;
 
-	// Should we store stats this frame?
+	// Should we store stats this frame? Set for achievements, stats have their own dirty flags
 	bool m_bStoreStats;
 
-	// Persisted Stat details
-	int mGamesPlayed;
-	int mTotalRuns;
-	int mTotalLoops;
-	int mLoopsLastRun;
+	// When StoreStats() was last called, and whether it has been
+	Uint32 m_unLastStoreTicks;
+	bool m_bStoredOnce;
+
+	// Stat values, indexed by EStat, and which stored ones changed since the last StoreStats()
+	int32 m_rgnStats[k_EStatCount];
+	bool m_rgbStatDirty[k_EStatCount];
+
+	// Indices into g_rgAchievements of the achievements that depend on each stat
+	std::vector<int> m_rgAchievementsByStat[k_EStatCount];
 
-	// Used to increment the mGamesPlayed count
-	bool m_bNewGame;
-	
 	// Render helper variables
 	float m_flCurrAchTime;
 	bool m_bFullyOpaque;
@@ -0,0 +1,200 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UAudio.cpp
+*/
+#include "UAudio.h"
+#include "ULog.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+// Most buffers the device is assumed to hold ahead of the callback, so the audio clock and the
+// performance counter drifting apart can't build up a queue that isn't there
+#define AUDIO_MAX_QUEUED_BUFFERS 4
+
+namespace
+{
+    // Mixer format, set by the game thread while the post mix callback isn't running
+    int gBufferFrames = AUDIO_DEFAULT_BUFFER;
+    int gFrequency = AUDIO_REQUEST_FREQUENCY;
+    int gFrameBytes = 4;
+    bool gOpen = false;
+    Uint64 gOpenCounter = 0;
+    Uint32 gFallbacks = 0;
+
+    // Underruns counted at the start of the current fallback window, game thread only
+    Uint32 gWindowStartTicks = 0;
+    Uint32 gWindowUnderruns = 0;
+
+    // When the audio handed to the device runs out, audio thread only
+    Uint64 gQueuedUntil = 0;
+
+    // Shared between the threads
+    std::atomic<Uint64> gSoundMark(0);
+    std::atomic<Uint32> gUnderruns(0);
+    std::atomic<Uint32> gLatencyUs(0);
+    std::atomic<Uint32> gMaxLatencyUs(0);
+}
+
+// Reads "--audio-buffer <frames>"
+void UAudio::parseArgs(int argc, char *args[])
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(args[i], "--audio-buffer") == 0)
+        {
+            unsigned long frames = strtoul(args[i + 1], nullptr, 10);
+            if (frames < AUDIO_MIN_BUFFER || frames > AUDIO_MAX_BUFFER || (frames & (frames - 1)) != 0)
+            {
+                ULOG_WARN(k_ELogAudio, "--audio-buffer wants a power of two from %d to %d, not \"%s\"", AUDIO_MIN_BUFFER, AUDIO_MAX_BUFFER, args[i + 1]);
+            }
+            else
+            {
+                gBufferFrames = static_cast<int>(frames);
+            }
+        }
+    }
+}
+
+// Open the mixer at the device's own sample rate, call after SDL_Init
+bool UAudio::open()
+{
+    return openDevice(AUDIO_REQUEST_FREQUENCY, gBufferFrames, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+}
+
+// Move to a bigger buffer when the device keeps running dry, called once a frame. True
+// when the mixer was reopened, its hooks have to be set again.
+bool UAudio::update()
+{
+    if (!gOpen)
+        return false;
+
+    Uint32 now = SDL_GetTicks();
+    if (static_cast<Sint32>(now - gWindowStartTicks) >= AUDIO_UNDERRUN_WINDOW_MS)
+    {
+        gWindowStartTicks = now;
+        gWindowUnderruns = gUnderruns.load();
+    }
+
+    Uint32 underruns = gUnderruns.load() - gWindowUnderruns;
+    if (underruns < AUDIO_UNDERRUN_LIMIT || gBufferFrames >= AUDIO_MAX_BUFFER)
+        return false;
+
+    // Same rate as before, so the sounds already decoded for it still play right
+    int bufferFrames = gBufferFrames * 2;
+    ULOG_WARN(k_ELogAudio, "Audio ran dry %u times with a %d frame buffer, reopening with %d", underruns, gBufferFrames, bufferFrames);
+    Mix_SetPostMix(nullptr, nullptr);
+    Mix_CloseAudio();
+    gOpen = false;
+    if (!openDevice(gFrequency, bufferFrames, 0))
+        return false;
+
+    ++gFallbacks;
+    return true;
+}
+
+// Note that a sound effect is about to be played, its latency is measured when it's mixed
+void UAudio::markSound()
+{
+    gSoundMark.store(SDL_GetPerformanceCounter());
+}
+
+// The current numbers
+AudioStats_t UAudio::getStats()
+{
+    AudioStats_t stats;
+    stats.mBufferFrames = gBufferFrames;
+    stats.mFrequency = gFrequency;
+    stats.mLatencyMs = gLatencyUs.load() / 1000.f;
+    stats.mMaxLatencyMs = gMaxLatencyUs.load() / 1000.f;
+    stats.mUnderruns = gUnderruns.load();
+    stats.mFallbacks = gFallbacks;
+    return stats;
+}
+
+// Log the numbers and close the mixer
+void UAudio::close()
+{
+    if (!gOpen)
+        return;
+
+    AudioStats_t stats = getStats();
+    ULOG_INFO(k_ELogAudio, "Audio: %d frame buffer at %d Hz, latency %.1f ms (at most %.1f), %u underruns, %u fallbacks",
+        stats.mBufferFrames, stats.mFrequency, stats.mLatencyMs, stats.mMaxLatencyMs, stats.mUnderruns, stats.mFallbacks);
+
+    Mix_SetPostMix(nullptr, nullptr);
+    Mix_CloseAudio();
+    gOpen = false;
+}
+
+// Open the mixer with aBufferFrames a callback
+bool UAudio::openDevice(int aFrequency, int aBufferFrames, int aAllowedChanges)
+{
+    if (Mix_OpenAudioDevice(aFrequency, MIX_DEFAULT_FORMAT, 2, aBufferFrames, nullptr, aAllowedChanges) < 0)
+    {
+        ULOG_ERROR(k_ELogAudio, "SDL_mixer could not open a %d frame buffer! SDL_mixer Error: %s", aBufferFrames, Mix_GetError());
+        return false;
+    }
+
+    Uint16 format = MIX_DEFAULT_FORMAT;
+    int channels = 2;
+    Mix_QuerySpec(&gFrequency, &format, &channels);
+    gFrameBytes = SDL_max(1, static_cast<int>(SDL_AUDIO_BITSIZE(format) / 8) * channels);
+    gBufferFrames = aBufferFrames;
+    gOpenCounter = SDL_GetPerformanceCounter();
+    gQueuedUntil = 0;
+    gWindowStartTicks = SDL_GetTicks();
+    gWindowUnderruns = gUnderruns.load();
+    gOpen = true;
+
+    // Setting the callback takes the mixer lock, so it sees everything above
+    Mix_SetPostMix(postMix, nullptr);
+
+    ULOG_INFO(k_ELogAudio, "Audio open at %d Hz with a %d frame buffer, %.1f ms", gFrequency, gBufferFrames, gBufferFrames * 1000.f / gFrequency);
+    return true;
+}
+
+// Post mix callback, times each buffer on the audio thread
+void UAudio::postMix(void *aUserData, Uint8 *aStream, int aLength)
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 perfFrequency = SDL_GetPerformanceFrequency();
+    Uint64 period = static_cast<Uint64>(aLength / gFrameBytes) * perfFrequency / gFrequency;
+
+    // The device asks for more before what it has runs out, a callback a whole buffer after
+    // that means it played silence in between
+    if (gQueuedUntil == 0)
+    {
+        gQueuedUntil = now;
+    }
+    else if (now > gQueuedUntil + period)
+    {
+        if (now - gOpenCounter >= perfFrequency * AUDIO_SETTLE_MS / 1000)
+        {
+            ++gUnderruns;
+        }
+        gQueuedUntil = now;
+    }
+    else if (now > gQueuedUntil)
+    {
+        gQueuedUntil = now;
+    }
+
+    // A sound played since the last callback was mixed into this buffer, which is heard once
+    // the audio queued ahead of it has played
+    Uint64 mark = gSoundMark.exchange(0);
+    if (mark != 0 && mark <= now)
+    {
+        Uint32 latencyUs = static_cast<Uint32>((gQueuedUntil - mark) * 1000000 / perfFrequency);
+        gLatencyUs.store(latencyUs);
+        if (latencyUs > gMaxLatencyUs.load())
+        {
+            gMaxLatencyUs.store(latencyUs);
+        }
+    }
+
+    gQueuedUntil = SDL_min(gQueuedUntil + period, now + period * AUDIO_MAX_QUEUED_BUFFERS);
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UAudio.h
+*/
+#pragma once
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+// Buffer sizes in frames, "--audio-buffer" takes any power of two between the two. A buffer
+// that keeps running dry is doubled up to AUDIO_MAX_BUFFER.
+#define AUDIO_MIN_BUFFER 256
+#define AUDIO_DEFAULT_BUFFER 512
+#define AUDIO_MAX_BUFFER 2048
+
+// Asked for when opening, the device is allowed to pick its own rate instead
+#define AUDIO_REQUEST_FREQUENCY 48000
+
+// This many underruns inside the window moves to the next buffer size
+#define AUDIO_UNDERRUN_LIMIT 3
+#define AUDIO_UNDERRUN_WINDOW_MS 5000
+
+// Underruns in the first moments after opening are the device starting up, not counted
+#define AUDIO_SETTLE_MS 1000
+
+// Numbers for the stats overlay
+struct AudioStats_t
+{
+    int mBufferFrames;
+    int mFrequency;
+    float mLatencyMs;          // From the newest sound effect being played to it being heard
+    float mMaxLatencyMs;
+    Uint32 mUnderruns;
+    Uint32 mFallbacks;         // Times the buffer was made bigger
+};
+
+// Opens the mixer and watches it from the post mix callback. Each callback is timed against
+// the audio already handed to the device: one that arrives after that audio has run out is an
+// underrun. A sound effect's latency is the time from it being played to the callback that
+// mixes it, plus the audio still queued ahead of it. Neither sees what the driver buffers
+// below SDL.
+class UAudio
+{
+public:
+    // Reads "--audio-buffer <frames>"
+    static void parseArgs(int argc, char *args[]);
+
+    // Open the mixer at the device's own sample rate, call after SDL_Init
+    static bool open();
+
+    // Move to a bigger buffer when the device keeps running dry, called once a frame. True
+    // when the mixer was reopened, its hooks have to be set again.
+    static bool update();
+
+    // Note that a sound effect is about to be played, its latency is measured when it's mixed
+    static void markSound();
+
+    // The current numbers
+    static AudioStats_t getStats();
+
+    // Log the numbers and close the mixer
+    static void close();
+
+private:
+    // Open the mixer with aBufferFrames a callback
+    static bool openDevice(int aFrequency, int aBufferFrames, int aAllowedChanges);
+
+    // Post mix callback, times each buffer on the audio thread
+    static void postMix(void *aUserData, Uint8 *aStream, int aLength);
+};
\ No newline at end of file
@@ -0,0 +1,524 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UBench.cpp
+*/
+#include "UBench.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+
+// Default fixed time step
+#define BENCH_DEFAULT_DT (1.0 / 60.0)
+
+// How long the run continues after the last scripted event
+#define BENCH_TAIL_SECONDS 1.0
+
+namespace
+{
+#ifdef HAMSTER_BENCH
+    // Every allocation made through operator new is counted
+    std::atomic<Uint64> gAllocCount(0);
+    std::atomic<Uint64> gAllocBytes(0);
+
+    // Count an allocation of aSize bytes
+    void countAllocation(size_t aSize)
+    {
+        gAllocCount.fetch_add(1, std::memory_order_relaxed);
+        gAllocBytes.fetch_add(aSize, std::memory_order_relaxed);
+    }
+#endif
+
+    // A scripted event and the simulated time it is injected at
+    struct BenchEvent
+    {
+        double mTime;
+        SDL_Event mEvent;
+    };
+
+    // Command line options
+    std::string gScriptPath;
+    std::string gOutPath;
+    double gDt = BENCH_DEFAULT_DT;
+
+    // Parsed script
+    std::vector<BenchEvent> gEvents;
+    double gEndTime = -1.0;
+
+    // Add a key press and release
+    void addKey(double aTime, SDL_Keycode aKey, double aHoldTime)
+    {
+        BenchEvent down;
+        SDL_zero(down.mEvent);
+        down.mTime = aTime;
+        down.mEvent.type = SDL_KEYDOWN;
+        down.mEvent.key.state = SDL_PRESSED;
+        down.mEvent.key.keysym.sym = aKey;
+        down.mEvent.key.keysym.scancode = SDL_GetScancodeFromKey(aKey);
+        gEvents.push_back(down);
+
+        BenchEvent up = down;
+        up.mTime = aTime + aHoldTime;
+        up.mEvent.type = SDL_KEYUP;
+        up.mEvent.key.state = SDL_RELEASED;
+        gEvents.push_back(up);
+    }
+
+    // Add a left mouse click
+    void addClick(double aTime, int aX, int aY)
+    {
+        BenchEvent down;
+        SDL_zero(down.mEvent);
+        down.mTime = aTime;
+        down.mEvent.type = SDL_MOUSEBUTTONDOWN;
+        down.mEvent.button.button = SDL_BUTTON_LEFT;
+        down.mEvent.button.state = SDL_PRESSED;
+        down.mEvent.button.clicks = 1;
+        down.mEvent.button.x = aX;
+        down.mEvent.button.y = aY;
+        gEvents.push_back(down);
+
+        BenchEvent up = down;
+        up.mEvent.type = SDL_MOUSEBUTTONUP;
+        up.mEvent.button.state = SDL_RELEASED;
+        gEvents.push_back(up);
+    }
+
+    // Add one text input event per character
+    void addText(double aTime, const std::string &aText)
+    {
+        for (char c : aText)
+        {
+            BenchEvent text;
+            SDL_zero(text.mEvent);
+            text.mTime = aTime;
+            text.mEvent.type = SDL_TEXTINPUT;
+            text.mEvent.text.text[0] = c;
+            gEvents.push_back(text);
+        }
+    }
+
+    // Read and parse the script file
+    bool loadScript(const std::string &aPath)
+    {
+        SDL_RWops *file = SDL_RWFromFile(aPath.c_str(), "rb");
+        if (file == nullptr)
+        {
+            ULOG_ERROR(k_ELogGame, "Unable to open benchmark script %s! SDL Error: %s", aPath, SDL_GetError());
+            return false;
+        }
+
+        std::string text(static_cast<size_t>(SDL_max(SDL_RWsize(file), 0)), '\0');
+        if (!text.empty())
+        {
+            SDL_RWread(file, &text[0], 1, text.size());
+        }
+        SDL_RWclose(file);
+
+        std::istringstream lines(text);
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(lines, line))
+        {
+            ++lineNumber;
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream words(line);
+            double time;
+            std::string command;
+            if (!(words >> time))
+                continue;
+            if (!(words >> command))
+            {
+                ULOG_ERROR(k_ELogGame, "%s:%d: missing command", aPath, lineNumber);
+                return false;
+            }
+
+            if (command == "key" || command == "mash")
+            {
+                std::string keyName;
+                double hz = 1.0, seconds = 0.0;
+                words >> keyName;
+                if (command == "mash")
+                    words >> hz >> seconds;
+
+                SDL_Keycode key = SDL_GetKeyFromName(keyName.c_str());
+                if (key == SDLK_UNKNOWN || words.fail() || hz <= 0.0)
+                {
+                    ULOG_ERROR(k_ELogGame, "%s:%d: bad %s command", aPath, lineNumber, command);
+                    return false;
+                }
+
+                // A single key press is held for one frame, mashed keys for half the period
+                int presses = command == "mash" ? static_cast<int>(hz * seconds) : 1;
+                double hold = command == "mash" ? 0.5 / hz : gDt;
+                for (int i = 0; i < presses; ++i)
+                {
+                    addKey(time + i / hz, key, hold);
+                }
+            }
+            else if (command == "text")
+            {
+                std::string chars;
+                words >> chars;
+                addText(time, chars);
+            }
+            else if (command == "click")
+            {
+                int x = 0, y = 0;
+                if (!(words >> x >> y))
+                {
+                    ULOG_ERROR(k_ELogGame, "%s:%d: bad click command", aPath, lineNumber);
+                    return false;
+                }
+                addClick(time, x, y);
+            }
+            else if (command == "end")
+            {
+                gEndTime = time;
+            }
+            else
+            {
+                ULOG_ERROR(k_ELogGame, "%s:%d: unknown command %s", aPath, lineNumber, command);
+                return false;
+            }
+        }
+
+        std::stable_sort(gEvents.begin(), gEvents.end(), [](const BenchEvent &a, const BenchEvent &b) { return a.mTime < b.mTime; });
+
+        if (gEndTime < 0.0)
+        {
+            gEndTime = (gEvents.empty() ? 0.0 : gEvents.back().mTime) + BENCH_TAIL_SECONDS;
+        }
+        return true;
+    }
+
+    // Append formatted text to a string
+    template<typename... Args>
+    void appendf(std::string &aOut, const char *aFormat, Args... args)
+    {
+        char line[512];
+        int len = snprintf(line, sizeof(line), aFormat, args...);
+        if (len > 0)
+            aOut.append(line, SDL_min(static_cast<size_t>(len), sizeof(line) - 1));
+    }
+
+    // Append the distribution of a set of samples as a JSON object
+    void appendStats(std::string &aOut, const char *aName, std::vector<double> aSamples)
+    {
+        if (aSamples.empty())
+        {
+            appendf(aOut, "  \"%s\": {},\n", aName);
+            return;
+        }
+
+        std::sort(aSamples.begin(), aSamples.end());
+        double sum = 0.0;
+        for (double sample : aSamples)
+            sum += sample;
+
+        auto percentile = [&aSamples](double p)
+        {
+            size_t index = static_cast<size_t>(p * (aSamples.size() - 1) + 0.5);
+            return aSamples[index];
+        };
+
+        appendf(aOut, "  \"%s\": { \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"p999\": %.3f, \"max\": %.3f },\n",
+            aName, sum / aSamples.size(), percentile(0.5), percentile(0.9), percentile(0.99), percentile(0.999), aSamples.back());
+    }
+}
+
+#ifdef HAMSTER_BENCH
+// Counting allocator, replaces the global operator new for the whole program. Only built
+// with HAMSTER_BENCH so the shipped game doesn't pay for the counters.
+void *operator new(size_t aSize)
+{
+    countAllocation(aSize);
+
+    void *p = malloc(aSize ? aSize : 1);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t aSize)
+{
+    return operator new(aSize);
+}
+
+void *operator new(size_t aSize, const std::nothrow_t &) noexcept
+{
+    countAllocation(aSize);
+    return malloc(aSize ? aSize : 1);
+}
+
+void *operator new[](size_t aSize, const std::nothrow_t &aTag) noexcept
+{
+    return operator new(aSize, aTag);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    free(p);
+}
+
+#ifdef __cpp_aligned_new
+// Over-aligned types, which need their own allocation and free functions
+void *operator new(size_t aSize, std::align_val_t aAlign)
+{
+    countAllocation(aSize);
+
+    size_t alignment = static_cast<size_t>(aAlign);
+    void *p = nullptr;
+#ifdef _WIN32
+    p = _aligned_malloc(aSize ? aSize : 1, alignment);
+#else
+    if (posix_memalign(&p, SDL_max(alignment, sizeof(void *)), aSize ? aSize : 1) != 0)
+        p = nullptr;
+#endif
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t aSize, std::align_val_t aAlign)
+{
+    return operator new(aSize, aAlign);
+}
+
+void *operator new(size_t aSize, std::align_val_t aAlign, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return operator new(aSize, aAlign);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t aSize, std::align_val_t aAlign, const std::nothrow_t &aTag) noexcept
+{
+    return operator new(aSize, aAlign, aTag);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void operator delete[](void *p, std::align_val_t aAlign) noexcept
+{
+    operator delete(p, aAlign);
+}
+
+void operator delete(void *p, size_t, std::align_val_t aAlign) noexcept
+{
+    operator delete(p, aAlign);
+}
+
+void operator delete[](void *p, size_t, std::align_val_t aAlign) noexcept
+{
+    operator delete(p, aAlign);
+}
+
+void operator delete(void *p, std::align_val_t aAlign, const std::nothrow_t &) noexcept
+{
+    operator delete(p, aAlign);
+}
+
+void operator delete[](void *p, std::align_val_t aAlign, const std::nothrow_t &) noexcept
+{
+    operator delete(p, aAlign);
+}
+#endif
+#endif
+
+// Number of heap allocations and bytes allocated since startup, always 0 without HAMSTER_BENCH
+Uint64 UBench::allocationCount()
+{
+#ifdef HAMSTER_BENCH
+    return gAllocCount.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+Uint64 UBench::allocationBytes()
+{
+#ifdef HAMSTER_BENCH
+    return gAllocBytes.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+// Parse the command line, returns true if a benchmark was requested
+bool UBench::parseArgs(int argc, char *args[])
+{
+    if (argc < 3 || strcmp(args[1], "--bench") != 0)
+        return false;
+
+    gScriptPath = args[2];
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        if (strcmp(args[i], "--out") == 0)
+        {
+            gOutPath = args[i + 1];
+        }
+        else if (strcmp(args[i], "--dt") == 0)
+        {
+            gDt = atof(args[i + 1]);
+            if (gDt <= 0.0)
+                gDt = BENCH_DEFAULT_DT;
+        }
+    }
+    return true;
+}
+
+// Select the dummy drivers and the software renderer, call before SDL_Init
+void UBench::configureSDL(UWindow &aWindow)
+{
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    aWindow.setRendererFlags(SDL_RENDERER_SOFTWARE);
+}
+
+// Run the script against the game and write the results, returns the exit code
+int UBench::run(UGame &aGame, SDL_Renderer *aRenderer)
+{
+    if (!loadScript(gScriptPath))
+        return 1;
+
+    ULOG_INFO(k_ELogGame, "Benchmark %s: %u events, %.3f s at dt %.6f", gScriptPath, static_cast<unsigned>(gEvents.size()), gEndTime, gDt);
+#ifndef HAMSTER_BENCH
+    ULOG_WARN(k_ELogGame, "Built without HAMSTER_BENCH, allocations aren't counted, use the Bench configuration");
+#endif
+
+    std::vector<double> frameUs, updateUs, renderUs;
+    size_t frames = static_cast<size_t>(gEndTime / gDt) + 1;
+    frameUs.reserve(frames);
+    updateUs.reserve(frames);
+    renderUs.reserve(frames);
+
+    const double usPerTick = 1000000.0 / SDL_GetPerformanceFrequency();
+    const Uint64 allocStart = allocationCount();
+    const Uint64 bytesStart = allocationBytes();
+    const Uint32 drawStart = UTexture::sRenderCount;
+    const Uint32 texturesStart = UTexture::sTextureCount;
+    const Uint64 wallStart = SDL_GetPerformanceCounter();
+
+    SDL_Event e;
+    size_t nextEvent = 0;
+    double simTime = 0.0;
+    bool quit = false;
+    while (!quit && simTime <= gEndTime)
+    {
+        // Inject the events that are due
+        while (nextEvent < gEvents.size() && gEvents[nextEvent].mTime <= simTime)
+        {
+            SDL_PushEvent(&gEvents[nextEvent++].mEvent);
+        }
+
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        while (SDL_PollEvent(&e) != 0)
+        {
+            UFlightRecorder::recordInput(e);
+            quit = aGame.handleEvent(e) || quit;
+        }
+        aGame.update(static_cast<float>(gDt));
+        Uint64 updateEnd = SDL_GetPerformanceCounter();
+
+        SDL_SetRenderDrawColor(aRenderer, 0xD3, 0xD3, 0xD3, 0xFF);
+        SDL_RenderClear(aRenderer);
+        aGame.render();
+        SDL_RenderPresent(aRenderer);
+        Uint64 frameEnd = SDL_GetPerformanceCounter();
+
+        frameUs.push_back((frameEnd - frameStart) * usPerTick);
+        updateUs.push_back((updateEnd - frameStart) * usPerTick);
+        renderUs.push_back((frameEnd - updateEnd) * usPerTick);
+        UFlightRecorder::recordFrame(static_cast<Uint32>(frameUs.back()), static_cast<Uint32>(gDt * 1000000.0));
+
+        simTime += gDt;
+    }
+
+    double wallSeconds = (SDL_GetPerformanceCounter() - wallStart) * usPerTick / 1000000.0;
+    Uint64 allocations = allocationCount() - allocStart;
+    Uint64 bytes = allocationBytes() - bytesStart;
+    Uint32 draws = UTexture::sRenderCount - drawStart;
+    Uint32 textures = UTexture::sTextureCount - texturesStart;
+    double frameCount = static_cast<double>(SDL_max(frameUs.size(), static_cast<size_t>(1)));
+
+    SDL_RendererInfo info;
+    SDL_zero(info);
+    SDL_GetRendererInfo(aRenderer, &info);
+
+    std::string json = "{\n";
+    appendf(json, "  \"script\": \"%s\",\n", gScriptPath.c_str());
+    appendf(json, "  \"dt\": %.6f,\n", gDt);
+    appendf(json, "  \"frames\": %u,\n", static_cast<unsigned>(frameUs.size()));
+    appendf(json, "  \"sim_seconds\": %.3f,\n", simTime);
+    appendf(json, "  \"wall_seconds\": %.3f,\n", wallSeconds);
+    appendStats(json, "frame_us", frameUs);
+    appendStats(json, "update_us", updateUs);
+    appendStats(json, "render_us", renderUs);
+    appendf(json, "  \"allocations\": { \"count\": %llu, \"bytes\": %llu, \"per_frame\": %.2f },\n",
+        static_cast<unsigned long long>(allocations), static_cast<unsigned long long>(bytes), allocations / frameCount);
+    appendf(json, "  \"renderer\": { \"name\": \"%s\", \"draw_calls\": %u, \"draw_calls_per_frame\": %.2f, \"textures_created\": %u },\n",
+        info.name ? info.name : "", draws, draws / frameCount, textures);
+    appendf(json, "  \"final_state\": %d\n", static_cast<int>(aGame.getState()));
+    json += "}\n";
+
+    if (gOutPath.empty())
+    {
+        fputs(json.c_str(), stdout);
+        return 0;
+    }
+
+    SDL_RWops *file = SDL_RWFromFile(gOutPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        ULOG_ERROR(k_ELogGame, "Unable to write %s! SDL Error: %s", gOutPath, SDL_GetError());
+        return 1;
+    }
+    SDL_RWwrite(file, json.data(), 1, json.size());
+    SDL_RWclose(file);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UBench.h
+*/
+#pragma once
+#include "UGame.h"
+
+// Headless benchmark mode, "Hamster --bench <script> [--out <file>] [--dt <seconds>]".
+// The whole game runs on the dummy video and audio drivers with the software renderer
+// and without Steam. Input comes from a script of timed events and the game steps with a
+// fixed dt as fast as it can, then the frame times, allocation counts and renderer
+// statistics are written as JSON.
+//
+// Script lines are "<seconds> <command> [arguments]", '#' starts a comment:
+//     0.0  key Space            press and release a key (SDL key names)
+//     1.0  mash Space 15 34     press a key 15 times a second for 34 seconds
+//     2.0  text ABC             type text
+//     3.0  click 700 480        click the left mouse button
+//     4.0  end                  stop the run, otherwise it ends a second after the last event
+class UBench
+{
+public:
+    // Parse the command line, returns true if a benchmark was requested
+    static bool parseArgs(int argc, char *args[]);
+
+    // Select the dummy drivers and the software renderer, call before SDL_Init
+    static void configureSDL(UWindow &aWindow);
+
+    // Run the script against the game and write the results, returns the exit code
+    static int run(UGame &aGame, SDL_Renderer *aRenderer);
+
+    // Number of heap allocations and bytes allocated since startup. Only counted in the
+    // Bench|x64 configuration, which defines HAMSTER_BENCH, otherwise always 0.
+    static Uint64 allocationCount();
+    static Uint64 allocationBytes();
+};
\ No newline at end of file
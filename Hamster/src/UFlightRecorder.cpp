@@ -0,0 +1,440 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UFlightRecorder.cpp
+*/
+#include "UFlightRecorder.h"
+#include "ULog.h"
+#include "UStartupProfiler.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <share.h>
+#else
+#include <unistd.h>
+#endif
+
+// Number of records kept, must be a power of two. At 60 fps this is a little over two
+// minutes of frames plus their events.
+#define FLIGHT_CAPACITY 8192
+
+// Number of distinct asset paths remembered for the decoder
+#define FLIGHT_NAME_COUNT 64
+#define FLIGHT_NAME_BYTES 60
+
+// A frame that takes longer than this is treated as a hang and dumped once
+#define FLIGHT_STALL_MS 5000
+#define FLIGHT_WATCHDOG_MS 250
+
+// Dump reasons that aren't a signal number
+#define FLIGHT_REASON_MANUAL 0
+#define FLIGHT_REASON_STALL 1000
+
+// Dump file names
+#define FLIGHT_CRASH_FILE "hamster_crash.hfr"
+#define FLIGHT_STALL_FILE "hamster_stall.hfr"
+
+namespace
+{
+    // Dump file header
+    struct FlightHeader_t
+    {
+        char mMagic[4];
+        Uint32 mVersion;
+        Uint32 mReason;
+        Uint32 mDumpTimeMs;
+        Uint32 mRecordCount;
+        Uint32 mNameCount;
+    };
+
+    // Asset path remembered so the decoder can print names instead of hashes
+    struct FlightName_t
+    {
+        Uint32 mHash;
+        char mName[FLIGHT_NAME_BYTES];
+    };
+
+    // The ring of records and the total number of records ever written
+    FlightRecord_t gRecords[FLIGHT_CAPACITY];
+    std::atomic<Uint32> gNext(0);
+
+    // Asset path table
+    FlightName_t gNames[FLIGHT_NAME_COUNT];
+    std::atomic<Uint32> gNameCount(0);
+
+    // Watchdog state
+    std::thread gWatchdog;
+    std::atomic<bool> gRunning(false);
+    std::atomic<Uint32> gLastFrameMs(0);
+    std::atomic<bool> gFrameSeen(false);
+
+    // Event names used by the decoder
+    const char *const EVENT_NAMES[] = { "frame", "state", "input", "steam-call", "steam-callback", "asset" };
+    const char *const STEAM_NAMES[] = { "FindLeaderboard", "DownloadLeaderboardEntries", "UploadLeaderboardScore", "RequestCurrentStats", "StoreStats", "SetAchievement", "UserStatsReceived", "UserStatsStored", "UserAchievementStored" };
+    const char *const ASSET_NAMES[] = { "texture", "font", "music", "chunk" };
+    const char *const STATE_NAMES[] = { "START", "EXIT_SALOON", "WALKING", "WHEEL_STOPPED", "WHEEL_PLAY_STARTING", "WHEEL_PLAYING", "GAME_ENDED", "NEW_HIGHSCORE", "SETTINGS_MENU", "LEADERBOARD_MENU" };
+
+    // FNV-1a hash of an asset path
+    Uint32 hashPath(const char *aPath)
+    {
+        Uint32 hash = 2166136261u;
+        for (const char *c = aPath; *c; ++c)
+        {
+            hash ^= static_cast<Uint8>(*c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Remember the asset path for a hash, the table only grows
+    void rememberName(Uint32 aHash, const char *aPath)
+    {
+        Uint32 count = gNameCount.load(std::memory_order_acquire);
+        for (Uint32 i = 0; i < count; ++i)
+        {
+            if (gNames[i].mHash == aHash)
+                return;
+        }
+
+        Uint32 slot = gNameCount.fetch_add(1);
+        if (slot >= FLIGHT_NAME_COUNT)
+        {
+            gNameCount.store(FLIGHT_NAME_COUNT);
+            return;
+        }
+
+        gNames[slot].mHash = aHash;
+        size_t len = strlen(aPath);
+        const char *start = len >= FLIGHT_NAME_BYTES ? aPath + len - (FLIGHT_NAME_BYTES - 1) : aPath;
+        strncpy(gNames[slot].mName, start, FLIGHT_NAME_BYTES - 1);
+        gNames[slot].mName[FLIGHT_NAME_BYTES - 1] = '\0';
+    }
+
+    // Raw file output that is safe to use inside a signal handler
+    int openRaw(const char *aPath)
+    {
+#ifdef _WIN32
+        int fd = -1;
+        _sopen_s(&fd, aPath, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE);
+        return fd;
+#else
+        return open(aPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    }
+
+    bool writeRaw(int aFd, const void *aData, unsigned int aBytes)
+    {
+#ifdef _WIN32
+        return _write(aFd, aData, aBytes) == static_cast<int>(aBytes);
+#else
+        return write(aFd, aData, aBytes) == static_cast<ssize_t>(aBytes);
+#endif
+    }
+
+    void closeRaw(int aFd)
+    {
+#ifdef _WIN32
+        _close(aFd);
+#else
+        close(aFd);
+#endif
+    }
+
+    // Dump the recorder and let the default handler take the process down
+    void onCrashSignal(int aSignal)
+    {
+        UFlightRecorder::dump(FLIGHT_CRASH_FILE, static_cast<Uint32>(aSignal));
+
+        signal(aSignal, SIG_DFL);
+        raise(aSignal);
+    }
+
+    // Dump the recorder once per stall if the main loop stops producing frames
+    void watchdogMain()
+    {
+        bool stalled = false;
+        while (gRunning.load(std::memory_order_acquire))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(FLIGHT_WATCHDOG_MS));
+
+            if (!gFrameSeen.load(std::memory_order_acquire))
+                continue;
+
+            Uint32 sinceFrame = SDL_GetTicks() - gLastFrameMs.load(std::memory_order_acquire);
+            if (sinceFrame >= FLIGHT_STALL_MS && !stalled)
+            {
+                stalled = true;
+                ULOG_WARN(k_ELogGame, "No frame for %u ms, writing %s", sinceFrame, FLIGHT_STALL_FILE);
+                UFlightRecorder::dump(FLIGHT_STALL_FILE, FLIGHT_REASON_STALL);
+            }
+            else if (sinceFrame < FLIGHT_STALL_MS)
+            {
+                stalled = false;
+            }
+        }
+    }
+}
+
+// Install the crash handlers and start the stall watchdog
+void UFlightRecorder::init()
+{
+    signal(SIGSEGV, onCrashSignal);
+    signal(SIGABRT, onCrashSignal);
+
+    if (!gRunning)
+    {
+        gRunning = true;
+        gWatchdog = std::thread(watchdogMain);
+    }
+}
+
+// Stop the watchdog and restore the default crash handlers
+void UFlightRecorder::free()
+{
+    gRunning = false;
+    if (gWatchdog.joinable())
+    {
+        gWatchdog.join();
+    }
+
+    signal(SIGSEGV, SIG_DFL);
+    signal(SIGABRT, SIG_DFL);
+}
+
+// Claim the next record in the ring
+FlightRecord_t &UFlightRecorder::next(EFlightEvent aType)
+{
+    FlightRecord_t &record = gRecords[gNext.fetch_add(1, std::memory_order_relaxed) & (FLIGHT_CAPACITY - 1)];
+    record.mTimeMs = SDL_GetTicks();
+    record.mType = static_cast<Uint8>(aType);
+    return record;
+}
+
+// Record a finished frame, this also feeds the stall watchdog
+void UFlightRecorder::recordFrame(Uint32 aFrameUs, Uint32 aDtUs)
+{
+    FlightRecord_t &record = next(k_EFlightFrame);
+    record.mArg0 = 0;
+    record.mArg1 = 0;
+    record.mArg2 = aFrameUs;
+    record.mArg3 = aDtUs;
+
+    gLastFrameMs.store(record.mTimeMs, std::memory_order_release);
+    gFrameSeen.store(true, std::memory_order_release);
+}
+
+// Record a GameState transition
+void UFlightRecorder::recordState(int aFrom, int aTo)
+{
+    FlightRecord_t &record = next(k_EFlightState);
+    record.mArg0 = static_cast<Uint8>(aFrom);
+    record.mArg1 = static_cast<Uint16>(aTo);
+    record.mArg2 = 0;
+    record.mArg3 = 0;
+}
+
+// Record an input event, events that aren't input are ignored
+void UFlightRecorder::recordInput(const SDL_Event &e)
+{
+    Uint32 arg2 = 0, arg3 = 0;
+    switch (e.type)
+    {
+    case SDL_KEYDOWN:
+        arg2 = static_cast<Uint32>(e.key.keysym.sym);
+        arg3 = e.key.repeat;
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+        arg2 = static_cast<Uint32>(e.button.x);
+        arg3 = static_cast<Uint32>(e.button.y);
+        break;
+    case SDL_TEXTINPUT:
+        arg2 = static_cast<Uint8>(e.text.text[0]);
+        break;
+    case SDL_QUIT:
+        break;
+    default:
+        return;
+    }
+
+    FlightRecord_t &record = next(k_EFlightInput);
+    record.mArg0 = 0;
+    record.mArg1 = static_cast<Uint16>(e.type);
+    record.mArg2 = arg2;
+    record.mArg3 = arg3;
+}
+
+// Record an outgoing Steam API call
+void UFlightRecorder::recordSteamCall(EFlightSteam aCall, Uint64 aHandle)
+{
+    FlightRecord_t &record = next(k_EFlightSteamCall);
+    record.mArg0 = static_cast<Uint8>(aCall);
+    record.mArg1 = 0;
+    record.mArg2 = static_cast<Uint32>(aHandle);
+    record.mArg3 = static_cast<Uint32>(aHandle >> 32);
+}
+
+// Record a Steam callback or call result
+void UFlightRecorder::recordSteamCallback(EFlightSteam aCallback, int aResult, Uint64 aHandle)
+{
+    FlightRecord_t &record = next(k_EFlightSteamCallback);
+    record.mArg0 = static_cast<Uint8>(aCallback);
+    record.mArg1 = static_cast<Uint16>(aResult);
+    record.mArg2 = static_cast<Uint32>(aHandle);
+    record.mArg3 = static_cast<Uint32>(aHandle >> 32);
+}
+
+// Record an asset load that started at aStartTicks (SDL_GetPerformanceCounter)
+void UFlightRecorder::recordAsset(EFlightAsset aKind, const std::string &aPath, bool aSuccess, Uint64 aStartTicks)
+{
+    Uint64 endTicks = SDL_GetPerformanceCounter();
+    Uint64 elapsed = endTicks - aStartTicks;
+    UStartupProfiler::recordAsset(aPath, aStartTicks, endTicks);
+    Uint32 hash = hashPath(aPath.c_str());
+    rememberName(hash, aPath.c_str());
+
+    FlightRecord_t &record = next(k_EFlightAssetLoad);
+    record.mArg0 = static_cast<Uint8>(aKind);
+    record.mArg1 = aSuccess ? 1 : 0;
+    record.mArg2 = hash;
+    record.mArg3 = static_cast<Uint32>((elapsed * 1000000) / SDL_GetPerformanceFrequency());
+}
+
+// Write the recorder contents to a file. Only raw file calls are used so this is safe to
+// call from the crash handler.
+bool UFlightRecorder::dump(const char *aPath, Uint32 aReason)
+{
+    int fd = openRaw(aPath);
+    if (fd < 0)
+        return false;
+
+    Uint32 total = gNext.load(std::memory_order_acquire);
+    Uint32 count = total < FLIGHT_CAPACITY ? total : FLIGHT_CAPACITY;
+    Uint32 first = total - count;
+    Uint32 names = gNameCount.load(std::memory_order_acquire);
+    names = names < FLIGHT_NAME_COUNT ? names : FLIGHT_NAME_COUNT;
+
+    FlightHeader_t header;
+    memcpy(header.mMagic, "HFR1", 4);
+    header.mVersion = 1;
+    header.mReason = aReason;
+    header.mDumpTimeMs = SDL_GetTicks();
+    header.mRecordCount = count;
+    header.mNameCount = names;
+
+    bool success = writeRaw(fd, &header, sizeof(header));
+    success = success && writeRaw(fd, gNames, static_cast<unsigned int>(names * sizeof(FlightName_t)));
+
+    // Write the ring oldest first, it may wrap around the end of the array
+    Uint32 start = first & (FLIGHT_CAPACITY - 1);
+    Uint32 firstPart = SDL_min(count, FLIGHT_CAPACITY - start);
+    success = success && writeRaw(fd, &gRecords[start], static_cast<unsigned int>(firstPart * sizeof(FlightRecord_t)));
+    success = success && writeRaw(fd, &gRecords[0], static_cast<unsigned int>((count - firstPart) * sizeof(FlightRecord_t)));
+
+    closeRaw(fd);
+    return success;
+}
+
+// Print a dump file in a readable form
+bool UFlightRecorder::decode(const char *aPath, FILE *aOut)
+{
+    SDL_RWops *file = SDL_RWFromFile(aPath, "rb");
+    if (file == nullptr)
+    {
+        fprintf(aOut, "Unable to open %s\n", aPath);
+        return false;
+    }
+
+    FlightHeader_t header;
+    if (SDL_RWread(file, &header, sizeof(header), 1) != 1 || memcmp(header.mMagic, "HFR1", 4) != 0 || header.mNameCount > FLIGHT_NAME_COUNT)
+    {
+        fprintf(aOut, "%s is not a flight recorder dump\n", aPath);
+        SDL_RWclose(file);
+        return false;
+    }
+
+    static FlightName_t names[FLIGHT_NAME_COUNT];
+    SDL_RWread(file, names, sizeof(FlightName_t), header.mNameCount);
+
+    if (header.mReason == FLIGHT_REASON_STALL)
+        fprintf(aOut, "Reason: frame stall\n");
+    else if (header.mReason == FLIGHT_REASON_MANUAL)
+        fprintf(aOut, "Reason: manual dump\n");
+    else
+        fprintf(aOut, "Reason: signal %u\n", header.mReason);
+    fprintf(aOut, "Dumped at %u ms, %u records\n\n", header.mDumpTimeMs, header.mRecordCount);
+
+    FlightRecord_t record;
+    for (Uint32 i = 0; i < header.mRecordCount && SDL_RWread(file, &record, sizeof(record), 1) == 1; ++i)
+    {
+        const char *event = record.mType < SDL_arraysize(EVENT_NAMES) ? EVENT_NAMES[record.mType] : "?";
+        fprintf(aOut, "%10u ms  %-14s ", record.mTimeMs, event);
+
+        switch (record.mType)
+        {
+        case k_EFlightFrame:
+            fprintf(aOut, "frame %.3f ms, dt %.3f ms\n", record.mArg2 / 1000.0, record.mArg3 / 1000.0);
+            break;
+
+        case k_EFlightState:
+            fprintf(aOut, "%s -> %s\n",
+                record.mArg0 < SDL_arraysize(STATE_NAMES) ? STATE_NAMES[record.mArg0] : "?",
+                record.mArg1 < SDL_arraysize(STATE_NAMES) ? STATE_NAMES[record.mArg1] : "?");
+            break;
+
+        case k_EFlightInput:
+            if (record.mArg1 == SDL_KEYDOWN)
+                fprintf(aOut, "key down %u%s\n", record.mArg2, record.mArg3 ? " (repeat)" : "");
+            else if (record.mArg1 == SDL_MOUSEBUTTONDOWN)
+                fprintf(aOut, "mouse down %u, %u\n", record.mArg2, record.mArg3);
+            else if (record.mArg1 == SDL_TEXTINPUT)
+                fprintf(aOut, "text '%c'\n", static_cast<char>(record.mArg2));
+            else
+                fprintf(aOut, "event 0x%x\n", record.mArg1);
+            break;
+
+        case k_EFlightSteamCall:
+        case k_EFlightSteamCallback:
+        {
+            Uint64 handle = (static_cast<Uint64>(record.mArg3) << 32) | record.mArg2;
+            const char *name = record.mArg0 < SDL_arraysize(STEAM_NAMES) ? STEAM_NAMES[record.mArg0] : "?";
+            if (record.mType == k_EFlightSteamCall)
+                fprintf(aOut, "%s handle %llu\n", name, static_cast<unsigned long long>(handle));
+            else
+                fprintf(aOut, "%s result %u handle %llu\n", name, record.mArg1, static_cast<unsigned long long>(handle));
+            break;
+        }
+
+        case k_EFlightAssetLoad:
+        {
+            const char *path = "?";
+            for (Uint32 n = 0; n < header.mNameCount; ++n)
+            {
+                if (names[n].mHash == record.mArg2)
+                {
+                    path = names[n].mName;
+                    break;
+                }
+            }
+            fprintf(aOut, "%s %s %.3f ms%s\n",
+                record.mArg0 < SDL_arraysize(ASSET_NAMES) ? ASSET_NAMES[record.mArg0] : "?",
+                path, record.mArg3 / 1000.0, record.mArg1 ? "" : " FAILED");
+            break;
+        }
+
+        default:
+            fprintf(aOut, "%u %u %u %u\n", record.mArg0, record.mArg1, record.mArg2, record.mArg3);
+            break;
+        }
+    }
+
+    SDL_RWclose(file);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UFlightRecorder.h
+*/
+#pragma once
+#include <SDL.h>
+#include <cstdio>
+#include <string>
+
+// Kinds of flight recorder events
+enum EFlightEvent
+{
+    k_EFlightFrame         = 0,
+    k_EFlightState         = 1,
+    k_EFlightInput         = 2,
+    k_EFlightSteamCall     = 3,
+    k_EFlightSteamCallback = 4,
+    k_EFlightAssetLoad     = 5
+};
+
+// Steam API calls and callbacks the recorder knows about
+enum EFlightSteam
+{
+    k_EFlightFindLeaderboard      = 0,
+    k_EFlightDownloadEntries      = 1,
+    k_EFlightUploadScore          = 2,
+    k_EFlightRequestStats         = 3,
+    k_EFlightStoreStats           = 4,
+    k_EFlightSetAchievement       = 5,
+    k_EFlightUserStatsReceived    = 6,
+    k_EFlightUserStatsStored      = 7,
+    k_EFlightAchievementStored    = 8
+};
+
+// Kinds of assets
+enum EFlightAsset
+{
+    k_EFlightTexture = 0,
+    k_EFlightFont    = 1,
+    k_EFlightMusic   = 2,
+    k_EFlightChunk   = 3
+};
+
+// A single 16 byte flight recorder entry, the meaning of the arguments depends on mType
+struct FlightRecord_t
+{
+    Uint32 mTimeMs;
+    Uint8 mType;
+    Uint8 mArg0;
+    Uint16 mArg1;
+    Uint32 mArg2;
+    Uint32 mArg3;
+};
+
+// Always-on recorder of the last few thousand frames of timing and events. The buffer is
+// dumped to disk when the game crashes or a frame stalls, and can be decoded with
+// "Hamster --decode-flight <file>".
+class UFlightRecorder
+{
+public:
+    // Install the crash handlers and start the stall watchdog
+    static void init();
+
+    // Stop the watchdog and restore the default crash handlers
+    static void free();
+
+    // Record a finished frame, this also feeds the stall watchdog
+    static void recordFrame(Uint32 aFrameUs, Uint32 aDtUs);
+
+    // Record a GameState transition
+    static void recordState(int aFrom, int aTo);
+
+    // Record an input event, events that aren't input are ignored
+    static void recordInput(const SDL_Event &);
+
+    // Record an outgoing Steam API call
+    static void recordSteamCall(EFlightSteam aCall, Uint64 aHandle);
+
+    // Record a Steam callback or call result
+    static void recordSteamCallback(EFlightSteam aCallback, int aResult, Uint64 aHandle);
+
+    // Record an asset load that started at aStartTicks (SDL_GetPerformanceCounter)
+    static void recordAsset(EFlightAsset aKind, const std::string &aPath, bool aSuccess, Uint64 aStartTicks);
+
+    // Write the recorder contents to a file
+    static bool dump(const char *aPath, Uint32 aReason);
+
+    // Print a dump file in a readable form
+    static bool decode(const char *aPath, FILE *aOut);
+
+private:
+    // Claim the next record in the ring
+    static FlightRecord_t &next(EFlightEvent);
+};
\ No newline at end of file
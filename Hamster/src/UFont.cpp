@@ -48,6 +48,7 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
 {
     // Initialize the success flag
     bool success = true;
+    Uint64 loadStart;
 
     // Confirm that aRenderer and aSounds are valid pointers
     if (aRenderer && aSounds)
@@ -61,18 +62,22 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
     }
 
     // Initialize the sleep font
+    loadStart = SDL_GetPerformanceCounter();
     mSleepFont = TTF_OpenFont("assets/font.ttf", 18);
+    UFlightRecorder::recordAsset(k_EFlightFont, "assets/font.ttf", mSleepFont != nullptr, loadStart);
     if (!mSleepFont)
     {
-        // printf("Failed to load sleep font, SDL_ttf Error: %s\n", TTF_GetError());
+        ULOG_ERROR(k_ELogRender, "Failed to load sleep font, SDL_ttf Error: %s", TTF_GetError());
         success = false;
     }
 
     // Initialize the countdown font
+    loadStart = SDL_GetPerformanceCounter();
     mCountdownFont = TTF_OpenFont("assets/font.ttf", 450);
+    UFlightRecorder::recordAsset(k_EFlightFont, "assets/font.ttf", mCountdownFont != nullptr, loadStart);
     if (!mCountdownFont)
     {
-        // printf("Failed to load sleep font, SDL_ttf Error: %s\n", TTF_GetError());
+        ULOG_ERROR(k_ELogRender, "Failed to load countdown font, SDL_ttf Error: %s", TTF_GetError());
         success = false;
     }
     else
@@ -84,7 +89,7 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
         // Load the countdown text
         if (!mCountdownTexture.loadFromRenderedText("[NO VALUE]", BLACK_TEXT))
         {
-            // printf("Failed to load countdown texture!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load countdown texture!");
             success = false;
         }
         else
@@ -95,10 +100,12 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
     }
 
     // Initialize the game clock font
+    loadStart = SDL_GetPerformanceCounter();
     mMediumFont = TTF_OpenFont("assets/font.ttf", 92);
-    if (!mCountdownFont)
+    UFlightRecorder::recordAsset(k_EFlightFont, "assets/font.ttf", mMediumFont != nullptr, loadStart);
+    if (!mMediumFont)
     {
-        // printf("Failed to load sleep font, SDL_ttf Error: %s\n", TTF_GetError());
+        ULOG_ERROR(k_ELogRender, "Failed to load game clock font, SDL_ttf Error: %s", TTF_GetError());
         success = false;
     }
     else
@@ -109,7 +116,7 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
         // Load the game clock text
         if (!mGameClockTexture.loadFromRenderedText("[NO VALUE]", ORANGE_TEXT))
         {
-            // printf("Failed to load game clock texture!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load game clock texture!");
             success = false;
         }
         else
@@ -124,7 +131,7 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
         // Load the loop count text
         if (!mLoopCountTexture.loadFromRenderedText("[NO VALUE]", BLACK_TEXT))
         {
-            // printf("Failed to load loop count texture!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load loop count texture!");
             success = false;
         }
         else
@@ -139,7 +146,7 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
         // Load the loop count header text
         if (!mLoopCountHeaderTexture.loadFromRenderedText("Number of Loops", BLACK_TEXT))
         {
-            // printf("Failed to load loop count header texture!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load loop count header texture!");
                 success = false;
         }
         else
@@ -154,7 +161,7 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
         // Load the input header text
         if (!mInputHeaderTexture1.loadFromRenderedText("New Local Hi-Score!", BLACK_TEXT))
         {
-            // printf("Failed to load input header 1!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load input header 1!");
                 success = false;
         }
         mInputHeaderTexture2.initUTexture(mRenderer);
@@ -162,7 +169,7 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
         // Load the input header text
         if (!mInputHeaderTexture2.loadFromRenderedText("Enter name.", BLACK_TEXT))
         {
-            // printf("Failed to load input header 2!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load input header 2!");
             success = false;
         }
 
@@ -173,7 +180,7 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
         // Load the username input text
         if (!mInputTextTexture.loadFromRenderedText("_ _ _", BLACK_TEXT))
         {
-            // printf("Failed to load username input text!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load username input text!");
             success = false;
         }
 
@@ -183,7 +190,7 @@ bool UFont::init(SDL_Renderer *aRenderer, USound *aSounds)
         // Load the hgihscore text
         if (!mHighscoreTexture.loadFromRenderedText("[NON VALID]", BLACK_TEXT))
         {
-            // printf("Failed to load highscore texture!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load highscore texture!");
             success = false;
         }
     }
@@ -555,7 +562,7 @@ bool SleepZ::init(SDL_Renderer *aRenderer, TTF_Font *aFont, const std::string &a
     // Initialize what the sleep text contains
     if (!mTexture->loadFromRenderedText(aRenderText, WHITE_TEXT))
     {
-        // printf("Failed to load SleepZ text!\n");
+        ULOG_ERROR(k_ELogRender, "Failed to load SleepZ text!");
         success = false;
     }
     else
@@ -7,6 +7,10 @@
 */
 #include "UGame.h"
 
+// Location of the save file
+const char *const UGame::SAVE_PATH = "assets/save.bin";
+const char *const UGame::CLOUD_SAVE_NAME = "save.bin";
+
 // Seconds before the title fades out
 const float UGame::FADE_TIME = 3;
 
@@ -38,20 +42,35 @@ UGame::UGame()
 
     // Set the number of steps the hamster has made on this playthrough
     mStepCount = 0;
+    memset(mRunSplits, 0, sizeof(mRunSplits));
+    mRunTime = 0.f;
+    mRunStartCounter = 0;
+
+    mHeadless = false;
+
+    mShowStats = false;
+    mStatsFont = nullptr;
+    mNextStatsTicks = 0;
 
     // Pointer to the Steam utility classes
     m_pStatsAndAchievements = nullptr;
     m_pLeaderboards = nullptr;
+    m_pCloudSave = nullptr;
+    m_pRace = nullptr;
+    m_pInput = nullptr;
 }
 
 // Initializes and loads all the game objects
-bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
+bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow, bool aHeadless, const STEAM_RaceConfig_t *aRaceConfig)
 {
-    // Seed rand
-    srand(static_cast<unsigned>(time(0)));
+    mHeadless = aHeadless;
+
+    // Seed rand, headless runs use a fixed seed so they are repeatable
+    srand(mHeadless ? 1u : static_cast<unsigned>(time(0)));
 
     // Initialize success flag
     bool success = true;
+    UStartupScope profileScope("UGame::init");
 
     // Set the renderer and window
     mRenderer = aRenderer;
@@ -59,18 +78,20 @@ bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
 
     if (mRenderer == nullptr || mWindow == nullptr)
     {
-        // printf("Attempted to initialize the UGame object with nullptr! Pass in valid pointers in the UGame.init() function\n");
+        ULOG_ERROR(k_ELogGame, "Attempted to initialize the UGame object with nullptr! Pass in valid pointers in the UGame.init() function");
         success = false;
     }
     else
     {
         // Initialize the environment textures
         {
+            UStartupScope texturesScope("Environment textures");
+
             // Initialize the background texture
             mBackgroundTexture.initUTexture(mRenderer);
             if (!mBackgroundTexture.loadFromFile("assets/background.png"))
             {
-                // printf("Failed to load background texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load background texture!");
                 success = false;
             }
 
@@ -78,7 +99,7 @@ bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
             mGlassCageTexture.initUTexture(mRenderer);
             if (!mGlassCageTexture.loadFromFile("assets/glass_cage.png"))
             {
-                // printf("Failed to load glass cage texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load glass cage texture!");
                 success = false;
             }
 
@@ -86,7 +107,7 @@ bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
             mWheelArmTexture.initUTexture(mRenderer);
             if (!mWheelArmTexture.loadFromFile("assets/wheel_arm.png"))
             {
-                // printf("Failed to load wheel arm texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load wheel arm texture!");
                 success = false;
             }
 
@@ -94,7 +115,7 @@ bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
             mWheelTexture.initUTexture(mRenderer);
             if (!mWheelTexture.loadFromFile("assets/wheel.png"))
             {
-                // printf("Failed to load wheel texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load wheel texture!");
                 success = false;
             }
 
@@ -102,7 +123,7 @@ bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
             mHouseForegroundTexture.initUTexture(mRenderer);
             if (!mHouseForegroundTexture.loadFromFile("assets/house_foreground.png"))
             {
-                // printf("Failed to load house foreground texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load house foreground texture!");
                 success = false;
             }
 
@@ -110,7 +131,7 @@ bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
             mTitleTexture.initUTexture(mRenderer);
             if (!mTitleTexture.loadFromFile("assets/title.png"))
             {
-                // printf("Failed to load title texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load title texture!");
                 success = false;
             }
             else
@@ -123,15 +144,18 @@ bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
             mSettingsMenuTexture.initUTexture(mRenderer);
             if (!mSettingsMenuTexture.loadFromFile("assets/settings_menu.png"))
             {
-                // printf("Failed to load settings menu texture!\n");
+                ULOG_ERROR(k_ELogRender, "Failed to load settings menu texture!");
                 success = false;
             }
         }
 
         // Initialize the sounds
-        if (!mSounds.init())
+        UStartupProfiler::begin("USound::init");
+        bool soundsLoaded = mSounds.init();
+        UStartupProfiler::end();
+        if (!soundsLoaded)
         {
-            // printf("Failed to load sounds!\n");
+            ULOG_ERROR(k_ELogAudio, "Failed to load sounds!");
             success = false;
         }
         else
@@ -139,138 +163,216 @@ bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
             mSounds.playMenuMusic();
         }
 
+        // The stats overlay font, the game runs without the overlay if it's missing
+        if (!mHeadless)
+        {
+            Uint64 loadStart = SDL_GetPerformanceCounter();
+            mStatsFont = TTF_OpenFont("assets/font.ttf", 18);
+            UFlightRecorder::recordAsset(k_EFlightFont, "assets/font.ttf", mStatsFont != nullptr, loadStart);
+            if (mStatsFont == nullptr)
+            {
+                ULOG_WARN(k_ELogRender, "Failed to load the stats overlay font! SDL_ttf Error: %s", TTF_GetError());
+            }
+            mStatsTexture.initUTexture(mRenderer);
+            mStatsTexture.initFont(mStatsFont);
+        }
+
         // Initialize the hamster
+        UStartupProfiler::begin("GHamster::init");
         if (!mHamster.init(mRenderer, "assets/hamster.png", &mSounds))
         {
-            // printf("Failed to load hamster!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load hamster!");
             success = false;
         }
+        UStartupProfiler::end();
 
         // Initialize the fonts
+        UStartupProfiler::begin("UFont::init");
         if (!mFonts.init(mRenderer, &mSounds))
         {
-            // printf("Failed to load fonts!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load fonts!");
             success = false;
         }
+        UStartupProfiler::end();
+
+        UStartupProfiler::begin("Buttons");
 
         // Initialize the settings button
         if (!mSettingsButton.init(mRenderer, "assets/settings_button.png", SETTINGS_BTN_POSITION, OPTION_BTN_DIMENSION))
         {
-            // printf("Failed to load the settings button!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load the settings button!");
             success = false;
         }
 
         // Initialize the leaderboard button
         if (!mLeaderboardButton.init(mRenderer, "assets/leaderboard_button.png", LEADERBOARD_BTN_POSITION, OPTION_BTN_DIMENSION))
         {
-            // printf("Failed to load the leaderboard button!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load the leaderboard button!");
             success = false;
         }
 
         // Initialize the music button
         if (!mMusicButton.init(mRenderer, "assets/sound_button.png", MUSIC_BTN_POSITION, SOUND_BTN_DIMENSION))
         {
-            // printf("Failed to load the music button!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load the music button!");
             success = false;
         }
 
         // Initialize the sfx button
         if (!mSFXButton.init(mRenderer, "assets/sound_button.png", SFX_BTN_POSITION, SOUND_BTN_DIMENSION))
         {
-            // printf("Failed to load the sfx button!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load the sfx button!");
             success = false;
         }
 
         // Initialize the play again button
         if (!mPlayAgainButton.init(mRenderer, "assets/play_again_button.png", PLAY_AGAIN_BTN_POSITION, PLAY_AGAIN_BTN_DIMENSION))
         {
-            // printf("Failed to load the play again button!\n");
+            ULOG_ERROR(k_ELogRender, "Failed to load the play again button!");
             success = false;
         }
+        UStartupProfiler::end();
 
-        // Initialize the Steam utility classes
-        m_pStatsAndAchievements = new STEAM_StatsAchievements();
-        if (!m_pStatsAndAchievements->init())
+        // Initialize the Steam utility classes, when Steam or the local backend is running
+        if (SteamBackend())
         {
-            // printf("Failed to initialize the stats and achievements!\n");
-            success = false;
-        }
-        m_pLeaderboards = new STEAM_Leaderboards();
-        if (!m_pLeaderboards->init(mRenderer))
-        {
-            // printf("Failed to initialize the leaderboards!\n");
-            success = false;
+            UStartupProfiler::begin("STEAM_StatsAchievements::init");
+            m_pStatsAndAchievements = new STEAM_StatsAchievements();
+            if (!m_pStatsAndAchievements->init())
+            {
+                ULOG_ERROR(k_ELogSteam, "Failed to initialize the stats and achievements!");
+                success = false;
+            }
+            UStartupProfiler::end();
+
+            UStartupProfiler::begin("STEAM_Leaderboards::init");
+            m_pLeaderboards = new STEAM_Leaderboards();
+            if (!m_pLeaderboards->init(mRenderer))
+            {
+                ULOG_ERROR(k_ELogSteam, "Failed to initialize the leaderboards!");
+                success = false;
+            }
+            UStartupProfiler::end();
+
+            // Read controllers on their own thread, without Steam Input only the keyboard works
+            if (!mHeadless)
+            {
+                m_pInput = new STEAM_Input();
+                if (!m_pInput->init())
+                {
+                    delete m_pInput;
+                    m_pInput = nullptr;
+                }
+            }
+
+            // Start hosting or joining a race, the ghost wheel is drawn see through
+            if (aRaceConfig && !mHeadless)
+            {
+                m_pRace = new STEAM_Race();
+                if (!m_pRace->init(mRenderer, *aRaceConfig))
+                {
+                    ULOG_ERROR(k_ELogSteam, "Failed to start the race!");
+                    success = false;
+                }
+                mWheelTexture.setBlendMode(SDL_BLENDMODE_BLEND);
+            }
         }
     }
 
+    // Headless games start from a fresh save
+    if (success && mHeadless)
+    {
+        mFonts.setHighscore(0);
+        mFonts.setHighscoreUsername("   ");
+    }
+
     // Attempt to read pre-saved data
-    if (success)
+    else if (success)
     {
-        // Open file for reading in binary
-        SDL_RWops *file = SDL_RWFromFile("assets/save.bin", "r+b");
+        UStartupScope saveScope("Save read");
 
-        // File does not exist
-        if (file == nullptr)
+        success = readSave(SAVE_PATH);
+
+        // Fetch the cloud save in the background, it's merged whenever it arrives
+        if (SteamBackend())
         {
-            // printf("Warning: Unable to open file! SDL Error: %s\n", SDL_GetError());
+            m_pCloudSave = new STEAM_CloudSave();
+            m_pCloudSave->init(CLOUD_SAVE_NAME);
+        }
+    }
 
-            // Create file for writing
-            file = SDL_RWFromFile("assets/save.bin", "w+b");
+    return success;
+}
 
-            if (file != nullptr)
-            {
-                // Initialize data
-                long iData = 0;
-                SDL_RWwrite(file, &iData, sizeof(long), 2);
+// Read the save file, a missing save file is created with default values
+bool UGame::readSave(const char *aPath)
+{
+    bool success = true;
 
-                // Close file handler
-                SDL_RWclose(file);
+    // Open file for reading in binary
+    SDL_RWops *file = SDL_RWFromFile(aPath, "r+b");
 
-                // Set the high score to 0
-                mFonts.setHighscore(0);
-                mFonts.setHighscoreUsername("   ");
-            }
-            else
-            {
-                // printf("Error: Unable to create file! SDL Error: %s\n", SDL_GetError());
-                success = false;
-            }
-        }
+    // File does not exist
+    if (file == nullptr)
+    {
+        ULOG_WARN(k_ELogSave, "Unable to open file! SDL Error: %s", SDL_GetError());
+
+        // Create file for writing
+        file = SDL_RWFromFile(aPath, "w+b");
+
+        if (file != nullptr)
+        {
+            // Initialize data
+            long iData = 0;
+            SDL_RWwrite(file, &iData, sizeof(long), 2);
+
+            // Close file handler
+            SDL_RWclose(file);
 
-        // File exists
+            // Set the high score to 0
+            mFonts.setHighscore(0);
+            mFonts.setHighscoreUsername("   ");
+        }
         else
         {
-            // Default initialize the savedData array
-            unsigned int savedData[SAVED_DATA_COUNT] = {};
+            ULOG_ERROR(k_ELogSave, "Unable to create file! SDL Error: %s", SDL_GetError());
+            success = false;
+        }
+    }
 
-            for (int i = 0; i < SAVED_DATA_COUNT; ++i)
-            {
-                SDL_RWread(file, &savedData[i], sizeof(long), 1);
-            }
+    // File exists
+    else
+    {
+        // Default initialize the savedData array
+        unsigned int savedData[SAVED_DATA_COUNT] = {};
 
-            // Read the highscore username from the saved data
-            std::string usrnme;
-            usrnme += static_cast<char>(savedData[USERNAME_CHAR_1]);
-            usrnme += static_cast<char>(savedData[USERNAME_CHAR_2]);
-            usrnme += static_cast<char>(savedData[USERNAME_CHAR_3]);
+        for (int i = 0; i < SAVED_DATA_COUNT; ++i)
+        {
+            SDL_RWread(file, &savedData[i], sizeof(long), 1);
+        }
 
-            // Set the highscore and highscore username from the saved data
-            mFonts.setHighscore(savedData[HI_SCORE_DATA]);
-            mFonts.setHighscoreUsername(usrnme);
+        // Read the highscore username from the saved data
+        std::string usrnme;
+        usrnme += static_cast<char>(savedData[USERNAME_CHAR_1]);
+        usrnme += static_cast<char>(savedData[USERNAME_CHAR_2]);
+        usrnme += static_cast<char>(savedData[USERNAME_CHAR_3]);
 
-            // Set the music and sound effects to the previous save state
-            if (savedData[SFX_MUTED])
-            {
-                mSounds.toggleSFXMute();
-            }
-            if (savedData[MUSIC_MUTED])
-            {
-                mSounds. toggleMusicMute();
-            }
+        // Set the highscore and highscore username from the saved data
+        mFonts.setHighscore(savedData[HI_SCORE_DATA]);
+        mFonts.setHighscoreUsername(usrnme);
 
-            // Close file handler
-            SDL_RWclose(file);
+        // Set the music and sound effects to the previous save state
+        if (savedData[SFX_MUTED])
+        {
+            mSounds.toggleSFXMute();
         }
+        if (savedData[MUSIC_MUTED])
+        {
+            mSounds. toggleMusicMute();
+        }
+
+        // Close file handler
+        SDL_RWclose(file);
     }
 
     return success;
@@ -279,8 +381,30 @@ bool UGame::init(SDL_Renderer *aRenderer, UWindow *aWindow)
 // Update the game world based on the time since the last update
 void UGame::update(const float &dt)
 {
-    // Check if the settings button has been clicked
-    if (mSettingsButton.clicked())
+    // Remember the state so transitions can be recorded
+    GameState startState = mCurrState;
+
+    // Run the handlers for the Steam callbacks and call results that came in since last frame
+    STEAM_Pump::Dispatch();
+    syncCloudSave();
+
+    // Fall back to a bigger audio buffer when the device keeps running dry
+    if (!mHeadless && UAudio::update())
+    {
+        mSounds.audioReopened();
+    }
+
+    // Trade states with the opponent
+    if (m_pRace)
+    {
+        m_pRace->Update(mCurrState == GameState::WHEEL_PLAYING, mStepCount);
+    }
+
+    // Play the controller presses before anything looks at the game state
+    bool menuPressed = handleControllerInput();
+
+    // Check if the settings button has been clicked, or the controller's menu button pressed
+    if (mSettingsButton.clicked() || menuPressed)
     {
         // Close the settings menu
         if (mCurrState == GameState::SETTINGS_MENU)
@@ -301,7 +425,7 @@ void UGame::update(const float &dt)
     }
 
     // Check if the leaderboard button has been clicked
-    if (m_pStatsAndAchievements->m_bUsersStatsRecieved && mLeaderboardButton.clicked())
+    if (m_pStatsAndAchievements && m_pStatsAndAchievements->m_bUsersStatsRecieved && mLeaderboardButton.clicked())
     {
         // Close the leaderboard menu
         if (mCurrState == GameState::LEADERBOARD_MENU)
@@ -322,7 +446,16 @@ void UGame::update(const float &dt)
         }
     }
 
-    m_pStatsAndAchievements->update(dt);
+    if (m_pStatsAndAchievements)
+    {
+        m_pStatsAndAchievements->update(dt);
+    }
+
+    // Send queued leaderboard scores
+    if (m_pLeaderboards)
+    {
+        m_pLeaderboards->RunUploads();
+    }
 
     // Add sleep Z's if the hamster is currently sleeping
     if (mHamster.sleeping() && mCurrState != GameState::SETTINGS_MENU)
@@ -407,6 +540,9 @@ void UGame::update(const float &dt)
             mCurrState = GameState::WHEEL_PLAYING;
             mHamster.setState(static_cast<int>(GameState::WHEEL_PLAYING));
             mStepCount = 0;
+            memset(mRunSplits, 0, sizeof(mRunSplits));
+            mRunTime = 0.f;
+            mRunStartCounter = SDL_GetPerformanceCounter();
             mSounds.playWheelMusic();
         }
         break;
@@ -415,6 +551,7 @@ void UGame::update(const float &dt)
     case GameState::WHEEL_PLAYING:
         mFonts.update(dt);
         mHamster.update(dt);
+        mRunTime += dt;
         
         // If the hamster is not currently playing change the state to the end state
         if (!mFonts.checkCurrentlyPlaying())
@@ -422,7 +559,13 @@ void UGame::update(const float &dt)
             mFonts.setLoopCount(mStepCount / 5);
 
             // Update the Steam stats
-            m_pStatsAndAchievements->addLoops(mStepCount / 5);
+            if (m_pStatsAndAchievements)
+            {
+                m_pStatsAndAchievements->addLoops(mStepCount / 5);
+
+                // The run is over, send its stats without waiting for the store window
+                m_pStatsAndAchievements->flushStats();
+            }
 
             // Enter new high score state
             if (mFonts.getHighscore() < static_cast<unsigned>(mStepCount / 5))
@@ -442,7 +585,10 @@ void UGame::update(const float &dt)
             }
 
             // Update the Steam leaderboards (fastest run, and longest distance)
-            m_pLeaderboards->UpdateLeaderboards(m_pStatsAndAchievements);
+            if (m_pLeaderboards)
+            {
+                m_pLeaderboards->UpdateLeaderboards(m_pStatsAndAchievements, mRunSplits, RUN_SPLIT_COUNT);
+            }
         }
         break;
 
@@ -482,14 +628,24 @@ void UGame::update(const float &dt)
         {
             mSounds.toggleMusicMute();
         }
+        break;
 
     // Update the leaderboard
     case GameState::LEADERBOARD_MENU:
-        m_pLeaderboards->update();
+        if (m_pLeaderboards)
+        {
+            m_pLeaderboards->update();
+        }
+        break;
 
     default:
         break;
     }
+
+    if (mCurrState != startState)
+    {
+        UFlightRecorder::recordState(static_cast<int>(startState), static_cast<int>(mCurrState));
+    }
 }
 
 // Handle all the events on the queue
@@ -497,6 +653,17 @@ bool UGame::handleEvent(SDL_Event &e)
 {
     if (e.type == SDL_QUIT) { return true; }
 
+    // F3 shows or hides the stats overlay, it doesn't count as a step
+    if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F3)
+    {
+        if (e.key.repeat == 0)
+        {
+            mShowStats = !mShowStats;
+            mNextStatsTicks = SDL_GetTicks();
+        }
+        return false;
+    }
+
     if (mCurrState != GameState::SETTINGS_MENU && mCurrState != GameState::LEADERBOARD_MENU)
     {
         mHamster.handleEvent(e);
@@ -510,9 +677,7 @@ bool UGame::handleEvent(SDL_Event &e)
         if (e.type == SDL_KEYDOWN && e.key.repeat == 0)
         {
             // Rotate the wheel of the hamster
-            mDegree += 72;
-            ++mStepCount;
-            mHamster.addDustBall();
+            stepWheel(mRunTime);
         }
     }
     else if (mCurrState == GameState::NEW_HIGHSCORE)
@@ -600,6 +765,7 @@ void UGame::render()
     case GameState::WHEEL_STOPPED:
         mBackgroundTexture.render(0, 0);
         mWheelTexture.render(728, 117);
+        renderOpponentWheel();
         mHouseForegroundTexture.render(210, 352);
         mHamster.render();
         mFonts.renderSleepZs();
@@ -611,6 +777,7 @@ void UGame::render()
     case GameState::WHEEL_PLAY_STARTING:
         mBackgroundTexture.render(0, 0);
         mWheelTexture.render(728, 117);
+        renderOpponentWheel();
         mHouseForegroundTexture.render(210, 352);
         mHamster.render();
         mFonts.renderSleepZs();
@@ -623,6 +790,7 @@ void UGame::render()
     case GameState::WHEEL_PLAYING:
         mBackgroundTexture.render(0, 0);
         mWheelTexture.render(728, 117, nullptr, mDegree);
+        renderOpponentWheel();
         mHouseForegroundTexture.render(210, 352);
         mHamster.render();
         mFonts.renderSleepZs();
@@ -636,6 +804,7 @@ void UGame::render()
     case GameState::GAME_ENDED:
         mBackgroundTexture.render(0, 0);
         mWheelTexture.render(728, 117, nullptr, mDegree);
+        renderOpponentWheel();
         mHouseForegroundTexture.render(210, 352);
         mHamster.render();
         mFonts.renderSleepZs();
@@ -649,6 +818,7 @@ void UGame::render()
     case GameState::NEW_HIGHSCORE:
         mBackgroundTexture.render(0, 0);
         mWheelTexture.render(728, 117, nullptr, mDegree);
+        renderOpponentWheel();
         mHouseForegroundTexture.render(210, 352);
         mHamster.render();
         mFonts.renderSleepZs();
@@ -659,6 +829,12 @@ void UGame::render()
         break;
     }
 
+    // Show who we're racing on the screens with the wheel
+    if (m_pRace && gameState >= GameState::WHEEL_STOPPED && gameState <= GameState::NEW_HIGHSCORE)
+    {
+        m_pRace->render();
+    }
+
     // Render the settings menu
     if (mCurrState == GameState::SETTINGS_MENU)
     {
@@ -683,44 +859,49 @@ void UGame::render()
         mSettingsButton.render(0);
         mLeaderboardButton.render(0);
     }
+
+    if (mShowStats)
+    {
+        renderStats();
+    }
 }
 
 // Free the game objects
 void UGame::close()
 {
-    // Open data for writing
-    SDL_RWops *file = SDL_RWFromFile("assets/save.bin", "w+b");
-    if (file != nullptr)
+    // Save the game, headless runs never overwrite the player's save
+    if (!mHeadless)
     {
-        // Initialize the sData array to contain the default value
-        unsigned int sData[SAVED_DATA_COUNT] = {};
-
-        // Get the current high score
-        sData[HI_SCORE_DATA] = mFonts.getHighscore();
-
-        // Get the high score username
-        std::string usrnme = mFonts.getHighscoreUsername();
-        sData[USERNAME_CHAR_1] = static_cast<unsigned int>(usrnme[0]);
-        sData[USERNAME_CHAR_2] = static_cast<unsigned int>(usrnme[1]);
-        sData[USERNAME_CHAR_3] = static_cast<unsigned int>(usrnme[2]);
-
-        // Get the mute status of the SFX and the Music
-        sData[SFX_MUTED]       = mSounds.isSFXMuted();
-        sData[MUSIC_MUTED]     = mSounds.isMusicMuted();
+        writeSave(SAVE_PATH);
+    }
 
-        // Save the current window size, and the current high score
-        for (int i = 0; i < SAVED_DATA_COUNT; ++i)
-        {
-            SDL_RWwrite(file, &sData[i], sizeof(unsigned int), 1);
-        }
+    // Hand the last save to Steam Cloud without waiting for it to upload
+    if (m_pCloudSave)
+    {
+        unsigned int sData[SAVED_DATA_COUNT] = {};
+        fillSaveData(sData);
+        m_pCloudSave->Upload(sData, sizeof(sData));
+        m_pCloudSave->Flush();
+        m_pCloudSave->free();
+    }
+    delete m_pCloudSave;
+    m_pCloudSave = nullptr;
 
-        // Close file handler
-        SDL_RWclose(file);
+    // Leave the race, the opponent sees the connection close
+    if (m_pRace)
+    {
+        m_pRace->free();
     }
-    else
+    delete m_pRace;
+    m_pRace = nullptr;
+
+    // Stop reading the controllers
+    if (m_pInput)
     {
-        // printf("Error: Unable to save file! %s\n", SDL_GetError());
+        m_pInput->free();
     }
+    delete m_pInput;
+    m_pInput = nullptr;
 
     if (mRenderer)
     {
@@ -740,7 +921,16 @@ void UGame::close()
     mGlassCageTexture.free();
     mTitleTexture.free();
 
-    // Free the member variables
+    // Free the stats overlay
+    mStatsTexture.free();
+    if (mStatsFont)
+    {
+        TTF_CloseFont(mStatsFont);
+        mStatsFont = nullptr;
+    }
+
+    // Free the member variables, the sounds first so the music hook stops using them
+    mSounds.free();
     mHamster.free();
     mFonts.free();
     mSettingsButton.free();
@@ -749,7 +939,207 @@ void UGame::close()
     mPlayAgainButton.free();
 
     // Free the Steam utility classes
-    m_pStatsAndAchievements->free();
+    if (m_pStatsAndAchievements)
+    {
+        m_pStatsAndAchievements->free();
+    }
     delete m_pStatsAndAchievements;
     delete m_pLeaderboards;
+    m_pStatsAndAchievements = nullptr;
+    m_pLeaderboards = nullptr;
+}
+
+// Write the high score and settings to the save file
+bool UGame::writeSave(const char *aPath)
+{
+    bool success = true;
+
+    // Open data for writing
+    SDL_RWops *file = SDL_RWFromFile(aPath, "w+b");
+    if (file != nullptr)
+    {
+        // Initialize the sData array to contain the current values
+        unsigned int sData[SAVED_DATA_COUNT] = {};
+        fillSaveData(sData);
+
+        // Save the current window size, and the current high score
+        for (int i = 0; i < SAVED_DATA_COUNT; ++i)
+        {
+            SDL_RWwrite(file, &sData[i], sizeof(unsigned int), 1);
+        }
+
+        // Close file handler
+        SDL_RWclose(file);
+    }
+    else
+    {
+        ULOG_ERROR(k_ELogSave, "Unable to save file! %s", SDL_GetError());
+        success = false;
+    }
+
+    return success;
+}
+
+// Fill the SAVED_DATA_COUNT values of aData with the high score and settings
+void UGame::fillSaveData(unsigned int *aData)
+{
+    // Get the current high score
+    aData[HI_SCORE_DATA] = mFonts.getHighscore();
+
+    // Get the high score username
+    std::string usrnme = mFonts.getHighscoreUsername();
+    aData[USERNAME_CHAR_1] = static_cast<unsigned int>(usrnme[0]);
+    aData[USERNAME_CHAR_2] = static_cast<unsigned int>(usrnme[1]);
+    aData[USERNAME_CHAR_3] = static_cast<unsigned int>(usrnme[2]);
+
+    // Get the mute status of the SFX and the Music
+    aData[SFX_MUTED]       = mSounds.isSFXMuted();
+    aData[MUSIC_MUTED]     = mSounds.isMusicMuted();
+}
+
+// Play the controller presses made since last frame, true if the menu was pressed
+bool UGame::handleControllerInput()
+{
+    if (!m_pInput)
+    {
+        return false;
+    }
+
+    mInputPresses.clear();
+    m_pInput->TakePresses(mInputPresses);
+
+    bool menuPressed = false;
+    for (const STEAM_InputPress_t &press : mInputPresses)
+    {
+        // Two presses in one frame open and close the menu again
+        if (press.m_eAction == k_EInputActionMenu)
+        {
+            menuPressed = !menuPressed;
+            continue;
+        }
+
+        // The hamster only knows keys, so the actions are played as the keys they stand for.
+        // High score names are typed on the keyboard.
+        if (mCurrState == GameState::SETTINGS_MENU || mCurrState == GameState::LEADERBOARD_MENU || mCurrState == GameState::NEW_HIGHSCORE)
+        {
+            continue;
+        }
+
+        SDL_Event e;
+        memset(&e, 0, sizeof(e));
+        e.type = SDL_KEYDOWN;
+        e.key.repeat = 0;
+        switch (press.m_eAction)
+        {
+        case k_EInputActionStep:
+            e.key.keysym.sym = SDLK_SPACE;
+            break;
+        case k_EInputActionTurn:
+            e.key.keysym.sym = mHamster.directionForward() ? SDLK_LEFT : SDLK_RIGHT;
+            break;
+        default:
+            e.key.keysym.sym = mCurrState == GameState::WHEEL_STOPPED ? SDLK_DOWN : SDLK_UP;
+            break;
+        }
+        mHamster.handleEvent(e);
+
+        // Every press in the batch is a step, split by when it was made. Presses from before
+        // the run started don't count.
+        if (mCurrState == GameState::WHEEL_PLAYING && press.m_eAction == k_EInputActionStep)
+        {
+            Sint64 ticksIntoRun = static_cast<Sint64>(press.m_ulTimestamp - mRunStartCounter);
+            if (ticksIntoRun >= 0)
+            {
+                stepWheel(static_cast<float>(ticksIntoRun) / static_cast<float>(SDL_GetPerformanceFrequency()));
+            }
+        }
+    }
+
+    return menuPressed;
+}
+
+// Turn the wheel one step, aRunTime is how far into the run the step was made
+void UGame::stepWheel(float aRunTime)
+{
+    mDegree += 72;
+    ++mStepCount;
+    ++mRunSplits[MIN(static_cast<int>(aRunTime), RUN_SPLIT_COUNT - 1)];
+    mHamster.addDustBall();
+}
+
+// Draw the stats overlay in the top left corner
+void UGame::renderStats()
+{
+    if (!mStatsFont)
+        return;
+
+    // Only rendered again every STATS_REFRESH_MS, the numbers change too often to read anyway
+    if (static_cast<Sint32>(SDL_GetTicks() - mNextStatsTicks) >= 0)
+    {
+        AudioStats_t audio = UAudio::getStats();
+        char text[160];
+        snprintf(text, sizeof(text), "Audio %d frames at %d Hz, latency %.1f ms (max %.1f), underruns %u, fallbacks %u",
+            audio.mBufferFrames, audio.mFrequency, audio.mLatencyMs, audio.mMaxLatencyMs, audio.mUnderruns, audio.mFallbacks);
+        mStatsTexture.loadFromRenderedText(text, BLACK_TEXT);
+        mNextStatsTicks = SDL_GetTicks() + STATS_REFRESH_MS;
+    }
+
+    mStatsTexture.render(8, 8);
+}
+
+// Draw the opponent's wheel over ours when racing
+void UGame::renderOpponentWheel()
+{
+    if (!m_pRace || !m_pRace->IsOpponentConnected())
+    {
+        return;
+    }
+
+    mWheelTexture.setAlpha(96);
+    mWheelTexture.render(728, 117, nullptr, m_pRace->GetOpponentDegree());
+    mWheelTexture.setAlpha(255);
+}
+
+// Merge the cloud save once it arrives and upload the save whenever it changes
+void UGame::syncCloudSave()
+{
+    // Wait until a new high score has its username
+    if (!m_pCloudSave || mCurrState == GameState::NEW_HIGHSCORE)
+    {
+        return;
+    }
+
+    std::vector<uint8> cloudData;
+    if (m_pCloudSave->TakeDownload(cloudData))
+    {
+        mergeCloudSave(cloudData);
+    }
+
+    unsigned int sData[SAVED_DATA_COUNT] = {};
+    fillSaveData(sData);
+    m_pCloudSave->Upload(sData, sizeof(sData));
+}
+
+// Take the cloud save's high score if it beats ours, the settings stay local
+void UGame::mergeCloudSave(const std::vector<uint8> &aCloudData)
+{
+    unsigned int cData[SAVED_DATA_COUNT] = {};
+    if (aCloudData.size() != sizeof(cData))
+    {
+        ULOG_WARN(k_ELogSave, "Ignoring the cloud save, it is %u bytes", static_cast<unsigned>(aCloudData.size()));
+        return;
+    }
+    memcpy(cData, aCloudData.data(), sizeof(cData));
+
+    if (cData[HI_SCORE_DATA] > mFonts.getHighscore())
+    {
+        ULOG_INFO(k_ELogSave, "Cloud save high score %u beats the local %u", cData[HI_SCORE_DATA], mFonts.getHighscore());
+
+        std::string usrnme;
+        usrnme += static_cast<char>(cData[USERNAME_CHAR_1]);
+        usrnme += static_cast<char>(cData[USERNAME_CHAR_2]);
+        usrnme += static_cast<char>(cData[USERNAME_CHAR_3]);
+        mFonts.setHighscore(cData[HI_SCORE_DATA]);
+        mFonts.setHighscoreUsername(usrnme);
+    }
 }
\ No newline at end of file
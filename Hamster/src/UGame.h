@@ -10,11 +10,16 @@
 #include "GButton.h"
 #include "UFont.h"
 #include "ULib.h"
+#include "UAudio.h"
 #include "USound.h"
 #include "UTexture.h"
 #include "UWindow.h"
 #include "STEAM_StatsAchievements.h"
 #include "STEAM_Leaderboards.h"
+#include "STEAM_CloudSave.h"
+#include "STEAM_Input.h"
+#include "STEAM_Race.h"
+#include "STEAM_Pump.h"
 
 class UGame
 {
@@ -37,8 +42,10 @@ public:
     // Initializes internals
     UGame();
 
-    // Initialize the game objects
-    bool init(SDL_Renderer *, UWindow *);
+    // Initialize the game objects, a headless game doesn't touch the save file so benchmark
+    // runs are repeatable. The Steam objects are only created when SteamBackend() is running,
+    // and a race is only started when aRaceConfig is given
+    bool init(SDL_Renderer *, UWindow *, bool aHeadless = false, const STEAM_RaceConfig_t *aRaceConfig = nullptr);
 
     // Updates the game world
     void update(const float &);
@@ -52,7 +59,37 @@ public:
     // Free the resources
     void close();
 
+    // Current state of the game
+    GameState getState() const { return mCurrState; }
+
+    // Read the save file, a missing save file is created with default values
+    bool readSave(const char *aPath);
+
+    // Write the high score and settings to the save file
+    bool writeSave(const char *aPath);
+
 private:
+    // Fill the SAVED_DATA_COUNT values of aData with the high score and settings
+    void fillSaveData(unsigned int *aData);
+
+    // Merge the cloud save once it arrives and upload the save whenever it changes
+    void syncCloudSave();
+
+    // Take the cloud save's high score if it beats ours, the settings stay local
+    void mergeCloudSave(const std::vector<uint8> &aCloudData);
+
+    // Draw the opponent's wheel over ours when racing
+    void renderOpponentWheel();
+
+    // Play the controller presses made since last frame, true if the menu was pressed
+    bool handleControllerInput();
+
+    // Turn the wheel one step, aRunTime is how far into the run the step was made
+    void stepWheel(float aRunTime);
+
+    // Draw the stats overlay in the top left corner
+    void renderStats();
+
     // This is the fade time of the Hamster title
     const static float FADE_TIME;
 
@@ -62,6 +99,10 @@ private:
     const static UVector3 SOUND_BTN_DIMENSION;
     const static UVector3 PLAY_AGAIN_BTN_DIMENSION, PLAY_AGAIN_BTN_POSITION;
 
+    // Location of the save file, and its name in Steam Cloud
+    const static char *const SAVE_PATH;
+    const static char *const CLOUD_SAVE_NAME;
+
     // Information used to make saving data easier
     const static int SAVED_DATA_COUNT = 6;
     const static int HI_SCORE_DATA    = 0;
@@ -102,7 +143,33 @@ private:
     // Number of steps the hamster has made this playthrough
     int mStepCount;
 
+    // Keystrokes made in each second of this playthrough, one split per second of UFont's
+    // PLAY_TIME_SECONDS, and the time played so far
+    const static int RUN_SPLIT_COUNT = 34;
+    int32 mRunSplits[RUN_SPLIT_COUNT];
+    float mRunTime;
+
+    // SDL_GetPerformanceCounter() when the run started, controller steps are split by when
+    // they were pressed rather than when the frame got to them
+    Uint64 mRunStartCounter;
+
+    // Controller presses taken this frame
+    std::vector<STEAM_InputPress_t> mInputPresses;
+
+    // True when running without a window or a save file
+    bool mHeadless;
+
+    // Stats overlay, toggled with F3 and drawn again every STATS_REFRESH_MS
+    const static Uint32 STATS_REFRESH_MS = 500;
+    bool mShowStats;
+    TTF_Font *mStatsFont;
+    UTexture mStatsTexture;
+    Uint32 mNextStatsTicks;
+
     // Steam utility objects
     STEAM_StatsAchievements* m_pStatsAndAchievements;
     STEAM_Leaderboards* m_pLeaderboards;
+    STEAM_CloudSave* m_pCloudSave;
+    STEAM_Race* m_pRace;
+    STEAM_Input* m_pInput;
 };
\ No newline at end of file
@@ -14,6 +14,9 @@
 #include <SDL_mixer.h>
 #include <SDL_ttf.h>
 #include <string>
+#include "UFlightRecorder.h"
+#include "ULog.h"
+#include "UStartupProfiler.h"
 #include "UVector3.h"
 #include <vector>
 
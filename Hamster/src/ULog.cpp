@@ -0,0 +1,433 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster ULog.cpp
+*/
+#include "ULog.h"
+#include "ULib.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+// Number of ring buffer slots, must be a power of two
+#define LOG_CAPACITY 1024
+
+// Size the log file may reach before it's rotated, and the number of old files kept
+#define LOG_ROTATE_BYTES (1024 * 1024)
+#define LOG_ROTATE_COUNT 3
+
+// How long the writer sleeps when there is nothing to write
+#define LOG_IDLE_MS 10
+
+namespace
+{
+    const char *const LEVEL_NAMES[] = { "TRACE", "DEBUG", "INFO ", "WARN ", "ERROR" };
+    const char *const CATEGORY_NAMES[] = { "game", "render", "audio", "steam", "save" };
+
+    // The ring buffer, producers claim slots with gTail and the writer consumes from gHead
+    ULogRecord gRecords[LOG_CAPACITY];
+    std::atomic<Uint32> gTail(0);
+    Uint32 gHead = 0;
+
+    // Messages lost because the buffer was full
+    std::atomic<Uint32> gDropped(0);
+
+    // Writer thread state
+    std::thread gWriter;
+    std::atomic<bool> gRunning(false);
+    std::string gPath;
+    SDL_RWops *gFile = nullptr;
+    Sint64 gFileBytes = 0;
+    Uint64 gStartTicks = 0;
+    Uint64 gTicksPerSecond = 1;
+
+    // Path of the n'th rotated log file, "hamster.log" becomes "hamster.1.log"
+    std::string rotatedPath(int n)
+    {
+        std::string::size_type dot = gPath.find_last_of('.');
+        if (dot == std::string::npos)
+        {
+            return gPath + "." + std::to_string(n);
+        }
+        return gPath.substr(0, dot) + "." + std::to_string(n) + gPath.substr(dot);
+    }
+
+    // Open the log file for appending
+    bool openFile()
+    {
+        gFile = SDL_RWFromFile(gPath.c_str(), "ab");
+        gFileBytes = gFile ? SDL_RWsize(gFile) : 0;
+        return gFile != nullptr;
+    }
+
+    // Shift the old log files up by one and start a new file
+    void rotate()
+    {
+        if (gFile)
+        {
+            SDL_RWclose(gFile);
+            gFile = nullptr;
+        }
+
+        std::remove(rotatedPath(LOG_ROTATE_COUNT).c_str());
+        for (int i = LOG_ROTATE_COUNT - 1; i > 0; --i)
+        {
+            std::rename(rotatedPath(i).c_str(), rotatedPath(i + 1).c_str());
+        }
+        std::rename(gPath.c_str(), rotatedPath(1).c_str());
+
+        openFile();
+    }
+
+    // Append a formatted line to the log file
+    void writeLine(const char *aLine, size_t aLength)
+    {
+        if (!gFile)
+            return;
+
+        if (gFileBytes + static_cast<Sint64>(aLength) > LOG_ROTATE_BYTES)
+        {
+            rotate();
+            if (!gFile)
+                return;
+        }
+
+        SDL_RWwrite(gFile, aLine, 1, aLength);
+        gFileBytes += aLength;
+    }
+
+    // Format a single conversion specifier with the captured argument
+    int formatArg(char *aOut, size_t aSize, const char *aSpec, size_t aSpecLen, char aConv, const ULogArg *aArg, const char *aStrings)
+    {
+        // Rebuild the spec without any length modifier, then add the one matching the captured type
+        char spec[32];
+        size_t n = 0;
+        for (size_t i = 0; i < aSpecLen - 1 && n < sizeof(spec) - 4; ++i)
+        {
+            char c = aSpec[i];
+            if (c != 'l' && c != 'h' && c != 'z' && c != 'j' && c != 't' && c != 'L' && c != 'I')
+            {
+                spec[n++] = c;
+            }
+        }
+
+        if (!aArg)
+        {
+            return snprintf(aOut, aSize, "<missing>");
+        }
+
+        switch (aConv)
+        {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+            spec[n++] = 'l';
+            spec[n++] = 'l';
+            spec[n++] = aConv;
+            spec[n] = '\0';
+            if (aArg->mType == ULogArg::k_EDouble)
+                return snprintf(aOut, aSize, spec, static_cast<long long>(aArg->mDouble));
+            return snprintf(aOut, aSize, spec, aArg->mInt);
+
+        case 'c':
+            spec[n++] = aConv;
+            spec[n] = '\0';
+            return snprintf(aOut, aSize, spec, static_cast<int>(aArg->mInt));
+
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            spec[n++] = aConv;
+            spec[n] = '\0';
+            if (aArg->mType == ULogArg::k_EDouble)
+                return snprintf(aOut, aSize, spec, aArg->mDouble);
+            return snprintf(aOut, aSize, spec, static_cast<double>(aArg->mInt));
+
+        case 's':
+            spec[n++] = aConv;
+            spec[n] = '\0';
+            if (aArg->mType == ULogArg::k_EString)
+                return snprintf(aOut, aSize, spec, aStrings + aArg->mStrOffset);
+            return snprintf(aOut, aSize, spec, "<non-string>");
+
+        case 'p':
+            return snprintf(aOut, aSize, "0x%llx", aArg->mUInt);
+
+        default:
+            return 0;
+        }
+    }
+
+    // Expand a record into a single line of text
+    size_t formatRecord(const ULogRecord &aRecord, char *aOut, size_t aSize)
+    {
+        double seconds = static_cast<double>(aRecord.mTicks - gStartTicks) / static_cast<double>(gTicksPerSecond);
+        int len = snprintf(aOut, aSize, "[%10.3f] %s %-6s ", seconds, LEVEL_NAMES[aRecord.mLevel], CATEGORY_NAMES[aRecord.mCategory]);
+        size_t pos = len > 0 ? static_cast<size_t>(len) : 0;
+        int argIndex = 0;
+
+        for (const char *c = aRecord.mFormat; *c && pos < aSize - 2; ++c)
+        {
+            if (*c != '%')
+            {
+                // Trailing newlines are dropped, every record is written as exactly one line
+                if (!(*c == '\n' && c[1] == '\0'))
+                {
+                    aOut[pos++] = *c;
+                }
+                continue;
+            }
+
+            if (c[1] == '%')
+            {
+                aOut[pos++] = '%';
+                ++c;
+                continue;
+            }
+
+            // Find the conversion character
+            const char *spec = c;
+            const char *end = c + 1;
+            while (*end && !strchr("diouxXeEfFgGaAcsp", *end))
+            {
+                ++end;
+            }
+            if (!*end)
+                break;
+
+            const ULogArg *arg = argIndex < aRecord.mArgCount ? &aRecord.mArgs[argIndex] : nullptr;
+            ++argIndex;
+
+            int written = formatArg(aOut + pos, aSize - 1 - pos, spec, static_cast<size_t>(end - spec) + 1, *end, arg, aRecord.mStrings);
+            if (written > 0)
+            {
+                pos = MIN(pos + static_cast<size_t>(written), aSize - 2);
+            }
+            c = end;
+        }
+
+        aOut[pos++] = '\n';
+        aOut[pos] = '\0';
+        return pos;
+    }
+
+    // Write every published record, returns the number written
+    int drain()
+    {
+        char line[512];
+        int count = 0;
+
+        Uint32 dropped = gDropped.exchange(0);
+        if (dropped)
+        {
+            int len = snprintf(line, sizeof(line), "[%10s] WARN  log    %u messages dropped, log buffer full\n", "", dropped);
+            writeLine(line, static_cast<size_t>(len));
+        }
+
+        for (;;)
+        {
+            ULogRecord &record = gRecords[gHead & (LOG_CAPACITY - 1)];
+            if (record.mSequence.load(std::memory_order_acquire) != gHead + 1)
+                break;
+
+            size_t len = formatRecord(record, line, sizeof(line));
+            writeLine(line, len);
+
+            // Give the slot back to the producers
+            record.mSequence.store(gHead + LOG_CAPACITY, std::memory_order_release);
+            ++gHead;
+            ++count;
+        }
+
+        return count;
+    }
+
+    // Writer thread loop
+    void writerMain()
+    {
+        while (gRunning.load(std::memory_order_acquire))
+        {
+            if (drain() == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(LOG_IDLE_MS));
+            }
+        }
+
+        // Flush anything written while shutting down
+        drain();
+    }
+}
+
+std::atomic<int> ULog::sMinLevel(k_ELogInfo);
+
+// Start the writer thread and open the log file
+bool ULog::init(const std::string &aPath)
+{
+    if (gRunning)
+        return true;
+
+    for (Uint32 i = 0; i < LOG_CAPACITY; ++i)
+    {
+        gRecords[i].mSequence.store(i, std::memory_order_relaxed);
+    }
+    gTail.store(0);
+    gHead = 0;
+
+    gPath = aPath;
+    gStartTicks = SDL_GetPerformanceCounter();
+    gTicksPerSecond = SDL_GetPerformanceFrequency();
+
+    bool success = openFile();
+
+#ifdef _DEBUG
+    setLevel(k_ELogDebug);
+#endif
+
+    // Messages are queued even without a file, so the writer is always started to drain them
+    gRunning = true;
+    gWriter = std::thread(writerMain);
+
+    return success;
+}
+
+// Drain the queued messages, stop the writer thread and close the log file
+void ULog::free()
+{
+    if (!gRunning)
+        return;
+
+    gRunning = false;
+    if (gWriter.joinable())
+    {
+        gWriter.join();
+    }
+
+    if (gFile)
+    {
+        SDL_RWclose(gFile);
+        gFile = nullptr;
+    }
+}
+
+// Reserve a slot in the ring buffer, returns nullptr if the buffer is full
+ULogRecord *ULog::acquire()
+{
+    Uint32 pos = gTail.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        ULogRecord &record = gRecords[pos & (LOG_CAPACITY - 1)];
+        Uint32 seq = record.mSequence.load(std::memory_order_acquire);
+        Sint32 diff = static_cast<Sint32>(seq - pos);
+
+        // The slot is free, try to claim it
+        if (diff == 0)
+        {
+            if (gTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                record.mTicks = SDL_GetPerformanceCounter();
+                return &record;
+            }
+        }
+
+        // The writer hasn't consumed this slot yet, the buffer is full
+        else if (diff < 0)
+        {
+            gDropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        // Another producer claimed the slot first
+        else
+        {
+            pos = gTail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Hand a filled slot to the writer thread
+void ULog::publish(ULogRecord *aRecord)
+{
+    // The slot's sequence number is still the position it was claimed at, bump it to
+    // mark the slot as ready to read
+    Uint32 seq = aRecord->mSequence.load(std::memory_order_relaxed);
+    aRecord->mSequence.store(seq + 1, std::memory_order_release);
+}
+
+// Next free argument in the record, nullptr once the record is full
+ULogArg *ULog::nextArg(ULogRecord &r)
+{
+    return r.mArgCount < ULogRecord::MAX_ARGS ? &r.mArgs[r.mArgCount++] : nullptr;
+}
+
+// Strings are copied into the record, the caller's buffer may be gone by the time it's formatted
+void ULog::pack(ULogRecord &r, const char *v)
+{
+    ULogArg *arg = nextArg(r);
+    if (!arg)
+        return;
+
+    if (!v)
+    {
+        v = "(null)";
+    }
+
+    arg->mType = ULogArg::k_EString;
+    arg->mStrOffset = r.mStringLen;
+
+    size_t room = ULogRecord::STRING_BYTES - r.mStringLen;
+    if (room == 0)
+    {
+        // Out of string space, point at the terminator of the previous string
+        arg->mStrOffset = static_cast<unsigned short>(r.mStringLen - 1);
+        return;
+    }
+
+    size_t len = MIN(strlen(v), room - 1);
+    memcpy(r.mStrings + r.mStringLen, v, len);
+    r.mStrings[r.mStringLen + len] = '\0';
+    r.mStringLen = static_cast<unsigned short>(r.mStringLen + len + 1);
+}
+
+void ULog::pack(ULogRecord &r, const std::string &v) { pack(r, v.c_str()); }
+
+void ULog::pack(ULogRecord &r, const void *v)
+{
+    if (ULogArg *arg = nextArg(r))
+    {
+        arg->mType = ULogArg::k_EPointer;
+        arg->mUInt = reinterpret_cast<unsigned long long>(v);
+    }
+}
+
+void ULog::pack(ULogRecord &r, bool v) { pack(r, static_cast<long long>(v)); }
+void ULog::pack(ULogRecord &r, char v) { pack(r, static_cast<long long>(v)); }
+void ULog::pack(ULogRecord &r, int v) { pack(r, static_cast<long long>(v)); }
+void ULog::pack(ULogRecord &r, unsigned int v) { pack(r, static_cast<unsigned long long>(v)); }
+void ULog::pack(ULogRecord &r, long v) { pack(r, static_cast<long long>(v)); }
+void ULog::pack(ULogRecord &r, unsigned long v) { pack(r, static_cast<unsigned long long>(v)); }
+
+void ULog::pack(ULogRecord &r, long long v)
+{
+    if (ULogArg *arg = nextArg(r))
+    {
+        arg->mType = ULogArg::k_EInt;
+        arg->mInt = v;
+    }
+}
+
+void ULog::pack(ULogRecord &r, unsigned long long v)
+{
+    if (ULogArg *arg = nextArg(r))
+    {
+        arg->mType = ULogArg::k_EUInt;
+        arg->mUInt = v;
+    }
+}
+
+void ULog::pack(ULogRecord &r, double v)
+{
+    if (ULogArg *arg = nextArg(r))
+    {
+        arg->mType = ULogArg::k_EDouble;
+        arg->mDouble = v;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster ULog.h
+*/
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <string>
+#include <type_traits>
+
+// Log message severity
+enum ELogLevel
+{
+    k_ELogTrace   = 0,
+    k_ELogDebug   = 1,
+    k_ELogInfo    = 2,
+    k_ELogWarning = 3,
+    k_ELogError   = 4
+};
+
+// Subsystem a log message came from
+enum ELogCategory
+{
+    k_ELogGame   = 0,
+    k_ELogRender = 1,
+    k_ELogAudio  = 2,
+    k_ELogSteam  = 3,
+    k_ELogSave   = 4
+};
+
+// Log a message, the format string must be a string literal since only the pointer is queued
+#define ULOG_TRACE(cat, ...) ULog::write(k_ELogTrace, cat, __VA_ARGS__)
+#define ULOG_DEBUG(cat, ...) ULog::write(k_ELogDebug, cat, __VA_ARGS__)
+#define ULOG_INFO(cat, ...)  ULog::write(k_ELogInfo, cat, __VA_ARGS__)
+#define ULOG_WARN(cat, ...)  ULog::write(k_ELogWarning, cat, __VA_ARGS__)
+#define ULOG_ERROR(cat, ...) ULog::write(k_ELogError, cat, __VA_ARGS__)
+
+// A single captured printf argument
+struct ULogArg
+{
+    enum EType : Uint8 { k_EInt, k_EUInt, k_EDouble, k_EString, k_EPointer };
+
+    EType mType;
+    union
+    {
+        long long mInt;
+        unsigned long long mUInt;
+        double mDouble;
+        unsigned short mStrOffset;
+    };
+};
+
+// One slot of the log ring buffer. The message is not formatted at the call site, the
+// arguments are captured and the writer thread does the formatting.
+struct ULogRecord
+{
+    static const int MAX_ARGS = 6;
+    static const int STRING_BYTES = 176;
+
+    // Ring buffer sequence number, used to hand the slot between producers and the writer
+    std::atomic<Uint32> mSequence;
+
+    Uint64 mTicks;
+    const char *mFormat;
+    Uint8 mLevel, mCategory, mArgCount;
+    unsigned short mStringLen;
+    ULogArg mArgs[MAX_ARGS];
+    char mStrings[STRING_BYTES];
+};
+
+// Asynchronous logger. Any thread may write, a background thread formats the messages
+// and appends them to a rotating log file.
+class ULog
+{
+public:
+    // Start the writer thread and open the log file
+    static bool init(const std::string &aPath);
+
+    // Drain the queued messages, stop the writer thread and close the log file
+    static void free();
+
+    // Messages below this level are discarded at the call site
+    static void setLevel(ELogLevel aLevel) { sMinLevel = aLevel; }
+
+    // Queue a message, costs one lock-free ring buffer push
+    template<typename... Args>
+    static void write(ELogLevel aLevel, ELogCategory aCategory, const char *aFormat, Args... args)
+    {
+        if (aLevel < sMinLevel)
+            return;
+
+        ULogRecord *record = acquire();
+        if (!record)
+            return;
+
+        record->mLevel = static_cast<Uint8>(aLevel);
+        record->mCategory = static_cast<Uint8>(aCategory);
+        record->mFormat = aFormat;
+        record->mArgCount = 0;
+        record->mStringLen = 0;
+        int expand[] = { 0, (pack(*record, args), 0)... };
+        (void)expand;
+
+        publish(record);
+    }
+
+private:
+    // Reserve a slot in the ring buffer, returns nullptr if the buffer is full
+    static ULogRecord *acquire();
+
+    // Hand a filled slot to the writer thread
+    static void publish(ULogRecord *);
+
+    // Argument capture
+    static ULogArg *nextArg(ULogRecord &);
+    static void pack(ULogRecord &, const char *);
+    static void pack(ULogRecord &, const std::string &);
+    static void pack(ULogRecord &, const void *);
+    static void pack(ULogRecord &, bool);
+    static void pack(ULogRecord &, char);
+    static void pack(ULogRecord &, int);
+    static void pack(ULogRecord &, unsigned int);
+    static void pack(ULogRecord &, long);
+    static void pack(ULogRecord &, unsigned long);
+    static void pack(ULogRecord &, long long);
+    static void pack(ULogRecord &, unsigned long long);
+    static void pack(ULogRecord &, double);
+
+    template<typename T>
+    static typename std::enable_if<std::is_enum<T>::value>::type pack(ULogRecord &r, T v)
+    {
+        pack(r, static_cast<long long>(v));
+    }
+
+    static std::atomic<int> sMinLevel;
+};
\ No newline at end of file
@@ -0,0 +1,461 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UMicrobench.cpp
+*/
+#include "UMicrobench.h"
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+// Each benchmark runs for at least this long
+#define MICROBENCH_DEFAULT_MIN_TIME 0.5
+
+// Upper bound on the iterations of a single run
+#define MICROBENCH_MAX_ITERATIONS 1000000000ull
+
+// Frame time used by the update benchmarks
+#define MICROBENCH_DT (1.0f / 60.0f)
+
+// Scratch save file used by the save benchmarks
+#define MICROBENCH_SAVE_PATH "microbench_save.bin"
+
+namespace
+{
+    // A registered benchmark
+    struct MicrobenchEntry
+    {
+        std::string mName;
+        UMicrobench::Function mFunction;
+        int mArg;
+    };
+
+    // Result of the final run of a benchmark
+    struct MicrobenchResult
+    {
+        std::string mName;
+        Uint64 mIterations;
+        double mNsPerIteration;
+        double mItemsPerSecond;
+        double mAllocationsPerIteration;
+    };
+
+    std::vector<MicrobenchEntry> gEntries;
+
+    // Command line options
+    std::string gFilter;
+    std::string gOutPath;
+    double gMinTime = MICROBENCH_DEFAULT_MIN_TIME;
+
+    // Objects shared by the benchmarks
+    SDL_Renderer *gRenderer = nullptr;
+    UGame *gGame = nullptr;
+    USound gSounds;
+
+    // Append formatted text to a string
+    template<typename... Args>
+    void appendf(std::string &aOut, const char *aFormat, Args... args)
+    {
+        char line[512];
+        int len = snprintf(line, sizeof(line), aFormat, args...);
+        if (len > 0)
+            aOut.append(line, SDL_min(static_cast<size_t>(len), sizeof(line) - 1));
+    }
+
+    // UTexture::loadFromFile for one of the game's images
+    void benchLoadFromFile(UMicrobenchState &state, const char *aPath)
+    {
+        UTexture texture;
+        texture.initUTexture(gRenderer);
+        while (state.keepRunning())
+        {
+            texture.loadFromFile(aPath);
+        }
+        texture.free();
+    }
+
+    // UTexture::loadFromRenderedText at the font size given by the argument
+    void benchLoadFromRenderedText(UMicrobenchState &state)
+    {
+        TTF_Font *font = TTF_OpenFont("assets/font.ttf", state.arg());
+        UTexture texture;
+        texture.initUTexture(gRenderer);
+        texture.initFont(font);
+
+        const char *const TEXT[] = { "3", "Go!", "0:34", "ABC" };
+        int i = 0;
+        while (state.keepRunning())
+        {
+            texture.loadFromRenderedText(TEXT[i++ & 3], BLACK_TEXT);
+        }
+
+        texture.free();
+        TTF_CloseFont(font);
+    }
+
+    // DustBall::update over as many dust balls as the argument
+    void benchDustBallUpdate(UMicrobenchState &state)
+    {
+        std::vector<std::unique_ptr<DustBall>> dustBalls;
+        for (int i = 0; i < state.arg(); ++i)
+        {
+            dustBalls.emplace_back(new DustBall());
+            dustBalls.back()->init(gRenderer, UVector3{ 600.f, 400.f, 0.f });
+        }
+
+        while (state.keepRunning())
+        {
+            for (std::unique_ptr<DustBall> &dustBall : dustBalls)
+            {
+                dustBall->update(MICROBENCH_DT);
+            }
+
+            // They all die together, bring them back without timing the texture loads
+            if (!dustBalls.front()->live)
+            {
+                state.pauseTiming();
+                for (std::unique_ptr<DustBall> &dustBall : dustBalls)
+                {
+                    dustBall->free();
+                    dustBall->init(gRenderer, UVector3{ 600.f, 400.f, 0.f });
+                }
+                state.resumeTiming();
+            }
+        }
+
+        for (std::unique_ptr<DustBall> &dustBall : dustBalls)
+        {
+            dustBall->free();
+        }
+        state.setItemsPerIteration(state.arg());
+    }
+
+    // SleepZ::update over as many sleep z's as the argument
+    void benchSleepZUpdate(UMicrobenchState &state)
+    {
+        TTF_Font *font = TTF_OpenFont("assets/font.ttf", 18);
+        std::vector<std::unique_ptr<SleepZ>> sleepZs;
+        for (int i = 0; i < state.arg(); ++i)
+        {
+            sleepZs.emplace_back(new SleepZ());
+            sleepZs.back()->init(gRenderer, font, "z", UVector3{ 400.f, 400.f, 0.f });
+        }
+
+        while (state.keepRunning())
+        {
+            for (std::unique_ptr<SleepZ> &z : sleepZs)
+            {
+                z->update(MICROBENCH_DT);
+            }
+
+            if (!sleepZs.front()->mLive)
+            {
+                state.pauseTiming();
+                for (std::unique_ptr<SleepZ> &z : sleepZs)
+                {
+                    z->free();
+                    z->init(gRenderer, font, "z", UVector3{ 400.f, 400.f, 0.f });
+                }
+                state.resumeTiming();
+            }
+        }
+
+        for (std::unique_ptr<SleepZ> &z : sleepZs)
+        {
+            z->free();
+        }
+        TTF_CloseFont(font);
+        state.setItemsPerIteration(state.arg());
+    }
+
+    // GHamster::update with as many dust balls as the argument
+    void benchHamsterUpdate(UMicrobenchState &state)
+    {
+        GHamster hamster;
+        hamster.init(gRenderer, "assets/hamster.png", &gSounds);
+        while (hamster.dustBallCount() < state.arg())
+        {
+            hamster.addDustBall();
+        }
+
+        while (state.keepRunning())
+        {
+            hamster.update(MICROBENCH_DT);
+
+            // Top the dust balls back up once the first ones have expired
+            if (hamster.dustBallCount() < state.arg())
+            {
+                state.pauseTiming();
+                while (hamster.dustBallCount() < state.arg())
+                {
+                    hamster.addDustBall();
+                }
+                state.resumeTiming();
+            }
+        }
+
+        hamster.free();
+    }
+
+    // UFont::update during a run, the countdown and game clock are both live
+    void benchFontUpdate(UMicrobenchState &state)
+    {
+        UFont fonts;
+        fonts.init(gRenderer, &gSounds);
+        fonts.startCountdown();
+
+        while (state.keepRunning())
+        {
+            fonts.update(MICROBENCH_DT);
+        }
+
+        fonts.free();
+    }
+
+    // STEAM_LeaderboardMenu::Rebuild with a full page of entries
+    void benchLeaderboardRebuild(UMicrobenchState &state)
+    {
+        STEAM_Leaderboards leaderboards;
+        leaderboards.init(gRenderer);
+
+        while (state.keepRunning())
+        {
+            leaderboards.RebuildWithTestData();
+        }
+    }
+
+    // Save file read
+    void benchSaveRead(UMicrobenchState &state)
+    {
+        gGame->writeSave(MICROBENCH_SAVE_PATH);
+        while (state.keepRunning())
+        {
+            gGame->readSave(MICROBENCH_SAVE_PATH);
+        }
+        remove(MICROBENCH_SAVE_PATH);
+    }
+
+    // Save file write
+    void benchSaveWrite(UMicrobenchState &state)
+    {
+        while (state.keepRunning())
+        {
+            gGame->writeSave(MICROBENCH_SAVE_PATH);
+        }
+        remove(MICROBENCH_SAVE_PATH);
+    }
+
+    // Register the suite
+    void addBenchmarks()
+    {
+        if (!gEntries.empty())
+            return;
+
+        UMicrobench::add("UTexture::loadFromFile/background", [](UMicrobenchState &state) { benchLoadFromFile(state, "assets/background.png"); });
+        UMicrobench::add("UTexture::loadFromFile/hamster", [](UMicrobenchState &state) { benchLoadFromFile(state, "assets/hamster.png"); });
+        UMicrobench::add("UTexture::loadFromFile/dustball", [](UMicrobenchState &state) { benchLoadFromFile(state, "assets/dustball.png"); });
+
+        // Every font size the game uses
+        for (int size : { 18, 92, 450 })
+        {
+            UMicrobench::add("UTexture::loadFromRenderedText", benchLoadFromRenderedText, size);
+        }
+
+        for (int count : { 10, 100, 1000 })
+        {
+            UMicrobench::add("DustBall::update", benchDustBallUpdate, count);
+            UMicrobench::add("SleepZ::update", benchSleepZUpdate, count);
+        }
+
+        for (int count : { 0, 10, 100 })
+        {
+            UMicrobench::add("GHamster::update", benchHamsterUpdate, count);
+        }
+
+        UMicrobench::add("UFont::update", benchFontUpdate);
+        UMicrobench::add("STEAM_LeaderboardMenu::Rebuild", benchLeaderboardRebuild);
+        UMicrobench::add("UGame::readSave", benchSaveRead);
+        UMicrobench::add("UGame::writeSave", benchSaveWrite);
+    }
+}
+
+UMicrobenchState::UMicrobenchState(Uint64 aIterations, int aArg)
+{
+    mIterations = aIterations;
+    mDone = 0;
+    mArg = aArg;
+    mStarted = mRunning = false;
+    mStartTicks = mElapsedTicks = 0;
+    mStartAllocations = mAllocations = 0;
+    mItemsPerIteration = 0;
+}
+
+// True while there are iterations left, the first call starts the clock
+bool UMicrobenchState::keepRunning()
+{
+    if (!mStarted)
+    {
+        mStarted = true;
+        resumeTiming();
+    }
+
+    if (mDone < mIterations)
+    {
+        ++mDone;
+        return true;
+    }
+
+    pauseTiming();
+    return false;
+}
+
+// Stop the clock
+void UMicrobenchState::pauseTiming()
+{
+    if (mRunning)
+    {
+        mElapsedTicks += SDL_GetPerformanceCounter() - mStartTicks;
+        mAllocations += UBench::allocationCount() - mStartAllocations;
+        mRunning = false;
+    }
+}
+
+// Restart the clock
+void UMicrobenchState::resumeTiming()
+{
+    if (!mRunning)
+    {
+        mStartAllocations = UBench::allocationCount();
+        mStartTicks = SDL_GetPerformanceCounter();
+        mRunning = true;
+    }
+}
+
+// Parse the command line, returns true if the microbenchmarks were requested
+bool UMicrobench::parseArgs(int argc, char *args[])
+{
+    if (argc < 2 || strcmp(args[1], "--microbench") != 0)
+        return false;
+
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(args[i], "--filter") == 0)
+        {
+            gFilter = args[i + 1];
+        }
+        else if (strcmp(args[i], "--out") == 0)
+        {
+            gOutPath = args[i + 1];
+        }
+        else if (strcmp(args[i], "--min-time") == 0)
+        {
+            gMinTime = atof(args[i + 1]);
+        }
+    }
+    return true;
+}
+
+// Add a benchmark, the name gets "/<arg>" appended when aArg isn't zero
+void UMicrobench::add(const std::string &aName, Function aFunction, int aArg)
+{
+    MicrobenchEntry entry;
+    entry.mName = aArg ? aName + "/" + std::to_string(aArg) : aName;
+    entry.mFunction = aFunction;
+    entry.mArg = aArg;
+    gEntries.push_back(entry);
+}
+
+// Run the benchmarks that match the filter and write the results, returns the exit code
+int UMicrobench::run(UGame &aGame, SDL_Renderer *aRenderer)
+{
+    gGame = &aGame;
+    gRenderer = aRenderer;
+    if (!gSounds.init())
+    {
+        ULOG_ERROR(k_ELogAudio, "Failed to load sounds for the microbenchmarks!");
+        return 1;
+    }
+    addBenchmarks();
+#ifndef HAMSTER_BENCH
+    ULOG_WARN(k_ELogGame, "Built without HAMSTER_BENCH, allocations aren't counted, use the Bench configuration");
+#endif
+
+    const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+    std::vector<MicrobenchResult> results;
+
+    printf("%-44s %14s %14s %12s\n", "Benchmark", "Time (ns)", "Iterations", "Allocs/iter");
+    for (const MicrobenchEntry &entry : gEntries)
+    {
+        if (!gFilter.empty() && entry.mName.find(gFilter) == std::string::npos)
+            continue;
+
+        // Grow the iteration count until a run takes at least the minimum time
+        Uint64 iterations = 1;
+        for (;;)
+        {
+            UMicrobenchState state(iterations, entry.mArg);
+            entry.mFunction(state);
+
+            double seconds = state.elapsedTicks() / frequency;
+            if (seconds >= gMinTime || iterations >= MICROBENCH_MAX_ITERATIONS)
+            {
+                MicrobenchResult result;
+                result.mName = entry.mName;
+                result.mIterations = iterations;
+                result.mNsPerIteration = seconds * 1e9 / iterations;
+                result.mItemsPerSecond = seconds > 0.0 ? state.itemsPerIteration() * iterations / seconds : 0.0;
+                result.mAllocationsPerIteration = static_cast<double>(state.allocations()) / iterations;
+                results.push_back(result);
+
+                printf("%-44s %14.1f %14llu %12.2f\n", result.mName.c_str(), result.mNsPerIteration, static_cast<unsigned long long>(iterations), result.mAllocationsPerIteration);
+                fflush(stdout);
+                break;
+            }
+
+            // Aim 40% past the minimum time based on this run, growing at most tenfold
+            double scale = seconds > 0.0 ? (gMinTime * 1.4) / seconds : 10.0;
+            iterations = static_cast<Uint64>(iterations * SDL_min(SDL_max(scale, 2.0), 10.0));
+        }
+    }
+
+    gSounds.free();
+
+    // Google Benchmark compatible JSON
+    SDL_RendererInfo info;
+    SDL_zero(info);
+    SDL_GetRendererInfo(aRenderer, &info);
+
+    std::string json = "{\n  \"context\": {\n";
+    appendf(json, "    \"executable\": \"Hamster\",\n");
+    appendf(json, "    \"num_cpus\": %d,\n", SDL_GetCPUCount());
+    appendf(json, "    \"renderer\": \"%s\",\n", info.name ? info.name : "");
+    appendf(json, "    \"min_time\": %.3f\n", gMinTime);
+    json += "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const MicrobenchResult &result = results[i];
+        appendf(json, "%s\n    { \"name\": \"%s\", \"run_type\": \"iteration\", \"iterations\": %llu, \"real_time\": %.3f, \"cpu_time\": %.3f, \"time_unit\": \"ns\", \"allocs_per_iter\": %.3f",
+            i ? "," : "", result.mName.c_str(), static_cast<unsigned long long>(result.mIterations), result.mNsPerIteration, result.mNsPerIteration, result.mAllocationsPerIteration);
+        if (result.mItemsPerSecond > 0.0)
+        {
+            appendf(json, ", \"items_per_second\": %.1f", result.mItemsPerSecond);
+        }
+        json += " }";
+    }
+    json += "\n  ]\n}\n";
+
+    if (gOutPath.empty())
+        return 0;
+
+    SDL_RWops *file = SDL_RWFromFile(gOutPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        ULOG_ERROR(k_ELogGame, "Unable to write %s! SDL Error: %s", gOutPath, SDL_GetError());
+        return 1;
+    }
+    SDL_RWwrite(file, json.data(), 1, json.size());
+    SDL_RWclose(file);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UMicrobench.h
+*/
+#pragma once
+#include "UBench.h"
+#include <functional>
+
+// Timing state handed to a microbenchmark. The body runs the code being measured in a
+// "while (state.keepRunning())" loop, setup and teardown inside the loop go between
+// pauseTiming() and resumeTiming().
+class UMicrobenchState
+{
+public:
+    UMicrobenchState(Uint64 aIterations, int aArg);
+
+    // True while there are iterations left, the first call starts the clock
+    bool keepRunning();
+
+    // Stop and restart the clock around work that shouldn't be measured
+    void pauseTiming();
+    void resumeTiming();
+
+    // Argument the benchmark was registered with
+    int arg() const { return mArg; }
+
+    // Work done per iteration, reported as items per second
+    void setItemsPerIteration(Uint64 aItems) { mItemsPerIteration = aItems; }
+
+    Uint64 iterations() const { return mIterations; }
+    Uint64 elapsedTicks() const { return mElapsedTicks; }
+    Uint64 allocations() const { return mAllocations; }
+    Uint64 itemsPerIteration() const { return mItemsPerIteration; }
+
+private:
+    Uint64 mIterations, mDone;
+    int mArg;
+    bool mStarted, mRunning;
+    Uint64 mStartTicks, mElapsedTicks;
+    Uint64 mStartAllocations, mAllocations;
+    Uint64 mItemsPerIteration;
+};
+
+// Microbenchmark suite for the engine hot paths, "Hamster --microbench [--filter <text>]
+// [--min-time <seconds>] [--out <file>]". Each benchmark is repeated until it has run for
+// the minimum time, and the results are written in the Google Benchmark JSON format so
+// the usual comparison tools work on them. Build the Bench|x64 configuration to run them,
+// the allocations per iteration are only counted there.
+class UMicrobench
+{
+public:
+    typedef std::function<void(UMicrobenchState &)> Function;
+
+    // Parse the command line, returns true if the microbenchmarks were requested
+    static bool parseArgs(int argc, char *args[]);
+
+    // Add a benchmark, the name gets "/<arg>" appended when aArg isn't zero
+    static void add(const std::string &aName, Function aFunction, int aArg = 0);
+
+    // Run the benchmarks that match the filter and write the results, returns the exit code
+    static int run(UGame &aGame, SDL_Renderer *aRenderer);
+};
\ No newline at end of file
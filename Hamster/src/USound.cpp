@@ -6,56 +6,100 @@
 * File: Hamster USound.cpp
 */
 #include "USound.h"
+#include "UAudio.h"
+#include "UFlightRecorder.h"
+#include "ULog.h"
+#include <cstring>
+
+// How long a track change takes to fade from one track to the other
+#define MUSIC_CROSSFADE_MS 250
+
+// Samples the music hook mixes at a time, kept on the audio thread's stack
+#define MUSIC_MIX_SAMPLES 2048
+
+// The music files, in MusicTrack order
+static const char *const MUSIC_PATHS[] = { "assets/wheel_mus.wav", "assets/menu_mus.wav" };
 
 // Initialize USound member variables
-USound::USound() {
-    mWheelMusic = nullptr;
-    mMenuMusic = nullptr;
+USound::USound() : mMusicRequest(0), mMusicPaused(false) {
+    for (int i = 0; i < MUSIC_TRACK_COUNT; ++i) {
+        mMusic[i] = nullptr;
+    }
     mClick = nullptr;
     mClack = nullptr;
     mSoftStep = nullptr;
     mMuteSFX = mMuteMusic = false;
+    mRequestCount = 0;
+    mAppliedRequest = 0;
+    for (int i = 0; i < 2; ++i) {
+        mVoices[i].mTrack = MUSIC_NONE;
+        mVoices[i].mFrame = 0;
+        mVoices[i].mGain = mVoices[i].mGainStep = mVoices[i].mTargetGain = 0.f;
+    }
+    mChannels = 2;
+    mFrequency = 44100;
+    mHooked = false;
 }
 
 // Initialize the USound object
 bool USound::init() {
     bool success = true;
+    Uint64 loadStart;
 
-    // Load the wheel music
-    mWheelMusic = Mix_LoadMUS("assets/wheel_mus.wav");
-    if (mWheelMusic == nullptr) {
-        // printf("Failed to load wheel music! SDL_mixer Error: %s\n", Mix_GetError());
+    // The music hook mixes 16 bit samples, which is what Main opens the mixer with
+    Uint16 format = 0;
+    if (Mix_QuerySpec(&mFrequency, &format, &mChannels) == 0 || format != AUDIO_S16SYS ||
+        mChannels < 1 || mChannels > MUSIC_MIX_SAMPLES) {
+        ULOG_ERROR(k_ELogAudio, "Music needs the mixer open with 16 bit samples! SDL_mixer Error: %s", Mix_GetError());
         success = false;
     }
 
-    // Load the menu music
-    mMenuMusic = Mix_LoadMUS("assets/menu_mus.wav");
-    if (mMenuMusic == nullptr)
-    {
-        // printf("Failed to load menu music! SDL_mixer Error: %s\n", Mix_GetError());
-        success = false;
+    // Load the music, decoded to the mixer's format so the hook can play it straight from memory
+    for (int i = 0; i < MUSIC_TRACK_COUNT; ++i) {
+        loadStart = SDL_GetPerformanceCounter();
+        mMusic[i] = Mix_LoadWAV(MUSIC_PATHS[i]);
+        UFlightRecorder::recordAsset(k_EFlightMusic, MUSIC_PATHS[i], mMusic[i] != nullptr, loadStart);
+        if (mMusic[i] == nullptr) {
+            ULOG_ERROR(k_ELogAudio, "Failed to load music %s! SDL_mixer Error: %s", MUSIC_PATHS[i], Mix_GetError());
+            success = false;
+        }
+        else {
+            ULOG_INFO(k_ELogAudio, "Loaded %s, %u KB of PCM", MUSIC_PATHS[i], mMusic[i]->alen / 1024);
+        }
+    }
+
+    // Play the music from the hook, it stays set until free()
+    if (success && !mHooked) {
+        Mix_HookMusic(mixMusic, this);
+        mHooked = true;
     }
 
     // Load the soft step sound effect
+    loadStart = SDL_GetPerformanceCounter();
     mSoftStep = Mix_LoadWAV("assets/softstep.wav");
+    UFlightRecorder::recordAsset(k_EFlightChunk, "assets/softstep.wav", mSoftStep != nullptr, loadStart);
     if (mSoftStep == nullptr) {
-        // printf("Failed to load soft step sound! SDL_mixer Error: %s\n", Mix_GetError());
+        ULOG_ERROR(k_ELogAudio, "Failed to load soft step sound! SDL_mixer Error: %s", Mix_GetError());
         success = false;
     }
 
     // Load the click sfx
+    loadStart = SDL_GetPerformanceCounter();
     mClick = Mix_LoadWAV("assets/click.wav");
+    UFlightRecorder::recordAsset(k_EFlightChunk, "assets/click.wav", mClick != nullptr, loadStart);
     if (mClick == nullptr)
     {
-        // printf("Failed to load click sound! SDL_mixer Error: %s\n", Mix_GetError());
+        ULOG_ERROR(k_ELogAudio, "Failed to load click sound! SDL_mixer Error: %s", Mix_GetError());
         success = false;
     }
 
     // Load the clack sfx
+    loadStart = SDL_GetPerformanceCounter();
     mClack = Mix_LoadWAV("assets/clack.wav");
+    UFlightRecorder::recordAsset(k_EFlightChunk, "assets/clack.wav", mClack != nullptr, loadStart);
     if (mClack == nullptr)
     {
-        // printf("Failed to load clack sound! SDL_mixer Error: %s\n", Mix_GetError());
+        ULOG_ERROR(k_ELogAudio, "Failed to load clack sound! SDL_mixer Error: %s", Mix_GetError());
         success = false;
     }
 
@@ -65,45 +109,19 @@ bool USound::init() {
 // Play wheel music
 void USound::playWheelMusic() 
 {
-    // If there is music playing
-    if (Mix_PlayingMusic() != 0) {
-        // Stop the music
-        Mix_HaltMusic();
-    }
-
-    // Play the wheel music
-    Mix_PlayMusic(mWheelMusic, -1);
-
-    // If the music is currently muted
-    if (mMuteMusic) {
-        // Pause the music
-        Mix_PauseMusic();
-    }
+    requestMusic(MUSIC_WHEEL);
 }
 
 // Play menu music
 void USound::playMenuMusic()
 {
-    // If there is music playing
-    if (Mix_PlayingMusic() != 0) {
-        // Stop the music
-        Mix_HaltMusic();
-    }
-
-    // Play the menu music
-    Mix_PlayMusic(mMenuMusic, -1);
-
-    // If the music is currently muted
-    if (mMuteMusic) {
-        // Pause the music
-        Mix_PauseMusic();
-    }
+    requestMusic(MUSIC_MENU);
 }
 
-// Stop the music
+// Fade the music out
 void USound::stopMusic()
 {
-    Mix_HaltMusic();
+    requestMusic(MUSIC_NONE);
 }
 
 // Plays the soft step sfx
@@ -111,6 +129,7 @@ void USound::playSoftStep()
 {
     if (!mMuteSFX)
     {
+        UAudio::markSound();
         Mix_PlayChannel(-1, mSoftStep, 0);
     }
 }
@@ -120,6 +139,7 @@ void USound::playClick()
 {
     if (!mMuteSFX)
     {
+        UAudio::markSound();
         Mix_PlayChannel(-1, mClick, 0);
     }
 }
@@ -129,24 +149,15 @@ void USound::playClack()
 {
     if (!mMuteSFX)
     {
+        UAudio::markSound();
         Mix_PlayChannel(-1, mClack, 0);
     }
 }
 
-// Toggle the music
+// Toggle the music, the hook stops where it is and carries on from there when unmuted
 void USound::toggleMusicMute() {
-    // If the music is paused
-    if (Mix_PausedMusic() == 1) {
-        // Resume the music
-        Mix_ResumeMusic();
-    }
-    // If the music is playing
-    else {
-        // Pause the music
-        Mix_PauseMusic();
-    }
-
     mMuteMusic = !mMuteMusic;
+    mMusicPaused.store(mMuteMusic, std::memory_order_release);
 }
 
 // Mute the sound
@@ -155,21 +166,27 @@ void USound::toggleSFXMute()
     mMuteSFX = !mMuteSFX;
 }
 
+// Set the music hook again after UAudio reopened the mixer
+void USound::audioReopened()
+{
+    if (mHooked) {
+        Mix_HookMusic(mixMusic, this);
+    }
+}
+
 // Deallocate and destroy the sounds
 void USound::free(){
-    // Music is playing
-    if (Mix_PlayingMusic() != 0) {
-        // Stop the music
-        Mix_HaltMusic();
+    // Take the hook off, this waits for it to finish mixing
+    if (mHooked) {
+        Mix_HookMusic(nullptr, nullptr);
+        mHooked = false;
     }
 
-    // Free wheel music
-    Mix_FreeMusic(mWheelMusic);
-    mWheelMusic = nullptr;
-
-    // Free menu music
-    Mix_FreeMusic(mMenuMusic);
-    mMenuMusic = nullptr;
+    // Free the music
+    for (int i = 0; i < MUSIC_TRACK_COUNT; ++i) {
+        Mix_FreeChunk(mMusic[i]);
+        mMusic[i] = nullptr;
+    }
 
     // Free the soft step sound effect
     Mix_FreeChunk(mSoftStep);
@@ -182,4 +199,107 @@ void USound::free(){
     // Free the clack sound effect
     Mix_FreeChunk(mClack);
     mClack = nullptr;
+}
+
+// Ask the audio thread to crossfade to aTrack, restarting it if it's already playing
+void USound::requestMusic(MusicTrack aTrack)
+{
+    ++mRequestCount;
+    mMusicRequest.store((mRequestCount << 8) | static_cast<Uint32>(aTrack + 1), std::memory_order_release);
+}
+
+// Music hook, fills the stream with the music on the audio thread
+void USound::mixMusic(void *aUserData, Uint8 *aStream, int aLength)
+{
+    USound *sound = static_cast<USound *>(aUserData);
+
+    // Start a crossfade when the game thread asked for another track. The louder of the two
+    // voices fades out from where it is, the quieter one is cut, and the new track fades in
+    // from its first frame.
+    Uint32 request = sound->mMusicRequest.load(std::memory_order_acquire);
+    if (request != sound->mAppliedRequest) {
+        sound->mAppliedRequest = request;
+        float step = 1.f / SDL_max(1, MUSIC_CROSSFADE_MS * sound->mFrequency / 1000);
+
+        MusicVoice &current = sound->mVoices[0], &fading = sound->mVoices[1];
+        if (current.mTrack != MUSIC_NONE && (fading.mTrack == MUSIC_NONE || current.mGain >= fading.mGain)) {
+            fading = current;
+        }
+        fading.mGainStep = -step;
+        fading.mTargetGain = 0.f;
+
+        int track = static_cast<int>(request & 0xFF) - 1;
+        current.mTrack = (track >= 0 && track < MUSIC_TRACK_COUNT && sound->mMusic[track]) ? track : MUSIC_NONE;
+        current.mFrame = 0;
+        current.mGain = 0.f;
+        current.mGainStep = step;
+        current.mTargetGain = 1.f;
+    }
+
+    // The hook owns the stream, so muted or silent music still has to write silence
+    Sint16 *out = reinterpret_cast<Sint16 *>(aStream);
+    int samples = aLength / static_cast<int>(sizeof(Sint16));
+    if (sound->mMusicPaused.load(std::memory_order_acquire) ||
+        (sound->mVoices[0].mTrack == MUSIC_NONE && sound->mVoices[1].mTrack == MUSIC_NONE)) {
+        memset(aStream, 0, aLength);
+        return;
+    }
+
+    float mix[MUSIC_MIX_SAMPLES];
+    int blockFrames = MUSIC_MIX_SAMPLES / sound->mChannels;
+    while (samples > 0) {
+        int frames = SDL_min(blockFrames, samples / sound->mChannels);
+        if (frames <= 0) {
+            memset(out, 0, samples * sizeof(Sint16));
+            break;
+        }
+        int blockSamples = frames * sound->mChannels;
+
+        memset(mix, 0, blockSamples * sizeof(float));
+        for (int i = 0; i < 2; ++i) {
+            if (sound->mVoices[i].mTrack != MUSIC_NONE && !sound->mixVoice(sound->mVoices[i], mix, frames)) {
+                sound->mVoices[i].mTrack = MUSIC_NONE;
+            }
+        }
+
+        for (int i = 0; i < blockSamples; ++i) {
+            float sample = mix[i];
+            out[i] = static_cast<Sint16>(sample > 32767.f ? 32767.f : (sample < -32768.f ? -32768.f : sample));
+        }
+        out += blockSamples;
+        samples -= blockSamples;
+    }
+}
+
+// Mix one voice into aMix, returns false once it has faded out
+bool USound::mixVoice(MusicVoice &aVoice, float *aMix, int aFrames) const
+{
+    const Mix_Chunk *chunk = mMusic[aVoice.mTrack];
+    const Sint16 *pcm = reinterpret_cast<const Sint16 *>(chunk->abuf);
+    Uint32 trackFrames = chunk->alen / (sizeof(Sint16) * mChannels);
+    if (trackFrames == 0) {
+        return false;
+    }
+
+    for (int frame = 0; frame < aFrames; ++frame) {
+        // Ramp the gain a frame at a time, stopping on the target
+        if (aVoice.mGain != aVoice.mTargetGain) {
+            aVoice.mGain += aVoice.mGainStep;
+            if ((aVoice.mGainStep > 0.f) ? (aVoice.mGain >= aVoice.mTargetGain) : (aVoice.mGain <= aVoice.mTargetGain)) {
+                aVoice.mGain = aVoice.mTargetGain;
+            }
+        }
+
+        const Sint16 *in = pcm + aVoice.mFrame * mChannels;
+        for (int channel = 0; channel < mChannels; ++channel) {
+            aMix[frame * mChannels + channel] += in[channel] * aVoice.mGain;
+        }
+
+        // Loop back to the first frame without a gap
+        if (++aVoice.mFrame >= trackFrames) {
+            aVoice.mFrame = 0;
+        }
+    }
+
+    return aVoice.mTargetGain > 0.f || aVoice.mGain > 0.f;
 }
\ No newline at end of file
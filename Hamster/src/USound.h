@@ -8,8 +8,13 @@
 #pragma once
 #include <SDL.h>
 #include <SDL_mixer.h>
+#include <atomic>
 #include <cstdio>
 
+// Music is decoded to PCM when it's loaded and played by a music hook on the audio thread,
+// so changing tracks never touches the disk or waits on the mixer lock. The game thread only
+// posts which track it wants, the hook crossfades to it sample by sample and loops tracks
+// without a gap.
 class USound {
 public:
     // Initialize the USound member variables
@@ -24,7 +29,7 @@ public:
     // Play the menu music
     void playMenuMusic();
 
-    // Stop the music
+    // Fade the music out
     void stopMusic();
 
     // Play the soft step sfx
@@ -54,13 +59,58 @@ public:
         return mMuteMusic;
     }
 
+    // Set the music hook again after UAudio reopened the mixer
+    void audioReopened();
+
     // Deallocate and destroy the sounds
     void free();
 private:
-    // The music, and sound assets used
-    Mix_Music *mWheelMusic, *mMenuMusic;
+    // The music tracks
+    enum MusicTrack
+    {
+        MUSIC_NONE = -1,
+        MUSIC_WHEEL,
+        MUSIC_MENU,
+        MUSIC_TRACK_COUNT
+    };
+
+    // A track playing on the audio thread, its gain ramps by mGainStep a frame until mTargetGain.
+    // mTrack is MUSIC_NONE when the voice is silent.
+    struct MusicVoice
+    {
+        int mTrack;
+        Uint32 mFrame;
+        float mGain, mGainStep, mTargetGain;
+    };
+
+    // Ask the audio thread to crossfade to aTrack, restarting it if it's already playing
+    void requestMusic(MusicTrack aTrack);
+
+    // Music hook, fills the stream with the music on the audio thread
+    static void mixMusic(void *aUserData, Uint8 *aStream, int aLength);
+
+    // Mix one voice into aMix, returns false once it has faded out
+    bool mixVoice(MusicVoice &aVoice, float *aMix, int aFrames) const;
+
+    // The music, decoded to the mixer's format, and the sound assets used
+    Mix_Chunk *mMusic[MUSIC_TRACK_COUNT];
     Mix_Chunk *mSoftStep, *mClick, *mClack;
 
     // If the music or sound effects are muted
     bool mMuteSFX, mMuteMusic;
+
+    // Posted by the game thread, the request count above the track + 1
+    std::atomic<Uint32> mMusicRequest;
+    std::atomic<bool> mMusicPaused;
+    Uint32 mRequestCount;
+
+    // Only touched by the audio thread once the hook is set. mVoices[0] is the track asked
+    // for, mVoices[1] the one fading out under it.
+    Uint32 mAppliedRequest;
+    MusicVoice mVoices[2];
+
+    // Mixer output format
+    int mChannels;
+    int mFrequency;
+    bool mHooked;
 };
\ No newline at end of file
@@ -0,0 +1,227 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UStartupProfiler.cpp
+*/
+#include "UStartupProfiler.h"
+#include "ULog.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Default asset load time that gets flagged, can be overridden with HAMSTER_ASSET_WARN_MS
+#define STARTUP_ASSET_WARN_MS 50.0
+
+namespace
+{
+    // A timed startup step or asset load
+    struct StartupStep
+    {
+        std::string mName;
+        Uint64 mStart;
+        Uint64 mEnd;
+        int mDepth;
+        bool mAsset;
+    };
+
+    std::vector<StartupStep> gSteps;
+    std::vector<size_t> gOpen;
+    bool gFinished = false;
+    bool gThresholdSet = false;
+    double gAssetThresholdMs = STARTUP_ASSET_WARN_MS;
+    SDL_threadID gMainThread = 0;
+    Uint64 gOrigin = 0;
+
+    // Only the thread that started profiling is recorded
+    bool recording()
+    {
+        return !gFinished && !gSteps.empty() && SDL_ThreadID() == gMainThread;
+    }
+
+    double toMs(Uint64 aTicks)
+    {
+        return static_cast<double>(aTicks) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+    }
+
+    Uint64 toUs(Uint64 aTicks)
+    {
+        return (aTicks * 1000000) / SDL_GetPerformanceFrequency();
+    }
+
+    // Escape a string for a JSON string literal
+    std::string jsonEscape(const std::string &aText)
+    {
+        std::string out;
+        for (char c : aText)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                out += c;
+        }
+        return out;
+    }
+
+    // Append formatted text to a string
+    template<typename... Args>
+    void appendf(std::string &aOut, const char *aFormat, Args... args)
+    {
+        char line[512];
+        int len = snprintf(line, sizeof(line), aFormat, args...);
+        if (len > 0)
+            aOut.append(line, SDL_min(static_cast<size_t>(len), sizeof(line) - 1));
+    }
+
+    // Write a whole file
+    bool writeFile(const std::string &aPath, const std::string &aText)
+    {
+        SDL_RWops *file = SDL_RWFromFile(aPath.c_str(), "wb");
+        if (file == nullptr)
+        {
+            ULOG_ERROR(k_ELogGame, "Unable to write %s! SDL Error: %s", aPath, SDL_GetError());
+            return false;
+        }
+
+        bool success = SDL_RWwrite(file, aText.data(), 1, aText.size()) == aText.size();
+        SDL_RWclose(file);
+        return success;
+    }
+}
+
+// Start timing a step, steps started before this one ends become its children
+void UStartupProfiler::begin(const char *aName)
+{
+    if (gFinished)
+        return;
+
+    if (gSteps.empty())
+    {
+        gMainThread = SDL_ThreadID();
+        gOrigin = SDL_GetPerformanceCounter();
+    }
+    else if (SDL_ThreadID() != gMainThread)
+    {
+        return;
+    }
+
+    StartupStep step;
+    step.mName = aName;
+    step.mStart = SDL_GetPerformanceCounter();
+    step.mEnd = step.mStart;
+    step.mDepth = static_cast<int>(gOpen.size());
+    step.mAsset = false;
+
+    gOpen.push_back(gSteps.size());
+    gSteps.push_back(step);
+}
+
+// Stop timing the most recently started step
+void UStartupProfiler::end()
+{
+    if (!recording() || gOpen.empty())
+        return;
+
+    gSteps[gOpen.back()].mEnd = SDL_GetPerformanceCounter();
+    gOpen.pop_back();
+}
+
+// Add an asset load, called from the asset loaders while startup is being profiled
+void UStartupProfiler::recordAsset(const std::string &aPath, Uint64 aStartTicks, Uint64 aEndTicks)
+{
+    if (!recording())
+        return;
+
+    StartupStep step;
+    step.mName = aPath;
+    step.mStart = aStartTicks;
+    step.mEnd = aEndTicks;
+    step.mDepth = static_cast<int>(gOpen.size());
+    step.mAsset = true;
+    gSteps.push_back(step);
+}
+
+// Assets that take longer than this are flagged in the report and the log
+void UStartupProfiler::setAssetThreshold(double aMs)
+{
+    gAssetThresholdMs = aMs;
+    gThresholdSet = true;
+}
+
+// True until finish() is called
+bool UStartupProfiler::active()
+{
+    return !gFinished;
+}
+
+// Stop profiling, then write the startup report and the trace
+bool UStartupProfiler::finish(const std::string &aReportPath, const std::string &aTracePath)
+{
+    if (gFinished)
+        return false;
+    gFinished = true;
+
+    if (gSteps.empty())
+        return false;
+
+    // Close any step that is still open so the totals make sense
+    Uint64 now = SDL_GetPerformanceCounter();
+    while (!gOpen.empty())
+    {
+        gSteps[gOpen.back()].mEnd = now;
+        gOpen.pop_back();
+    }
+
+    if (!gThresholdSet)
+    {
+        const char *threshold = SDL_getenv("HAMSTER_ASSET_WARN_MS");
+        if (threshold)
+            gAssetThresholdMs = atof(threshold);
+    }
+
+    // Text report, one line per step indented by nesting depth
+    std::string report;
+    appendf(report, "Hamster startup report\n");
+    appendf(report, "Total: %.3f ms\n\n", toMs(now - gOrigin));
+    appendf(report, "%12s %12s  %s\n", "start ms", "duration ms", "step");
+
+    int slowAssets = 0;
+    for (const StartupStep &step : gSteps)
+    {
+        double duration = toMs(step.mEnd - step.mStart);
+        bool slow = step.mAsset && duration > gAssetThresholdMs;
+        appendf(report, "%12.3f %12.3f  %*s%s%s\n", toMs(step.mStart - gOrigin), duration, step.mDepth * 2, "", step.mName.c_str(), slow ? "  <-- SLOW" : "");
+
+        if (slow)
+        {
+            ++slowAssets;
+            ULOG_WARN(k_ELogGame, "Slow asset load: %s took %.3f ms (threshold %.1f ms)", step.mName, duration, gAssetThresholdMs);
+        }
+    }
+    appendf(report, "\n%d asset(s) over %.1f ms\n", slowAssets, gAssetThresholdMs);
+
+    // Chrome trace, every step is a complete event on the startup track
+    std::string trace;
+    appendf(trace, "{\"traceEvents\":[\n");
+    appendf(trace, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Hamster\"}},\n");
+    appendf(trace, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Startup\"}}");
+    for (const StartupStep &step : gSteps)
+    {
+        trace += ",\n{\"name\":\"" + jsonEscape(step.mName) + "\"";
+        appendf(trace, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%llu,\"dur\":%llu}",
+            step.mAsset ? "asset" : "startup",
+            static_cast<unsigned long long>(toUs(step.mStart - gOrigin)),
+            static_cast<unsigned long long>(toUs(step.mEnd - step.mStart)));
+    }
+    appendf(trace, "\n]}\n");
+
+    ULOG_INFO(k_ELogGame, "Startup took %.3f ms, report written to %s", toMs(now - gOrigin), aReportPath);
+
+    bool success = writeFile(aReportPath, report);
+    success = writeFile(aTracePath, trace) && success;
+
+    gSteps.clear();
+    gSteps.shrink_to_fit();
+    return success;
+}
\ No newline at end of file
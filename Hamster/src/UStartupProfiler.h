@@ -0,0 +1,47 @@
+/**
+* Copyright 2021 Tonia Sanzo 
+* Title: Hamster
+* Author: Tonia Sanzo
+* Date: 10/19/2026
+* File: Hamster UStartupProfiler.h
+*/
+#pragma once
+#include <SDL.h>
+#include <string>
+
+// Times each step of a cold start with the performance counter. Steps may nest, asset
+// loads are added as they happen. Once startup is finished the steps are written as a
+// text report and as the "Startup" track of a Chrome trace (chrome://tracing, Perfetto).
+class UStartupProfiler
+{
+public:
+    // Start timing a step, steps started before this one ends become its children
+    static void begin(const char *aName);
+
+    // Stop timing the most recently started step
+    static void end();
+
+    // Add an asset load, called from the asset loaders while startup is being profiled
+    static void recordAsset(const std::string &aPath, Uint64 aStartTicks, Uint64 aEndTicks);
+
+    // Assets that take longer than this are flagged in the report and the log
+    static void setAssetThreshold(double aMs);
+
+    // Stop profiling, then write the startup report and the trace
+    static bool finish(const std::string &aReportPath, const std::string &aTracePath);
+
+    // True until finish() is called
+    static bool active();
+};
+
+// Times the enclosing scope as a startup step
+class UStartupScope
+{
+public:
+    explicit UStartupScope(const char *aName) { UStartupProfiler::begin(aName); }
+    ~UStartupScope() { UStartupProfiler::end(); }
+
+private:
+    UStartupScope(const UStartupScope &) = delete;
+    UStartupScope &operator=(const UStartupScope &) = delete;
+};
\ No newline at end of file
@@ -7,6 +7,10 @@
 */
 #include "UTexture.h"
 
+// Renderer statistics
+Uint32 UTexture::sRenderCount = 0;
+Uint32 UTexture::sTextureCount = 0;
+
 
 
 
@@ -49,7 +53,7 @@ bool UTexture::loadFromFile(std::string path) {
 
     // Exit prematuraly if UTexture has not been properly initialized
     if (!mRenderer) {
-        // printf("Attempted to render a texture without initializing a renderer!\n");
+        ULOG_ERROR(k_ELogRender, "Attempted to render a texture without initializing a renderer!");
         return false;
     }
 
@@ -57,9 +61,10 @@ bool UTexture::loadFromFile(std::string path) {
     SDL_Texture *newTexture = NULL;
 
     // Load image at specified path
+    Uint64 loadStart = SDL_GetPerformanceCounter();
     SDL_Surface *loadedSurface = IMG_Load(path.c_str());
     if (!loadedSurface) {
-        // printf("unable to load image %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
+        ULOG_ERROR(k_ELogRender, "unable to load image %s! SDL_image Error: %s", path.c_str(), IMG_GetError());
     }
     else {
         // Color key image
@@ -68,9 +73,11 @@ bool UTexture::loadFromFile(std::string path) {
         // Create texture from surface pixels
         newTexture = SDL_CreateTextureFromSurface(mRenderer, loadedSurface);
         if (!newTexture) {
-            // printf("Unable to create texture from %s! SDL Error: %s\n:", path.c_str(), SDL_GetError());
+            ULOG_ERROR(k_ELogRender, "Unable to create texture from %s! SDL Error: %s", path.c_str(), SDL_GetError());
         }
         else {
+            ++sTextureCount;
+
             // Get image dimensions
             mWidth = loadedSurface->w;
             mHeight = loadedSurface->h;
@@ -82,6 +89,7 @@ bool UTexture::loadFromFile(std::string path) {
 
     // Return success
     mTexture = newTexture;
+    UFlightRecorder::recordAsset(k_EFlightTexture, path, mTexture != NULL, loadStart);
     return mTexture != NULL;
 }
 
@@ -95,26 +103,28 @@ bool UTexture::loadFromRenderedText(std::string textureText, SDL_Color textColor
 
     // Exit prematuraly if UTexture has not been properly initialized
     if (!mFont) {
-        // printf("Attempted to render a text texture without initializing a font!\n");
+        ULOG_ERROR(k_ELogRender, "Attempted to render a text texture without initializing a font!");
         return false;
     }
     if (!mRenderer) {
-        // printf("Attempted to render a texture without initializing a renderer!\n");
+        ULOG_ERROR(k_ELogRender, "Attempted to render a texture without initializing a renderer!");
         return false;
     }
 
     // Render text surface
     SDL_Surface *textSurface = TTF_RenderText_Blended(mFont, textureText.c_str(), textColor);
     if (textSurface == NULL) {
-        // printf("Unable to render text surface!  SDL_ttfError: %s\n", TTF_GetError());
+        ULOG_ERROR(k_ELogRender, "Unable to render text surface!  SDL_ttfError: %s", TTF_GetError());
     }
     else {
         // Create texture from surface pixels
         mTexture = SDL_CreateTextureFromSurface(mRenderer, textSurface);
         if (mTexture == NULL) {
-            // printf("Unable to create texture from rendered text! SDL_Error: %s\n", SDL_GetError());
+            ULOG_ERROR(k_ELogRender, "Unable to create texture from rendered text! SDL_Error: %s", SDL_GetError());
         }
         else {
+            ++sTextureCount;
+
             // Get image dimensions
             mWidth = textSurface->w;
             mHeight = textSurface->h;
@@ -186,6 +196,7 @@ void UTexture::render(int x, int y, SDL_Rect *clip, double angle, SDL_Point *cen
     }
 
     // Render to screen
+    ++sRenderCount;
     SDL_RenderCopyEx(mRenderer, mTexture, clip, &renderQuad, angle, center, flip);
 }
 
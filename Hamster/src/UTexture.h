@@ -54,6 +54,10 @@ public:
 
     // Set image scale
     void updateScale(double sc);
+
+    // Renderer statistics since startup, read by the benchmark mode
+    static Uint32 sRenderCount;
+    static Uint32 sTextureCount;
 private:
     // The actual hardware texture, and the games renderer
     SDL_Texture *mTexture;
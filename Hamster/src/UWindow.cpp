@@ -17,6 +17,7 @@ UWindow::UWindow()
     mIcon = nullptr;
     mWindow = nullptr;
     mRenderer = nullptr;
+    mRendererFlags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
     mMouseFocus = mKeyboardFocus = mFullscreen = mMinimized = false;
 }
 
@@ -41,7 +42,7 @@ bool UWindow::init(std::string title, float aW, float aH, std::string path = "")
     }
     else
     {
-        // printf("Failed to create the SDL window!\n");
+        ULOG_ERROR(k_ELogRender, "Failed to create the SDL window!");
         success = false;
     }
 
@@ -52,7 +53,7 @@ bool UWindow::init(std::string title, float aW, float aH, std::string path = "")
         mIcon = IMG_Load(path.c_str());
         if (!mIcon)
         {
-            // printf("Unable to load image \"%s\"! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
+            ULOG_ERROR(k_ELogRender, "Unable to load image \"%s\"! SDL_image Error: %s", path.c_str(), IMG_GetError());
             success = false;
         }
         else
@@ -70,7 +71,7 @@ bool UWindow::init(std::string title, float aW, float aH, std::string path = "")
 
 // Creates a pointer to renderer associated with this window object
 SDL_Renderer *UWindow::createRenderer() {
-    return SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    return SDL_CreateRenderer(mWindow, -1, mRendererFlags);
 }
 
 
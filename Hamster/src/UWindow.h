@@ -23,6 +23,9 @@ public:
     // Creates renderer from internal window
     SDL_Renderer *createRenderer();
 
+    // Flags used when the renderer is created, must be set before init
+    void setRendererFlags(Uint32 aFlags) { mRendererFlags = aFlags; }
+
     // Handles window events
     bool handleEvent(SDL_Event &);
 
@@ -45,6 +48,7 @@ private:
     SDL_Window *mWindow;
     SDL_Renderer *mRenderer;
     SDL_Surface *mIcon;
+    Uint32 mRendererFlags;
 
     // Window focus
     bool mMouseFocus;